@@ -7,6 +7,8 @@
 QT       -= gui
 QT       += network
 
+CONFIG   += c++11
+
 TARGET = EthRPC
 TEMPLATE = lib
 
@@ -16,7 +18,20 @@ SOURCES += \
     ethobject.cpp \
     ethrpc.cpp \
     ethlocalclient.cpp \
-    jsoncoder.cpp
+    ethhttpclient.cpp \
+    jsoncoder.cpp \
+    hexcodec.cpp \
+    ethblockfetcher.cpp \
+    ethrpccache.cpp \
+    ethheadercache.cpp \
+    ethblockstore.cpp \
+    keccak.cpp \
+    ethbloom.cpp \
+    rlp.cpp \
+    ethabi.cpp \
+    ethwebsocketclient.cpp \
+    ethfiltermanager.cpp \
+    ethbalancedclient.cpp
 
 HEADERS +=\
     ethobject.h \
@@ -24,8 +39,30 @@ HEADERS +=\
     ethrpc_global.h \
     ethrpc.h \
     ethrpc_utils.h \
+    uint256.h \
     ethlocalclient.h \
-    jsoncoder.h
+    ethhttpclient.h \
+    jsoncoder.h \
+    hexcodec.h \
+    ethblockfetcher.h \
+    ethrpccache.h \
+    ethheadercache.h \
+    ethblockstore.h \
+    keccak.h \
+    ethbloom.h \
+    rlp.h \
+    ethabi.h \
+    ethwebsocketclient.h \
+    ethfiltermanager.h \
+    ethbalancedclient.h
+
+#Local transaction signer, needs libsecp256k1 built with the recovery module: qmake CONFIG+=ethrpc_signer
+ethrpc_signer {
+    DEFINES += ETHRPC_SIGNER
+    SOURCES += ethsigner.cpp
+    HEADERS += ethsigner.h
+    LIBS += -lsecp256k1
+}
 
 unix {
     target.path = /usr/lib
@@ -0,0 +1,36 @@
+#include "ethabi.h"
+#include "keccak.h"
+
+void ethAbiWriteWord(uint64_t value, uchar *word)
+{
+    memset(word, 0, EthAbiWordSize - 8);
+    for(int i = EthAbiWordSize - 1; i >= EthAbiWordSize - 8; i--)
+    {
+        word[i] = uchar(value & 0xFF);
+        value >>= 8;
+    }
+}
+
+bool ethAbiReadWord(const uchar *word, int maximum, int &value)
+{
+    if(maximum < 0)
+        return false;
+    //The value must fit in an int, the high Bytes are zero
+    for(int i = 0; i < EthAbiWordSize - 4; i++)
+    {
+        if(word[i])
+            return false;
+    }
+    uint32_t result = (uint32_t(word[28]) << 24) | (uint32_t(word[29]) << 16) | (uint32_t(word[30]) << 8) | word[31];
+    if(result > uint32_t(maximum))
+        return false;
+    value = int(result);
+    return true;
+}
+
+QByteArray ethAbiSelector(const QByteArray &signature)
+{
+    unsigned char hash[Keccak256::HashSize];
+    Keccak256::hash(signature.constData(), signature.size(), hash);
+    return QByteArray(reinterpret_cast<const char*>(hash), EthAbiSelectorSize);
+}
@@ -0,0 +1,337 @@
+#ifndef ETHABI_H
+#define ETHABI_H
+
+#include <QByteArray>
+#include <QString>
+#include <QVector>
+#include <string.h>
+#include "ethrpc_global.h"
+#include "ethobject.h"
+#include "uint256.h"
+
+/*
+ * Contract ABI encoding of the data of eth_call and eth_sendTransaction.
+ * The types of the parameters are given by the template arguments:
+ *     UInt256 -> uint256, bool -> bool, EAddress20 -> address, EHash32 -> bytes32,
+ *     QByteArray and EthAbiView -> bytes, QString -> string, QVector<T> -> T[] for the static types T.
+ * Every parameter takes one word of 32 Bytes in the head, the dynamic types hold there the offset of their tail.
+ */
+
+enum
+{
+    EthAbiWordSize = 32,
+    EthAbiSelectorSize = 4
+};
+
+//Write an unsigned integer as a big endian word
+ETHRPCSHARED_EXPORT void ethAbiWriteWord(uint64_t value, uchar* word);
+//Read an offset or a length, false when it does not fit in the data
+ETHRPCSHARED_EXPORT bool ethAbiReadWord(const uchar* word, int maximum, int& value);
+//First 4 Bytes of the Keccak-256 hash of the signature
+ETHRPCSHARED_EXPORT QByteArray ethAbiSelector(const QByteArray& signature);
+
+//Bytes or string of decoded data, without copy. The decoded data must stay alive while the view is used
+struct EthAbiView
+{
+    EthAbiView(): data(0), size(0) {}
+    EthAbiView(const char* viewData, int viewSize): data(viewData), size(viewSize) {}
+    QByteArray toByteArray() const { return QByteArray(data, size); }
+    QString toString() const { return QString::fromUtf8(data, size); }
+
+    const char* data;
+    int size;
+};
+
+//Encoding of one type, not defined for the unsupported types
+template<typename T>
+struct EthAbiType;
+
+template<>
+struct EthAbiType<UInt256>
+{
+    enum { Dynamic = false };
+    static const char* name() { return "uint256"; }
+    static void encode(const UInt256& value, QByteArray& out, int head, int)
+    {
+        value.toBigEndian(reinterpret_cast<uchar*>(out.data()) + head);
+    }
+    static bool decode(const uchar* data, int, int head, UInt256& value)
+    {
+        value.fromBigEndian(data + head);
+        return true;
+    }
+};
+
+template<>
+struct EthAbiType<bool>
+{
+    enum { Dynamic = false };
+    static const char* name() { return "bool"; }
+    static void encode(bool value, QByteArray& out, int head, int)
+    {
+        ethAbiWriteWord(value ? 1 : 0, reinterpret_cast<uchar*>(out.data()) + head);
+    }
+    static bool decode(const uchar* data, int, int head, bool& value)
+    {
+        int word = 0;
+        if(!ethAbiReadWord(data + head, 1, word))
+            return false;
+        value = word != 0;
+        return true;
+    }
+};
+
+template<int N>
+struct EthAbiFixedType
+{
+    enum { Dynamic = false };
+    //Addresses are aligned to the right and the bytesN to the left of the word
+    enum { Padding = N == 20 ? EthAbiWordSize - N : 0 };
+    static void encode(const EFixedByteArray<N>& value, QByteArray& out, int head, int)
+    {
+        uchar* word = reinterpret_cast<uchar*>(out.data()) + head;
+        memset(word, 0, EthAbiWordSize);
+        if(!value.isNull())
+            memcpy(word + Padding, value.data(), N);
+    }
+    static bool decode(const uchar* data, int, int head, EFixedByteArray<N>& value)
+    {
+        const uchar* word = data + head;
+        for(int i = 0; i < EthAbiWordSize - N; i++)
+        {
+            if(word[i < Padding ? i : N + i])
+                return false;
+        }
+        value = EFixedByteArray<N>(QByteArray::fromRawData(reinterpret_cast<const char*>(word + Padding), N));
+        return true;
+    }
+};
+
+template<>
+struct EthAbiType<EAddress20> : EthAbiFixedType<20>
+{
+    static const char* name() { return "address"; }
+};
+
+template<>
+struct EthAbiType<EHash32> : EthAbiFixedType<32>
+{
+    static const char* name() { return "bytes32"; }
+};
+
+//Tail of bytes and string: the length then the data padded to a word
+struct EthAbiBytesType
+{
+    enum { Dynamic = true };
+    static const char* name() { return "bytes"; }
+    static void encode(const char* value, int size, QByteArray& out, int head, int block)
+    {
+        int tail = out.size();
+        int padded = (size + EthAbiWordSize - 1) / EthAbiWordSize * EthAbiWordSize;
+        out.resize(tail + EthAbiWordSize + padded);
+        uchar* data = reinterpret_cast<uchar*>(out.data());
+        ethAbiWriteWord(uint64_t(tail - block), data + head);
+        ethAbiWriteWord(uint64_t(size), data + tail);
+        memcpy(data + tail + EthAbiWordSize, value, size);
+        memset(data + tail + EthAbiWordSize + size, 0, padded - size);
+    }
+    static bool decode(const uchar* data, int size, int head, EthAbiView& value)
+    {
+        int tail = 0;
+        int length = 0;
+        if(!ethAbiReadWord(data + head, size - EthAbiWordSize, tail) ||
+                !ethAbiReadWord(data + tail, size - tail - EthAbiWordSize, length))
+            return false;
+        value = EthAbiView(reinterpret_cast<const char*>(data + tail + EthAbiWordSize), length);
+        return true;
+    }
+};
+
+template<>
+struct EthAbiType<EthAbiView> : EthAbiBytesType
+{
+    static void encode(const EthAbiView& value, QByteArray& out, int head, int block)
+    {
+        EthAbiBytesType::encode(value.data, value.size, out, head, block);
+    }
+    using EthAbiBytesType::decode;
+};
+
+template<>
+struct EthAbiType<QByteArray> : EthAbiBytesType
+{
+    static void encode(const QByteArray& value, QByteArray& out, int head, int block)
+    {
+        EthAbiBytesType::encode(value.constData(), value.size(), out, head, block);
+    }
+    static bool decode(const uchar* data, int size, int head, QByteArray& value)
+    {
+        EthAbiView view;
+        if(!EthAbiBytesType::decode(data, size, head, view))
+            return false;
+        value = view.toByteArray();
+        return true;
+    }
+};
+
+template<>
+struct EthAbiType<QString> : EthAbiBytesType
+{
+    static const char* name() { return "string"; }
+    static void encode(const QString& value, QByteArray& out, int head, int block)
+    {
+        QByteArray utf8 = value.toUtf8();
+        EthAbiBytesType::encode(utf8.constData(), utf8.size(), out, head, block);
+    }
+    static bool decode(const uchar* data, int size, int head, QString& value)
+    {
+        EthAbiView view;
+        if(!EthAbiBytesType::decode(data, size, head, view))
+            return false;
+        value = view.toString();
+        return true;
+    }
+};
+
+//Tail of the arrays: the length then the heads of the elements
+template<typename T>
+struct EthAbiType<QVector<T> >
+{
+    static_assert(!EthAbiType<T>::Dynamic, "Only the arrays of static types are supported");
+    enum { Dynamic = true };
+    static QByteArray name() { return QByteArray(EthAbiType<T>::name()) + "[]"; }
+    static void encode(const QVector<T>& value, QByteArray& out, int head, int block)
+    {
+        int tail = out.size();
+        out.resize(tail + EthAbiWordSize * (1 + value.count()));
+        uchar* data = reinterpret_cast<uchar*>(out.data());
+        ethAbiWriteWord(uint64_t(tail - block), data + head);
+        ethAbiWriteWord(uint64_t(value.count()), data + tail);
+        int elements = tail + EthAbiWordSize;
+        for(int i = 0; i < value.count(); i++)
+            EthAbiType<T>::encode(value[i], out, elements + i * EthAbiWordSize, elements);
+    }
+    static bool decode(const uchar* data, int size, int head, QVector<T>& value)
+    {
+        int tail = 0;
+        int count = 0;
+        if(!ethAbiReadWord(data + head, size - EthAbiWordSize, tail) ||
+                !ethAbiReadWord(data + tail, (size - tail - EthAbiWordSize) / EthAbiWordSize, count))
+            return false;
+        value.resize(count);
+        int elements = tail + EthAbiWordSize;
+        for(int i = 0; i < count; i++)
+        {
+            if(!EthAbiType<T>::decode(data + elements, size - elements, i * EthAbiWordSize, value[i]))
+                return false;
+        }
+        return true;
+    }
+};
+
+//Encoding of a list of parameters, every parameter take one word in the head
+template<typename... Args>
+struct EthAbiTuple;
+
+template<>
+struct EthAbiTuple<>
+{
+    static void signature(QByteArray&) {}
+    static void encode(QByteArray&, int, int) {}
+    static bool decode(const uchar*, int, int) { return true; }
+};
+
+template<typename T, typename... Rest>
+struct EthAbiTuple<T, Rest...>
+{
+    static void signature(QByteArray& out)
+    {
+        out.append(EthAbiType<T>::name());
+        if(sizeof...(Rest))
+            out.append(',');
+        EthAbiTuple<Rest...>::signature(out);
+    }
+    static void encode(QByteArray& out, int head, int block, const T& value, const Rest&... rest)
+    {
+        EthAbiType<T>::encode(value, out, head, block);
+        EthAbiTuple<Rest...>::encode(out, head + EthAbiWordSize, block, rest...);
+    }
+    static bool decode(const uchar* data, int size, int head, T& value, Rest&... rest)
+    {
+        return EthAbiType<T>::decode(data, size, head, value) &&
+                EthAbiTuple<Rest...>::decode(data, size, head + EthAbiWordSize, rest...);
+    }
+};
+
+/**
+ * @brief The EthAbiFunction class describe a contract function by the types of its parameters.
+ * The signature and the selector are computed once by the constructor, declare the functions static
+ * or use ETH_ABI_FUNCTION.
+ */
+template<typename... Args>
+class EthAbiFunction
+{
+public:
+    //Size of the head, known at compile time
+    enum { HeadSize = EthAbiWordSize * int(sizeof...(Args)) };
+
+    /**
+     * @brief EthAbiFunction Constructor
+     * @param name Name of the function, the signature is built from the types of the parameters.
+     */
+    explicit EthAbiFunction(const char* name):
+        m_signature(name)
+    {
+        m_signature.append('(');
+        EthAbiTuple<Args...>::signature(m_signature);
+        m_signature.append(')');
+        m_selector = ethAbiSelector(m_signature);
+    }
+
+    //Signature like transfer(address,uint256)
+    const QByteArray& signature() const { return m_signature; }
+    //First 4 Bytes of the hash of the signature
+    const QByteArray& selector() const { return m_selector; }
+
+    /**
+     * @brief encode Encode a call, the result is the data of the transaction.
+     */
+    QByteArray encode(const Args&... args) const
+    {
+        QByteArray out;
+        out.reserve(EthAbiSelectorSize + HeadSize + EthAbiWordSize * 2);
+        out.resize(EthAbiSelectorSize + HeadSize);
+        memcpy(out.data(), m_selector.constData(), EthAbiSelectorSize);
+        EthAbiTuple<Args...>::encode(out, EthAbiSelectorSize, EthAbiSelectorSize, args...);
+        return out;
+    }
+
+private:
+    QByteArray m_signature;
+    QByteArray m_selector;
+};
+
+//Static function descriptor, created at the first use of the call site
+#define ETH_ABI_FUNCTION(Name, ...) \
+    ([]() -> const EthAbiFunction<__VA_ARGS__>& { static const EthAbiFunction<__VA_ARGS__> function(Name); return function; }())
+
+/**
+ * @brief ethAbiDecode Decode the result of eth_call or the data of a log.
+ * EthAbiView values point into the data, the other types are copied.
+ * @return false when the data is too short or malformed.
+ */
+template<typename... Rets>
+bool ethAbiDecode(const char* data, int size, Rets&... values)
+{
+    if(size < EthAbiWordSize * int(sizeof...(Rets)))
+        return false;
+    return EthAbiTuple<Rets...>::decode(reinterpret_cast<const uchar*>(data), size, 0, values...);
+}
+
+template<typename... Rets>
+bool ethAbiDecode(const QByteArray& data, Rets&... values)
+{
+    return ethAbiDecode(data.constData(), data.size(), values...);
+}
+
+#endif // ETHABI_H
@@ -0,0 +1,561 @@
+#include "ethbalancedclient.h"
+#include "jsoncoder.h"
+#include "ethobject.h"
+#include <QAbstractSocket>
+#include <algorithm>
+#include <cmath>
+
+namespace EthBalancedClient_NS
+{
+    const int PROBE_MSECS = 2000;
+    const int MAX_LAG = 2;
+    const double SMOOTHING = 0.2;
+    const double HEDGE_PERCENTILE = 0.95;
+    const double HEDGE_BUDGET = 0.05;
+    //Maximum hedges that can be saved during the quiet periods
+    const double HEDGE_BURST = 10;
+    const int LATENCY_SAMPLES = 256;
+    const int MIN_LATENCY_SAMPLES = 32;
+    const int DELAY_UPDATE_SAMPLES = 16;
+    //Slices of the blocking waits, short when the two backends of a hedge are waited in turn
+    const int WAIT_MSECS = 100;
+    const int HEDGE_WAIT_MSECS = 1;
+    //The filters and the subscriptions exist only in the node that created them
+    const char* const STATEFUL_METHODS[] = {
+        "\"eth_newFilter\"",
+        "\"eth_newBlockFilter\"",
+        "\"eth_newPendingTransactionFilter\"",
+        "\"eth_getFilterChanges\"",
+        "\"eth_getFilterLogs\"",
+        "\"eth_uninstallFilter\"",
+        "\"eth_subscribe\"",
+        "\"eth_unsubscribe\""
+    };
+}
+using namespace EthBalancedClient_NS;
+
+static bool isStateful(const QByteArray& request)
+{
+    for(size_t i = 0; i < sizeof(STATEFUL_METHODS) / sizeof(STATEFUL_METHODS[0]); i++)
+    {
+        if(request.contains(STATEFUL_METHODS[i]))
+            return true;
+    }
+    return false;
+}
+
+EthBalancedClient::EthBalancedClient(const QList<IEthClient *> &backends, QObject *parent) : QObject(parent),
+    m_pinned(-1),
+    m_next(0),
+    m_code(QAbstractSocket::UnknownSocketError),
+    m_latencies(LATENCY_SAMPLES),
+    m_latencyIndex(0),
+    m_latencyCount(0),
+    m_hedgeDelay(-1),
+    m_newLatencies(0),
+    m_hedgeTokens(0),
+    m_hedges(0)
+{
+    m_parameters["probeInterval"] = PROBE_MSECS;
+    m_parameters["maxLag"] = MAX_LAG;
+    m_parameters["smoothing"] = SMOOTHING;
+    m_parameters["hedgePercentile"] = HEDGE_PERCENTILE;
+    m_parameters["hedgeBudget"] = HEDGE_BUDGET;
+
+    for(int i = 0; i < backends.size(); i++)
+    {
+        Backend backend;
+        backend.client = backends[i];
+        backend.connected = false;
+        backend.healthy = false;
+        backend.latency = 0;
+        backend.inFlight = 0;
+        backend.head = -1;
+        backend.syncing = false;
+        backend.probing = false;
+        backend.failed = false;
+        m_backends.append(backend);
+    }
+    connect(&m_probeTimer, SIGNAL(timeout()), this, SLOT(probe()));
+}
+
+EthBalancedClient::~EthBalancedClient()
+{
+    //The requests in flight are failed while the backends are still alive
+    disconnectToServer();
+    for(int i = 0; i < m_backends.size(); i++)
+        delete m_backends[i].client;
+}
+
+QVariantMap &EthBalancedClient::clientParameters()
+{
+    return m_parameters;
+}
+
+bool EthBalancedClient::connectToServer()
+{
+    bool ret = false;
+    m_pinned = -1;
+    for(int i = 0; i < m_backends.size(); i++)
+    {
+        Backend& backend = m_backends[i];
+        backend.connected = backend.client->connectToServer();
+        backend.healthy = backend.connected;
+        backend.failed = !backend.connected;
+        backend.head = -1;
+        backend.syncing = false;
+        backend.probing = false;
+        if(backend.connected)
+        {
+            ret = true;
+        }
+        else
+        {
+            m_code = backend.client->errorNumber();
+            m_error = backend.client->errorString();
+        }
+    }
+
+    //The nodes that are not in sync are ejected by the first probe
+    if(ret)
+    {
+        probe();
+        m_probeTimer.start(m_parameters["probeInterval"].toInt());
+    }
+    return ret;
+}
+
+bool EthBalancedClient::disconnectToServer()
+{
+    m_probeTimer.stop();
+    for(int i = 0; i < m_backends.size(); i++)
+    {
+        m_backends[i].connected = false;
+        m_backends[i].healthy = false;
+        m_backends[i].client->disconnectToServer();
+    }
+    m_pinned = -1;
+    return true;
+}
+
+bool EthBalancedClient::requestingResponse(const QByteArray &request, QByteArray &response)
+{
+    int index = selectBackend(isStateful(request));
+    if(index < 0)
+    {
+        m_error = "No backend";
+        return false;
+    }
+
+    beginRequest(index);
+    QElapsedTimer timer;
+    timer.start();
+    bool ret = m_backends[index].client->requestingResponse(request, response);
+    endRequest(index, timer.nsecsElapsed(), ret);
+    return ret;
+}
+
+bool EthBalancedClient::postRequest(const QByteArray &request, const ResponseHandler &handler)
+{
+    int index = selectBackend(isStateful(request));
+    if(index < 0)
+    {
+        m_error = "No backend";
+        handler(false, QByteArray());
+        return false;
+    }
+
+    beginRequest(index);
+    QElapsedTimer timer;
+    timer.start();
+    return m_backends[index].client->postRequest(request, [this, index, timer, handler](bool success, const QByteArray& response) {
+        endRequest(index, timer.nsecsElapsed(), success);
+        handler(success, response);
+    });
+}
+
+bool EthBalancedClient::setNotificationHandler(const NotificationHandler &handler)
+{
+    //The subscription ids are unique, the notifications of every backend go to the same handler
+    bool ret = false;
+    for(int i = 0; i < m_backends.size(); i++)
+    {
+        if(m_backends[i].client->setNotificationHandler(handler))
+            ret = true;
+    }
+    return ret;
+}
+
+bool EthBalancedClient::waitForEvents(int msecs)
+{
+    //The time is shared between the backends with requests in flight
+    QList<int> busy;
+    for(int i = 0; i < m_backends.size(); i++)
+    {
+        if(m_backends[i].inFlight > 0 || m_backends[i].probing)
+            busy.append(i);
+    }
+    bool ret = false;
+    for(int i = 0; i < busy.size(); i++)
+    {
+        if(m_backends[busy[i]].client->waitForEvents(msecs / busy.size()))
+            ret = true;
+    }
+    return ret;
+}
+
+bool EthBalancedClient::canWaitForEvents() const
+{
+    for(int i = 0; i < m_backends.size(); i++)
+    {
+        if(m_backends[i].client->canWaitForEvents())
+            return true;
+    }
+    return false;
+}
+
+int64_t EthBalancedClient::errorNumber()
+{
+    return m_code;
+}
+
+QString EthBalancedClient::errorString()
+{
+    return m_error;
+}
+
+int EthBalancedClient::backendCount() const
+{
+    return m_backends.size();
+}
+
+IEthClient *EthBalancedClient::backend(int index) const
+{
+    return m_backends[index].client;
+}
+
+bool EthBalancedClient::isHealthy(int index) const
+{
+    return m_backends[index].healthy;
+}
+
+double EthBalancedClient::latency(int index) const
+{
+    return m_backends[index].latency;
+}
+
+int EthBalancedClient::inFlight(int index) const
+{
+    return m_backends[index].inFlight;
+}
+
+int64_t EthBalancedClient::headBlock(int index) const
+{
+    return m_backends[index].head;
+}
+
+bool EthBalancedClient::postHedgedRequest(const QByteArray &request, const ResponseHandler &handler)
+{
+    int index = selectBackend(false);
+    if(index < 0)
+    {
+        m_error = "No backend";
+        handler(false, QByteArray());
+        return false;
+    }
+
+    int delay = hedgeDelay();
+    QSharedPointer<HedgedRequest> hedged = startHedged(index, request, handler);
+    if(!hedged->done && delay >= 0)
+        QTimer::singleShot(delay, this, [this, request, hedged]() { sendHedge(request, hedged, false); });
+    return true;
+}
+
+bool EthBalancedClient::requestingHedgedResponse(const QByteArray &request, QByteArray &response)
+{
+    //The responses are waited on the sockets of the backends like the blocking requests, without event loop,
+    //so the timers and the notifications can not enter the caller while it waits
+    int index = selectBackend(false);
+    if(index < 0 || !m_backends[index].client->canWaitForEvents())
+        return requestingResponse(request, response);
+
+    bool ret = false;
+    bool finished = false;
+    int delay = hedgeDelay();
+    QSharedPointer<HedgedRequest> hedged = startHedged(index, request, [&ret, &finished, &response](bool success, const QByteArray& data) {
+        ret = success;
+        //The data may point into the buffer of the transport
+        response = QByteArray(data.constData(), data.size());
+        finished = true;
+    });
+
+    int hedge = -1;
+    while(!finished)
+    {
+        qint64 elapsed = hedged->timer.elapsed();
+        if(delay >= 0 && elapsed >= delay)
+        {
+            hedge = sendHedge(request, hedged, true);
+            delay = -1;
+            continue;
+        }
+
+        //The first backend is waited until the hedge delay, then the two backends in turn
+        int msecs = hedge >= 0 ? HEDGE_WAIT_MSECS : delay >= 0 ? int(delay - elapsed) : WAIT_MSECS;
+        bool waiting = m_backends[index].client->waitForEvents(msecs);
+        if(!finished && hedge >= 0)
+            waiting = m_backends[hedge].client->waitForEvents(msecs) || waiting;
+        if(!finished && !waiting)
+        {
+            m_error = "The backends can not be waited";
+            break;
+        }
+    }
+
+    //The late responses must not reach the variables of this call
+    hedged->done = true;
+    hedged->handler = ResponseHandler();
+    return ret;
+}
+
+int EthBalancedClient::hedgeDelay()
+{
+    if(m_latencyCount < MIN_LATENCY_SAMPLES)
+        return -1;
+    if(m_hedgeDelay < 0 || m_newLatencies >= DELAY_UPDATE_SAMPLES)
+    {
+        QVector<double> latencies = m_latencies.mid(0, m_latencyCount);
+        double percentile = qBound(0.0, m_parameters["hedgePercentile"].toDouble(), 1.0);
+        int rank = qMin(int(percentile * latencies.size()), latencies.size() - 1);
+        std::nth_element(latencies.begin(), latencies.begin() + rank, latencies.end());
+        m_hedgeDelay = qMax(1, int(std::ceil(latencies[rank])));
+        m_newLatencies = 0;
+    }
+    return m_hedgeDelay;
+}
+
+qint64 EthBalancedClient::hedgeCount() const
+{
+    return m_hedges;
+}
+
+void EthBalancedClient::probe()
+{
+    QList<const JsonRPCMethod*> methods;
+    methods << &JSONRPC_METHOD("eth_blockNumber") << &JSONRPC_METHOD("eth_syncing");
+    QVariantList params;
+    params << QVariant(QVariantList()) << QVariant(QVariantList());
+
+    for(int i = 0; i < m_backends.size(); i++)
+    {
+        Backend& backend = m_backends[i];
+        if(backend.probing)
+        {
+            //The previous probe is still waiting, the node is too slow to serve the requests
+            backend.failed = true;
+            continue;
+        }
+        if(!backend.connected)
+        {
+            backend.connected = backend.client->connectToServer();
+            if(!backend.connected)
+                continue;
+        }
+
+        QVector<int64_t> ids;
+        QByteArray request = encodeJsonRPCBatch(methods, params, ids);
+        backend.probing = true;
+        beginRequest(i);
+        QElapsedTimer timer;
+        timer.start();
+        backend.client->postRequest(request, [this, i, ids, timer](bool success, const QByteArray& response) {
+            endRequest(i, timer.nsecsElapsed(), success);
+            onProbeResponse(i, success, response, ids);
+        });
+    }
+    updateHealth();
+}
+
+int EthBalancedClient::selectBackend(bool stateful, int exclude)
+{
+    if(stateful && m_pinned >= 0 && m_backends[m_pinned].healthy)
+        return m_pinned;
+
+    //The ejected backends are used only when no backend is healthy,
+    //the search start at a rotating backend to spread the requests between equal backends
+    int best = -1;
+    double bestScore = 0;
+    int count = m_backends.size();
+    for(int n = 0; n < count; n++)
+    {
+        int i = (m_next + n) % count;
+        const Backend& backend = m_backends[i];
+        if(!backend.connected || i == exclude)
+            continue;
+        double score = (backend.latency + 1) * (backend.inFlight + 1);
+        if(best < 0 || (backend.healthy && !m_backends[best].healthy) ||
+                (backend.healthy == m_backends[best].healthy && score < bestScore))
+        {
+            best = i;
+            bestScore = score;
+        }
+    }
+    if(count)
+        m_next = (m_next + 1) % count;
+    if(stateful)
+        m_pinned = best;
+    return best;
+}
+
+void EthBalancedClient::beginRequest(int index)
+{
+    m_backends[index].inFlight++;
+}
+
+void EthBalancedClient::endRequest(int index, qint64 elapsed, bool success)
+{
+    Backend& backend = m_backends[index];
+    backend.inFlight--;
+    if(success)
+    {
+        double msecs = elapsed / 1000000.0;
+        double smoothing = m_parameters["smoothing"].toDouble();
+        backend.latency = backend.latency > 0 ? smoothing * msecs + (1 - smoothing) * backend.latency : msecs;
+    }
+    else if(backend.connected)
+    {
+        //Ejected until a probe succeed
+        m_code = backend.client->errorNumber();
+        m_error = backend.client->errorString();
+        backend.failed = true;
+        setHealthy(index, false);
+    }
+}
+
+void EthBalancedClient::onProbeResponse(int index, bool success, const QByteArray &response, const QVector<int64_t> &ids)
+{
+    Backend& backend = m_backends[index];
+    backend.probing = false;
+    if(!backend.connected)
+        return;
+
+    EInt blockNumber;
+    ESyncing syncing;
+    QHash<int64_t, EValue*> outputs;
+    outputs[ids[0]] = &blockNumber;
+    outputs[ids[1]] = &syncing;
+    QSet<int64_t> decoded;
+    if(success && decodeJsonRPCBatch(response, outputs, decoded) && decoded.contains(ids[0]))
+    {
+        backend.failed = false;
+        backend.head = blockNumber;
+        backend.syncing = decoded.contains(ids[1]) && syncing.isSyncing();
+    }
+    else
+    {
+        backend.failed = true;
+    }
+    updateHealth();
+}
+
+void EthBalancedClient::updateHealth()
+{
+    //The head of the pool is the highest head of the backends that answer and are not syncing
+    int64_t poolHead = -1;
+    for(int i = 0; i < m_backends.size(); i++)
+    {
+        const Backend& backend = m_backends[i];
+        if(backend.connected && !backend.failed && !backend.syncing)
+            poolHead = qMax(poolHead, backend.head);
+    }
+
+    int64_t maxLag = m_parameters["maxLag"].toLongLong();
+    for(int i = 0; i < m_backends.size(); i++)
+    {
+        const Backend& backend = m_backends[i];
+        bool behind = backend.head >= 0 && poolHead >= 0 && backend.head + maxLag < poolHead;
+        setHealthy(i, backend.connected && !backend.failed && !backend.syncing && !behind);
+    }
+}
+
+void EthBalancedClient::setHealthy(int index, bool healthy)
+{
+    if(m_backends[index].healthy == healthy)
+        return;
+    m_backends[index].healthy = healthy;
+    if(healthy)
+        emit backendRestored(index);
+    else
+        emit backendEjected(index);
+}
+
+void EthBalancedClient::sendHedged(int index, const QByteArray &request, const QSharedPointer<HedgedRequest> &hedged)
+{
+    hedged->pending++;
+    beginRequest(index);
+    QElapsedTimer timer;
+    timer.start();
+    m_backends[index].client->postRequest(request, [this, index, timer, hedged](bool success, const QByteArray& response) {
+        endRequest(index, timer.nsecsElapsed(), success);
+        hedged->pending--;
+        //JSON RPC can not cancel a request, the response of the slower backend is ignored
+        if(hedged->done)
+            return;
+        //An error of the node is not a valid result while the other backend may still answer,
+        //it is kept for when the other backend fail too
+        bool valid = success && !peekJsonRPCError(response);
+        if(!valid && hedged->pending > 0)
+        {
+            if(success && hedged->error.isNull())
+                hedged->error = QByteArray(response.constData(), response.size());
+            return;
+        }
+        hedged->done = true;
+        if(valid)
+            addLatency(hedged->timer.nsecsElapsed() / 1000000.0);
+        ResponseHandler handler = hedged->handler;
+        hedged->handler = ResponseHandler();
+        if(!success && !hedged->error.isNull())
+            handler(true, hedged->error);
+        else
+            handler(success, response);
+    });
+}
+
+QSharedPointer<EthBalancedClient::HedgedRequest> EthBalancedClient::startHedged(int index, const QByteArray &request, const ResponseHandler &handler)
+{
+    //Token bucket of the hedges, the quiet periods save a few hedges for the bursts of slow responses
+    m_hedgeTokens = qMin(m_hedgeTokens + m_parameters["hedgeBudget"].toDouble(), HEDGE_BURST);
+    QSharedPointer<HedgedRequest> hedged(new HedgedRequest);
+    hedged->handler = handler;
+    hedged->timer.start();
+    hedged->primary = index;
+    hedged->pending = 0;
+    hedged->done = false;
+    sendHedged(index, request, hedged);
+    return hedged;
+}
+
+int EthBalancedClient::sendHedge(const QByteArray &request, const QSharedPointer<HedgedRequest> &hedged, bool waiting)
+{
+    if(hedged->done || m_hedgeTokens < 1)
+        return -1;
+    int index = selectBackend(false, hedged->primary);
+    if(index < 0 || !m_backends[index].healthy)
+        return -1;
+    //A blocking hedge need a backend whose socket can be waited
+    if(waiting && !m_backends[index].client->canWaitForEvents())
+        return -1;
+    m_hedgeTokens -= 1;
+    m_hedges++;
+    sendHedged(index, request, hedged);
+    return index;
+}
+
+void EthBalancedClient::addLatency(double msecs)
+{
+    m_latencies[m_latencyIndex] = msecs;
+    m_latencyIndex = (m_latencyIndex + 1) % m_latencies.size();
+    m_latencyCount = qMin(m_latencyCount + 1, m_latencies.size());
+    m_newLatencies++;
+}
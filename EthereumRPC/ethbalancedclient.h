@@ -0,0 +1,127 @@
+#ifndef ETHBALANCEDCLIENT_H
+#define ETHBALANCEDCLIENT_H
+
+#include <QObject>
+#include <QList>
+#include <QTimer>
+#include <QVector>
+#include <QElapsedTimer>
+#include <QSharedPointer>
+#include "iethclient.h"
+
+//JSON RPC over several nodes, every request go to the backend with the lowest latency weighted by its requests in flight.
+//The backends are probed in background with eth_blockNumber and eth_syncing, the nodes that are syncing,
+//do not answer or whose head is behind the head of the pool are ejected until a probe find them in sync.
+//The filters and the subscriptions live in one node, their requests are pinned to one backend.
+//The read requests can be hedged: sent again to a second backend when the first one is slow.
+class EthBalancedClient : public QObject, public IEthClient
+{
+    Q_OBJECT
+public:
+    //The client own the backends
+    explicit EthBalancedClient(const QList<IEthClient*>& backends, QObject *parent = 0);
+    ~EthBalancedClient();
+
+    QVariantMap &clientParameters() override;
+    bool connectToServer() override;
+    bool disconnectToServer() override;
+    bool requestingResponse(const QByteArray& request, QByteArray& response) override;
+    bool postRequest(const QByteArray& request, const ResponseHandler& handler) override;
+    bool setNotificationHandler(const NotificationHandler& handler) override;
+    bool waitForEvents(int msecs) override;
+    bool canWaitForEvents() const override;
+    int64_t errorNumber() override;
+    QString errorString() override;
+
+    int backendCount() const;
+    IEthClient* backend(int index) const;
+    bool isHealthy(int index) const;
+    //Moving average of the latency of the backend in milliseconds, 0 before its first response
+    double latency(int index) const;
+    int inFlight(int index) const;
+    //Last block number reported by the probes of the backend, -1 when unknown
+    int64_t headBlock(int index) const;
+
+    //Post a request that can be sent twice, if the backend does not answer within the hedge delay
+    //the request is posted to a second backend and the first result wins, the response of the other is ignored.
+    //An error response win only when the other backend has answered or has failed too.
+    //Every hedged request earn "hedgeBudget" hedge, so the hedges add at most this fraction of the requests.
+    bool postHedgedRequest(const QByteArray& request, const ResponseHandler& handler);
+    //Blocking hedged request, the sockets of the backends are waited without event loop,
+    //the backends that can not be waited like the synchronous clients are not hedged
+    bool requestingHedgedResponse(const QByteArray& request, QByteArray& response);
+    //Delay before the hedge in milliseconds, the "hedgePercentile" of the latencies of the last hedged requests,
+    //-1 until there are enough latencies
+    int hedgeDelay();
+    //Number of hedges sent
+    qint64 hedgeCount() const;
+
+signals:
+    void backendEjected(int index);
+    void backendRestored(int index);
+
+public slots:
+    //Send the health probes to every backend, called by the timer
+    void probe();
+
+private:
+    struct Backend
+    {
+        IEthClient* client;
+        bool connected;
+        bool healthy;
+        //Exponentially weighted moving average of the latency
+        double latency;
+        int inFlight;
+        int64_t head;
+        bool syncing;
+        bool probing;
+        //Set by a failed request or probe, cleared by the next successful probe
+        bool failed;
+    };
+
+    struct HedgedRequest
+    {
+        ResponseHandler handler;
+        QElapsedTimer timer;
+        int primary;
+        int pending;
+        bool done;
+        //First error response of the node, delivered when no backend give a result
+        QByteArray error;
+    };
+
+    //Return the backend with the lowest score, -1 when there is no backend
+    int selectBackend(bool stateful, int exclude = -1);
+    void beginRequest(int index);
+    void endRequest(int index, qint64 elapsed, bool success);
+    void onProbeResponse(int index, bool success, const QByteArray& response, const QVector<int64_t>& ids);
+    void updateHealth();
+    void setHealthy(int index, bool healthy);
+    void sendHedged(int index, const QByteArray& request, const QSharedPointer<HedgedRequest>& hedged);
+    QSharedPointer<HedgedRequest> startHedged(int index, const QByteArray& request, const ResponseHandler& handler);
+    //Send the hedge to a second backend, return the backend or -1 when the request is not hedged
+    int sendHedge(const QByteArray& request, const QSharedPointer<HedgedRequest>& hedged, bool waiting);
+    void addLatency(double msecs);
+
+    QList<Backend> m_backends;
+    QVariantMap m_parameters;
+    QTimer m_probeTimer;
+    //Backend of the filters and the subscriptions
+    int m_pinned;
+    int m_next;
+    int m_code;
+    QString m_error;
+
+    //Ring of the latencies of the hedged requests
+    QVector<double> m_latencies;
+    int m_latencyIndex;
+    int m_latencyCount;
+    //The delay is computed again after some new latencies
+    int m_hedgeDelay;
+    int m_newLatencies;
+    double m_hedgeTokens;
+    qint64 m_hedges;
+};
+
+#endif // ETHBALANCEDCLIENT_H
@@ -0,0 +1,361 @@
+#include "ethblockfetcher.h"
+#include "ethrpc.h"
+#include "ethblockstore.h"
+#include <QThread>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QWaitCondition>
+#include <QHash>
+
+namespace BlockFetcher_NS {
+const int WORKER_COUNT = 4;
+const int BATCH_SIZE = 16;
+const int WINDOW_SIZE = 512;
+const int MAX_ATTEMPTS = 3;
+}
+using namespace BlockFetcher_NS;
+
+//Block with its receipts, waiting in the reorder buffer
+struct FetchedBlock
+{
+    EBlock block;
+    QVector<EReceipt> receipts;
+};
+
+class BlockFetcher_Private
+{
+public:
+    BlockFetcher_Private():
+        m_workerCount(WORKER_COUNT),
+        m_batchSize(BATCH_SIZE),
+        m_windowSize(WINDOW_SIZE),
+        m_full(false),
+        m_withReceipts(false),
+        m_next(0),
+        m_last(-1),
+        m_delivered(0),
+        m_stopped(true)
+    {}
+
+    //Reserve the next batch, false when the range is done or the fetch is stopped
+    bool takeBatch(int64_t& first, int64_t& last)
+    {
+        QMutexLocker locker(&m_mutex);
+        //The batch of the next block to deliver always fit, so the window can not dead lock
+        while(!m_stopped && m_next <= m_last && m_next + m_batchSize - m_delivered > m_windowSize && m_next != m_delivered)
+            m_windowFree.wait(&m_mutex);
+        if(m_stopped || m_next > m_last)
+            return false;
+        first = m_next;
+        last = qMin(m_next + m_batchSize - 1, m_last);
+        m_next = last + 1;
+        return true;
+    }
+
+    void putBlocks(int64_t first, const QVector<FetchedBlock>& blocks)
+    {
+        QMutexLocker locker(&m_mutex);
+        for(int i = 0; i < blocks.count(); i++)
+        {
+            m_ready.insert(first + i, blocks[i]);
+        }
+        m_blockReady.wakeAll();
+    }
+
+    void fail(const QString& error)
+    {
+        QMutexLocker locker(&m_mutex);
+        if(m_error.isEmpty())
+            m_error = error;
+        stopLocked();
+    }
+
+    void stopLocked()
+    {
+        m_stopped = true;
+        m_blockReady.wakeAll();
+        m_windowFree.wakeAll();
+    }
+
+    QStringList m_serverUris;
+    int m_workerCount;
+    int m_batchSize;
+    int m_windowSize;
+    bool m_full;
+    QSharedPointer<EthBlockStore> m_store;
+    //Set for the duration of a fetch, read by the workers
+    bool m_withReceipts;
+    EthBloomQuery m_query;
+
+    //State of the current fetch, guarded by the mutex
+    QMutex m_mutex;
+    QWaitCondition m_blockReady;
+    QWaitCondition m_windowFree;
+    QHash<int64_t, FetchedBlock> m_ready;
+    int64_t m_next;
+    int64_t m_last;
+    int64_t m_delivered;
+    bool m_stopped;
+    QString m_error;
+};
+
+//Worker with its own connection that fetch batches until the range is done
+class BlockFetcherWorker : public QThread
+{
+public:
+    BlockFetcherWorker(BlockFetcher_Private* p, const QString& serverUri):
+        m_p(p),
+        m_serverUri(serverUri)
+    {}
+
+protected:
+    void run() override
+    {
+        EthRPC rpc;
+        rpc.setBlockStore(m_p->m_store);
+        if(!rpc.connect(m_serverUri))
+        {
+            m_p->fail(QString("Can not connect to %1").arg(m_serverUri));
+            return;
+        }
+
+        int64_t first = 0;
+        int64_t last = 0;
+        while(m_p->takeBatch(first, last))
+        {
+            QVector<FetchedBlock> blocks;
+            QString error;
+            bool ok = false;
+            for(int attempt = 0; attempt < MAX_ATTEMPTS && !ok; attempt++)
+            {
+                if(attempt > 0 && !rpc.connect(m_serverUri))
+                {
+                    error = QString("Can not connect to %1").arg(m_serverUri);
+                    continue;
+                }
+                ok = fetchBatch(rpc, first, last, blocks, error) &&
+                        (!m_p->m_withReceipts || fetchReceipts(rpc, blocks, error));
+            }
+            if(!ok)
+            {
+                m_p->fail(error);
+                return;
+            }
+            m_p->putBlocks(first, blocks);
+        }
+    }
+
+private:
+    bool fetchBatch(EthRPC& rpc, int64_t first, int64_t last, QVector<FetchedBlock>& blocks, QString& error)
+    {
+        blocks.clear();
+        blocks.resize(int(last - first + 1));
+        rpc.beginBatch();
+        for(int i = 0; i < blocks.count(); i++)
+        {
+            rpc.eth_getBlockByNumber(EVariant(qint64(first + i)), m_p->m_full, blocks[i].block);
+        }
+        QVector<bool> results;
+        rpc.sendBatch(&results);
+        for(int i = 0; i < blocks.count(); i++)
+        {
+            if(!results.value(i) || blocks[i].block.isNull())
+            {
+                error = QString("Can not fetch the block %1").arg(first + i);
+                return false;
+            }
+        }
+        return true;
+    }
+
+    //Fetch in one batch the receipts of the blocks whose bloom may match the query
+    bool fetchReceipts(EthRPC& rpc, QVector<FetchedBlock>& blocks, QString& error)
+    {
+        rpc.beginBatch();
+        for(int i = 0; i < blocks.count(); i++)
+        {
+            FetchedBlock& fetched = blocks[i];
+            fetched.receipts.clear();
+            if(!m_p->m_query.isEmpty() && !m_p->m_query.mayMatch(fetched.block.logsBloom))
+                continue;
+            const QVector<EHash32>& hashes = fetched.block.transactions.hashes();
+            fetched.receipts.resize(hashes.count());
+            for(int j = 0; j < hashes.count(); j++)
+            {
+                rpc.eth_getTransactionReceipt(hashes[j], fetched.receipts[j]);
+            }
+        }
+        QVector<bool> results;
+        if(!rpc.batchSize())
+        {
+            rpc.cancelBatch();
+            return true;
+        }
+        if(!rpc.sendBatch(&results))
+        {
+            error = QString("Can not fetch the receipts of the blocks %1 to %2")
+                    .arg(int64_t(blocks.first().block.number)).arg(int64_t(blocks.last().block.number));
+            return false;
+        }
+        return true;
+    }
+
+    BlockFetcher_Private* m_p;
+    QString m_serverUri;
+};
+
+EthBlockFetcher::EthBlockFetcher():
+    m_p(0)
+{
+    m_p = new BlockFetcher_Private();
+}
+
+EthBlockFetcher::~EthBlockFetcher()
+{
+    delete m_p;
+    m_p = 0;
+}
+
+void EthBlockFetcher::setServerUris(const QStringList &serverUris)
+{
+    m_p->m_serverUris = serverUris;
+}
+
+QStringList EthBlockFetcher::serverUris() const
+{
+    return m_p->m_serverUris;
+}
+
+void EthBlockFetcher::setWorkerCount(int count)
+{
+    m_p->m_workerCount = qMax(1, count);
+}
+
+int EthBlockFetcher::workerCount() const
+{
+    return m_p->m_workerCount;
+}
+
+void EthBlockFetcher::setBatchSize(int size)
+{
+    m_p->m_batchSize = qMax(1, size);
+}
+
+int EthBlockFetcher::batchSize() const
+{
+    return m_p->m_batchSize;
+}
+
+void EthBlockFetcher::setWindowSize(int size)
+{
+    m_p->m_windowSize = qMax(1, size);
+}
+
+int EthBlockFetcher::windowSize() const
+{
+    return m_p->m_windowSize;
+}
+
+void EthBlockFetcher::setFullTransactions(bool full)
+{
+    m_p->m_full = full;
+}
+
+bool EthBlockFetcher::fullTransactions() const
+{
+    return m_p->m_full;
+}
+
+void EthBlockFetcher::setBlockStore(const QSharedPointer<EthBlockStore> &store)
+{
+    m_p->m_store = store;
+}
+
+QSharedPointer<EthBlockStore> EthBlockFetcher::blockStore() const
+{
+    return m_p->m_store;
+}
+
+bool EthBlockFetcher::fetch(int64_t first, int64_t last, const BlockHandler &handler)
+{
+    m_p->m_withReceipts = false;
+    return run(first, last, [&handler](const EBlock& block, const QVector<EReceipt>&) { return handler(block); });
+}
+
+bool EthBlockFetcher::fetchReceipts(int64_t first, int64_t last, const EthBloomQuery &query, const ReceiptHandler &handler)
+{
+    m_p->m_withReceipts = true;
+    m_p->m_query = query;
+    return run(first, last, handler);
+}
+
+bool EthBlockFetcher::run(int64_t first, int64_t last, const ReceiptHandler &handler)
+{
+    {
+        QMutexLocker locker(&m_p->m_mutex);
+        m_p->m_ready.clear();
+        m_p->m_next = first;
+        m_p->m_last = last;
+        m_p->m_delivered = first;
+        m_p->m_stopped = false;
+        m_p->m_error.clear();
+    }
+
+    QStringList serverUris = m_p->m_serverUris;
+    if(serverUris.isEmpty())
+        serverUris.append(QString());
+
+    QList<BlockFetcherWorker*> workers;
+    for(int i = 0; i < m_p->m_workerCount; i++)
+    {
+        BlockFetcherWorker* worker = new BlockFetcherWorker(m_p, serverUris[i % serverUris.count()]);
+        workers.append(worker);
+        worker->start();
+    }
+
+    bool done = first > last;
+    while(!done)
+    {
+        FetchedBlock fetched;
+        {
+            QMutexLocker locker(&m_p->m_mutex);
+            while(!m_p->m_stopped && !m_p->m_ready.contains(m_p->m_delivered))
+                m_p->m_blockReady.wait(&m_p->m_mutex);
+            if(m_p->m_stopped)
+                break;
+            fetched = m_p->m_ready.take(m_p->m_delivered);
+            m_p->m_delivered++;
+            m_p->m_windowFree.wakeAll();
+            done = m_p->m_delivered > m_p->m_last;
+        }
+
+        if(!handler(fetched.block, fetched.receipts))
+            break;
+    }
+
+    {
+        QMutexLocker locker(&m_p->m_mutex);
+        m_p->stopLocked();
+    }
+    for(int i = 0; i < workers.count(); i++)
+    {
+        workers[i]->wait();
+        delete workers[i];
+    }
+
+    QMutexLocker locker(&m_p->m_mutex);
+    m_p->m_ready.clear();
+    return done && m_p->m_error.isEmpty();
+}
+
+void EthBlockFetcher::stop()
+{
+    QMutexLocker locker(&m_p->m_mutex);
+    m_p->stopLocked();
+}
+
+QString EthBlockFetcher::errorString() const
+{
+    QMutexLocker locker(&m_p->m_mutex);
+    return m_p->m_error;
+}
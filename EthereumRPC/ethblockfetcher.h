@@ -0,0 +1,117 @@
+#ifndef ETHBLOCKFETCHER_H
+#define ETHBLOCKFETCHER_H
+
+#include <QStringList>
+#include <QSharedPointer>
+#include <functional>
+#include "ethrpc_global.h"
+#include "ethobject.h"
+#include "ethbloom.h"
+
+class BlockFetcher_Private;
+class EthBlockStore;
+
+/**
+ * @brief The EthBlockFetcher class fetch a range of blocks in batches with several connections
+ * and deliver the blocks in increasing order of number.
+ */
+class ETHRPCSHARED_EXPORT EthBlockFetcher
+{
+public:
+    //Called for every block in order, return false to stop the fetch
+    typedef std::function<bool(const EBlock& block)> BlockHandler;
+    //Called for every block in order with its receipts, return false to stop the fetch
+    typedef std::function<bool(const EBlock& block, const QVector<EReceipt>& receipts)> ReceiptHandler;
+
+    /**
+     * @brief EthBlockFetcher Constructor
+     */
+    EthBlockFetcher();
+
+    /**
+     * @brief ~EthBlockFetcher Destructor
+     */
+    virtual ~EthBlockFetcher();
+
+    /**
+     * @brief setServerUris Set the servers, the workers are assigned to them in turn.
+     * @param serverUris Uris to the servers, with the same format as EthRPC::connect.
+     */
+    void setServerUris(const QStringList& serverUris);
+    QStringList serverUris() const;
+
+    /**
+     * @brief setWorkerCount Set the number of workers, every worker has its own connection.
+     * @param count Number of workers, 4 by default.
+     */
+    void setWorkerCount(int count);
+    int workerCount() const;
+
+    /**
+     * @brief setBatchSize Set the number of blocks requested in one JSON RPC batch.
+     * @param size Number of blocks, 16 by default.
+     */
+    void setBatchSize(int size);
+    int batchSize() const;
+
+    /**
+     * @brief setWindowSize Set the maximum number of blocks requested but not yet delivered,
+     * the workers wait when the handler falls behind.
+     * @param size Number of blocks, 512 by default.
+     */
+    void setWindowSize(int size);
+    int windowSize() const;
+
+    /**
+     * @brief setFullTransactions Set if the blocks hold the full transaction objects.
+     * @param full true for the transaction objects, false for the hashes, the default.
+     */
+    void setFullTransactions(bool full);
+    bool fullTransactions() const;
+
+    /**
+     * @brief setBlockStore Set the store shared by the workers, the confirmed blocks are read from it
+     * and the fetched blocks and receipts are appended to it.
+     * @param store The opened store, null to disable the store, the default.
+     */
+    void setBlockStore(const QSharedPointer<EthBlockStore>& store);
+    QSharedPointer<EthBlockStore> blockStore() const;
+
+    /**
+     * @brief fetch Fetch the blocks from first to last included and call the handler in the calling thread.
+     * @param first Number of the first block.
+     * @param last Number of the last block.
+     * @param handler Handler of the blocks.
+     * @return true if every block was delivered, false on error or when stopped.
+     */
+    bool fetch(int64_t first, int64_t last, const BlockHandler& handler);
+
+    /**
+     * @brief fetchReceipts Fetch the blocks from first to last included and the receipts of the blocks
+     * whose logs bloom may match the query, the handler is called in the calling thread.
+     * @param first Number of the first block.
+     * @param last Number of the last block.
+     * @param query Addresses and topics of the logs, the receipts of every block are fetched when empty.
+     * @param handler Handler of the blocks, the receipts are empty for the blocks that can not match.
+     * @return true if every block was delivered, false on error or when stopped.
+     */
+    bool fetchReceipts(int64_t first, int64_t last, const EthBloomQuery& query, const ReceiptHandler& handler);
+
+    /**
+     * @brief stop Stop the current fetch, can be called from the handler or from another thread.
+     */
+    void stop();
+
+    /**
+     * @brief errorString Return the error of the last fetch.
+     * @return Error message, empty when there was no error.
+     */
+    QString errorString() const;
+
+private:
+    bool run(int64_t first, int64_t last, const ReceiptHandler& handler);
+
+    BlockFetcher_Private* m_p;
+};
+
+#endif // ETHBLOCKFETCHER_H
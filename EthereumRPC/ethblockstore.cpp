@@ -0,0 +1,358 @@
+#include "ethblockstore.h"
+#include "jsoncoder.h"
+#include "ethrpc_utils.h"
+#include <QMutexLocker>
+#include <QtEndian>
+
+namespace BlockStore_NS {
+const quint32 MAGIC = 0x31535245; //"ERS1"
+//Magic 4 Bytes, type 1 Byte, padding 3 Bytes, hash 32 Bytes, length 4 Bytes, checksum 4 Bytes
+const int HEADER_SIZE = 48;
+const int TYPE_OFFSET = 4;
+const int HASH_OFFSET = 8;
+const int LENGTH_OFFSET = 40;
+const int CHECKSUM_OFFSET = 44;
+//Depth of the blocks served by number, far below the usual reorganizations
+const int CONFIRMATIONS = 64;
+
+quint32 crc32(const uchar* data, qint64 size)
+{
+    static const QVector<quint32> table = []()
+    {
+        QVector<quint32> table(256);
+        for(quint32 i = 0; i < 256; i++)
+        {
+            quint32 value = i;
+            for(int j = 0; j < 8; j++)
+                value = (value & 1) ? (value >> 1) ^ 0xEDB88320 : value >> 1;
+            table[i] = value;
+        }
+        return table;
+    }();
+
+    quint32 crc = 0xFFFFFFFF;
+    for(qint64 i = 0; i < size; i++)
+        crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+    return crc ^ 0xFFFFFFFF;
+}
+}
+using namespace BlockStore_NS;
+
+EthBlockStore::EthBlockStore(const QString &fileName):
+    m_fileName(fileName),
+    m_map(0),
+    m_mapSize(0),
+    m_size(0),
+    m_confirmations(CONFIRMATIONS),
+    m_head(-1)
+{}
+
+EthBlockStore::~EthBlockStore()
+{
+    close();
+}
+
+bool EthBlockStore::open()
+{
+    QMutexLocker locker(&m_mutex);
+    if(m_file.isOpen())
+        return true;
+
+    m_file.setFileName(m_fileName);
+    if(!m_file.open(QIODevice::ReadWrite))
+    {
+        m_error = m_file.errorString();
+        return false;
+    }
+    m_size = m_file.size();
+    if(!scan())
+    {
+        m_file.close();
+        return false;
+    }
+    return true;
+}
+
+void EthBlockStore::close()
+{
+    QMutexLocker locker(&m_mutex);
+    if(m_map)
+        m_file.unmap(m_map);
+    m_map = 0;
+    m_mapSize = 0;
+    m_size = 0;
+    for(int i = 0; i < 4; i++)
+    {
+        m_index[i].clear();
+    }
+    m_numbers.clear();
+    m_head = -1;
+    m_file.close();
+}
+
+bool EthBlockStore::isOpen() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_file.isOpen();
+}
+
+bool EthBlockStore::load(RecordType type, const EHash32 &hash, EValue &out)
+{
+    QMutexLocker locker(&m_mutex);
+    QHash<EHash32, qint64>::const_iterator it = m_index[type - 1].constFind(hash);
+    if(it == m_index[type - 1].constEnd())
+        return false;
+
+    qint64 offset = it.value();
+    if(offset + HEADER_SIZE > m_mapSize && !remap())
+        return false;
+    const uchar* header = m_map + offset;
+    quint32 length = qFromLittleEndian<quint32>(header + LENGTH_OFFSET);
+    if(offset + HEADER_SIZE + length > m_mapSize && !remap())
+        return false;
+
+    const char* payload = reinterpret_cast<const char*>(m_map + offset + HEADER_SIZE);
+    JsonReader reader(payload, payload + length);
+    out.fromJson(reader);
+    return !reader.hasError();
+}
+
+bool EthBlockStore::store(RecordType type, const EHash32 &hash, const EValue &value)
+{
+    QMutexLocker locker(&m_mutex);
+    if(!m_file.isOpen())
+        return false;
+    if(m_index[type - 1].contains(hash))
+        return true;
+
+    QByteArray record(HEADER_SIZE, '\0');
+    writeJson(value.toRawData(), record);
+    quint32 length = quint32(record.size() - HEADER_SIZE);
+    uchar* header = reinterpret_cast<uchar*>(record.data());
+    qToLittleEndian<quint32>(MAGIC, header);
+    header[TYPE_OFFSET] = uchar(type);
+    memcpy(header + HASH_OFFSET, hash.data(), hash.size());
+    qToLittleEndian<quint32>(length, header + LENGTH_OFFSET);
+    qToLittleEndian<quint32>(crc32(header + HEADER_SIZE, length), header + CHECKSUM_OFFSET);
+
+    if(!m_file.seek(m_size) || m_file.write(record) != record.size() || !m_file.flush())
+    {
+        m_error = m_file.errorString();
+        m_file.resize(m_size);
+        return false;
+    }
+    m_index[type - 1].insert(hash, m_size);
+    m_size += record.size();
+    const EBlock* block = dynamic_cast<const EBlock*>(&value);
+    if(block && !block->number.isNull())
+        indexNumber(block->number, hash);
+    return true;
+}
+
+bool EthBlockStore::contains(RecordType type, const EHash32 &hash) const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_index[type - 1].contains(hash);
+}
+
+int EthBlockStore::count() const
+{
+    QMutexLocker locker(&m_mutex);
+    int count = 0;
+    for(int i = 0; i < 4; i++)
+    {
+        count += m_index[i].count();
+    }
+    return count;
+}
+
+QString EthBlockStore::errorString() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_error;
+}
+
+void EthBlockStore::setConfirmations(int confirmations)
+{
+    QMutexLocker locker(&m_mutex);
+    m_confirmations = qMax(0, confirmations);
+}
+
+int EthBlockStore::confirmations() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_confirmations;
+}
+
+void EthBlockStore::setHeadBlock(int64_t number)
+{
+    QMutexLocker locker(&m_mutex);
+    m_head = qMax(m_head, number);
+}
+
+int64_t EthBlockStore::headBlock() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_head;
+}
+
+bool EthBlockStore::hashOf(int64_t number, EHash32 &hash) const
+{
+    QMutexLocker locker(&m_mutex);
+    if(number < 0 || number > m_head - m_confirmations)
+        return false;
+    QHash<int64_t, EHash32>::const_iterator it = m_numbers.constFind(number);
+    if(it == m_numbers.constEnd())
+        return false;
+    hash = it.value();
+    return true;
+}
+
+bool EthBlockStore::loadCall(const JsonRPCMethod &method, const QVariantList &params, EValue &out)
+{
+    RecordType type;
+    EHash32 hash;
+    if(!recordOf(method, params, type, hash))
+    {
+        //Only the numeric blocks, the tags move with the head
+        int64_t number = 0;
+        QString blockId = params.value(0).toString();
+        if(method.name() != "eth_getBlockByNumber" || !blockId.startsWith("0x") ||
+                !hex2int(blockId, number) || !hashOf(number, hash))
+            return false;
+        type = params.value(1).toBool() ? BlockWithTransactions : Block;
+    }
+    return load(type, hash, out);
+}
+
+bool EthBlockStore::storeCall(const JsonRPCMethod &method, const QVariantList &params, EValue &out)
+{
+    RecordType type;
+    EHash32 hash;
+    if(!recordOf(method, params, type, hash))
+    {
+        //The block is kept by its hash, a pending block has none
+        EBlock* block = dynamic_cast<EBlock*>(&out);
+        if(method.name() != "eth_getBlockByNumber" || !block || block->hash.isNull() || block->number.isNull())
+            return false;
+        type = params.value(1).toBool() ? BlockWithTransactions : Block;
+        hash = block->hash;
+    }
+    return isStorable(type, out) && store(type, hash, out);
+}
+
+bool EthBlockStore::recordOf(const JsonRPCMethod &method, const QVariantList &params, RecordType &type, EHash32 &hash)
+{
+    const QString& name = method.name();
+    if(name == "eth_getBlockByHash")
+        type = params.value(1).toBool() ? BlockWithTransactions : Block;
+    else if(name == "eth_getTransactionByHash")
+        type = Transaction;
+    else if(name == "eth_getTransactionReceipt")
+        type = Receipt;
+    else
+        return false;
+
+    hash.fromRawData(params.value(0));
+    return !hash.isNull();
+}
+
+bool EthBlockStore::isStorable(RecordType type, EValue &out)
+{
+    if(out.isNull())
+        return false;
+    if(type == Transaction)
+    {
+        ETransaction* transaction = dynamic_cast<ETransaction*>(&out);
+        return transaction && !transaction->blockHash.isNull();
+    }
+    return true;
+}
+
+bool EthBlockStore::remap()
+{
+    if(m_map)
+        m_file.unmap(m_map);
+    m_map = 0;
+    m_mapSize = 0;
+    if(m_size == 0)
+        return true;
+    m_map = m_file.map(0, m_size);
+    if(!m_map)
+    {
+        m_error = m_file.errorString();
+        return false;
+    }
+    m_mapSize = m_size;
+    return true;
+}
+
+bool EthBlockStore::scan()
+{
+    if(!remap())
+        return false;
+
+    //Index the valid records, the first invalid record is the torn tail of an interrupted write
+    qint64 offset = 0;
+    while(offset + HEADER_SIZE <= m_size)
+    {
+        const uchar* header = m_map + offset;
+        quint32 type = header[TYPE_OFFSET];
+        quint32 length = qFromLittleEndian<quint32>(header + LENGTH_OFFSET);
+        if(qFromLittleEndian<quint32>(header) != MAGIC || type < Block || type > Receipt ||
+                offset + HEADER_SIZE + length > m_size ||
+                qFromLittleEndian<quint32>(header + CHECKSUM_OFFSET) != crc32(header + HEADER_SIZE, length))
+            break;
+
+        EHash32 hash(QByteArray::fromRawData(reinterpret_cast<const char*>(header + HASH_OFFSET), 32));
+        m_index[type - 1].insert(hash, offset);
+        int64_t number = 0;
+        if((type == Block || type == BlockWithTransactions) &&
+                readNumber(reinterpret_cast<const char*>(header + HEADER_SIZE), length, number))
+            indexNumber(number, hash);
+        offset += HEADER_SIZE + length;
+    }
+
+    if(offset < m_size)
+    {
+        m_file.unmap(m_map);
+        m_map = 0;
+        m_mapSize = 0;
+        if(!m_file.resize(offset))
+        {
+            m_error = m_file.errorString();
+            return false;
+        }
+        m_size = offset;
+        return remap();
+    }
+    return true;
+}
+
+void EthBlockStore::indexNumber(int64_t number, const EHash32 &hash)
+{
+    //The last stored block of a number wins, it is the one of the canonical chain after a reorganization
+    m_numbers.insert(number, hash);
+    m_head = qMax(m_head, number);
+}
+
+bool EthBlockStore::readNumber(const char *payload, quint32 length, int64_t &number)
+{
+    JsonReader reader(payload, payload + length);
+    if(!reader.beginObject())
+        return false;
+    const char* key = 0;
+    int size = 0;
+    while(reader.nextKey(key, size))
+    {
+        if(size == 6 && memcmp(key, "number", 6) == 0)
+        {
+            const char* data = 0;
+            int dataSize = 0;
+            return reader.readRawString(data, dataSize) && hex2int(data, dataSize, number);
+        }
+        if(!reader.skipValue())
+            return false;
+    }
+    return false;
+}
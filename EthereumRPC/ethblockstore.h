@@ -0,0 +1,131 @@
+#ifndef ETHBLOCKSTORE_H
+#define ETHBLOCKSTORE_H
+
+#include <QFile>
+#include <QHash>
+#include <QMutex>
+#include <QVariantList>
+#include "ethrpc_global.h"
+#include "ethobject.h"
+
+class JsonRPCMethod;
+
+/**
+ * @brief The EthBlockStore class keep the blocks, the mined transactions and the receipts in an append only file.
+ * Every record hold its type, its hash, the length and the checksum of its compact JSON.
+ * The file is memory mapped for the reads and the index from hash to offset is rebuilt when the store is opened,
+ * a torn record at the end of the file, from a crash while writing, is truncated.
+ * The blocks deep enough under the head to be final are also indexed by number.
+ */
+class ETHRPCSHARED_EXPORT EthBlockStore
+{
+public:
+    enum RecordType
+    {
+        Block = 1,
+        BlockWithTransactions = 2,
+        Transaction = 3,
+        Receipt = 4
+    };
+
+    /**
+     * @brief EthBlockStore Constructor
+     * @param fileName Path of the store file, created when missing.
+     */
+    explicit EthBlockStore(const QString& fileName);
+
+    /**
+     * @brief ~EthBlockStore Destructor
+     */
+    virtual ~EthBlockStore();
+
+    /**
+     * @brief open Open the file and rebuild the index.
+     * @return true if the file can be read and written, otherwise false.
+     */
+    bool open();
+    void close();
+    bool isOpen() const;
+
+    /**
+     * @brief load Decode the stored record into the output.
+     * @return true if the record is stored, otherwise false.
+     */
+    bool load(RecordType type, const EHash32& hash, EValue& out);
+
+    /**
+     * @brief store Append the record, nothing is written when the record is already stored.
+     * @return true if the record is stored, otherwise false.
+     */
+    bool store(RecordType type, const EHash32& hash, const EValue& value);
+
+    bool contains(RecordType type, const EHash32& hash) const;
+    int count() const;
+    QString errorString() const;
+
+    /**
+     * @brief setConfirmations Set the depth under the head from which a stored block is served by number,
+     * the shallower blocks can still be replaced by a reorganization.
+     * @param confirmations Number of blocks, 64 by default.
+     */
+    void setConfirmations(int confirmations);
+    int confirmations() const;
+
+    /**
+     * @brief setHeadBlock Raise the head of the chain, the highest stored block is the head by default.
+     * @param number Number of the head block.
+     */
+    void setHeadBlock(int64_t number);
+    int64_t headBlock() const;
+
+    /**
+     * @brief hashOf Return the hash of the stored block at a number that has the confirmations.
+     * @return false when the block is not stored or not deep enough.
+     */
+    bool hashOf(int64_t number, EHash32& hash) const;
+
+    /**
+     * @brief loadCall Answer the call from the store, eth_getBlockByNumber is answered for a numeric block
+     * that has the confirmations.
+     * @return true if the result is stored, otherwise false.
+     */
+    bool loadCall(const JsonRPCMethod& method, const QVariantList& params, EValue& out);
+
+    /**
+     * @brief storeCall Append the decoded result of the call when it is final.
+     * @return true if the result is stored, otherwise false.
+     */
+    bool storeCall(const JsonRPCMethod& method, const QVariantList& params, EValue& out);
+
+    /**
+     * @brief recordOf Return the record that hold the result of a call.
+     * @return false when the result of the method is not stored.
+     */
+    static bool recordOf(const JsonRPCMethod& method, const QVariantList& params, RecordType& type, EHash32& hash);
+
+    /**
+     * @brief isStorable Return true when the decoded result is final, a pending transaction is not.
+     */
+    static bool isStorable(RecordType type, EValue& out);
+
+private:
+    bool remap();
+    bool scan();
+    void indexNumber(int64_t number, const EHash32& hash);
+    //Return the number of a block record without decoding the whole block
+    static bool readNumber(const char* payload, quint32 length, int64_t& number);
+
+    QString m_fileName;
+    QFile m_file;
+    uchar* m_map;
+    qint64 m_mapSize;
+    qint64 m_size;
+    QHash<EHash32, qint64> m_index[4];
+    QHash<int64_t, EHash32> m_numbers;
+    int m_confirmations;
+    int64_t m_head;
+    QString m_error;
+    mutable QMutex m_mutex;
+};
+
+#endif // ETHBLOCKSTORE_H
@@ -0,0 +1,176 @@
+#include "ethbloom.h"
+#include "keccak.h"
+#include <QVarLengthArray>
+
+//The value is contained when its 3 bits are set in the bloom
+static inline uchar containsBits(const uchar* bloom, const quint16* bits)
+{
+    return (bloom[bits[0] >> 3] >> (bits[0] & 7)) &
+           (bloom[bits[1] >> 3] >> (bits[1] & 7)) &
+           (bloom[bits[2] >> 3] >> (bits[2] & 7)) & 1;
+}
+
+EthBloomQuery::EthBloomQuery()
+{}
+
+void EthBloomQuery::addCondition(const QByteArrayList &values)
+{
+    int offset = m_bits.size();
+    m_bits.resize(offset + values.count() * ValueBits);
+    for(int i = 0; i < values.count(); i++)
+    {
+        bloomBits(values[i], m_bits.data() + offset + i * ValueBits);
+    }
+    m_conditionEnds.append(m_bits.size() / ValueBits);
+}
+
+void EthBloomQuery::addAddresses(const QByteArrayList &addresses)
+{
+    addCondition(addresses);
+}
+
+void EthBloomQuery::addTopics(const QByteArrayList &topics)
+{
+    addCondition(topics);
+}
+
+bool EthBloomQuery::isEmpty() const
+{
+    return m_conditionEnds.isEmpty();
+}
+
+void EthBloomQuery::clear()
+{
+    m_bits.clear();
+    m_conditionEnds.clear();
+}
+
+bool EthBloomQuery::mayMatch(const EBloom256 &bloom) const
+{
+    if(bloom.isNull())
+        return true;
+    return mayMatch(bloom.data());
+}
+
+bool EthBloomQuery::mayMatch(const uchar *bloom) const
+{
+    const quint16* bits = m_bits.constData();
+    int value = 0;
+    for(int i = 0; i < m_conditionEnds.count(); i++)
+    {
+        int end = m_conditionEnds[i];
+        bool any = false;
+        for(; value < end && !any; value++)
+            any = containsBits(bloom, bits + value * ValueBits);
+        if(!any)
+            return false;
+        value = end;
+    }
+    return true;
+}
+
+void EthBloomQuery::addToBloom(const QByteArray &value, uchar *bloom)
+{
+    quint16 bits[ValueBits];
+    bloomBits(value, bits);
+    for(int i = 0; i < ValueBits; i++)
+        bloom[bits[i] >> 3] |= uchar(1 << (bits[i] & 7));
+}
+
+void EthBloomQuery::bloomBits(const QByteArray &value, quint16 *bits)
+{
+    unsigned char hash[Keccak256::HashSize];
+    Keccak256::hash(value.constData(), value.size(), hash);
+    for(int i = 0; i < ValueBits; i++)
+    {
+        //The bit 0 of the bloom is the lowest bit of its last Byte
+        int bit = ((hash[2 * i] << 8) | hash[2 * i + 1]) & 2047;
+        bits[i] = quint16((BloomSize - 1 - bit / 8) * 8 + bit % 8);
+    }
+}
+
+EthBloomQuerySet::EthBloomQuerySet()
+{}
+
+int EthBloomQuerySet::addQuery(const EthBloomQuery &query)
+{
+    const quint16* bits = query.m_bits.constData();
+    int count = query.m_bits.size() / EthBloomQuery::ValueBits;
+    int offset = m_values.size();
+    m_values.resize(offset + count);
+    for(int i = 0; i < count; i++)
+    {
+        const quint16* valueBits = bits + i * EthBloomQuery::ValueBits;
+        quint64 key = (quint64(valueBits[0]) << 32) | (quint64(valueBits[1]) << 16) | valueBits[2];
+        QHash<quint64, int>::const_iterator it = m_valueIndex.constFind(key);
+        int index = 0;
+        if(it != m_valueIndex.constEnd())
+        {
+            index = it.value();
+        }
+        else
+        {
+            index = m_bits.size() / EthBloomQuery::ValueBits;
+            for(int j = 0; j < EthBloomQuery::ValueBits; j++)
+                m_bits.append(valueBits[j]);
+            m_valueIndex.insert(key, index);
+        }
+        m_values[offset + i] = index;
+    }
+    for(int i = 0; i < query.m_conditionEnds.count(); i++)
+        m_conditionEnds.append(offset + query.m_conditionEnds[i]);
+    m_queryEnds.append(m_conditionEnds.size());
+    return m_queryEnds.size() - 1;
+}
+
+int EthBloomQuerySet::count() const
+{
+    return m_queryEnds.size();
+}
+
+void EthBloomQuerySet::clear()
+{
+    m_bits.clear();
+    m_valueIndex.clear();
+    m_values.clear();
+    m_conditionEnds.clear();
+    m_queryEnds.clear();
+}
+
+void EthBloomQuerySet::mayMatch(const EBloom256 &bloom, QVector<bool> &matches) const
+{
+    if(bloom.isNull())
+    {
+        matches.fill(true, m_queryEnds.size());
+        return;
+    }
+    mayMatch(bloom.data(), matches);
+}
+
+void EthBloomQuerySet::mayMatch(const uchar *bloom, QVector<bool> &matches) const
+{
+    //Gather the bits of every distinct value without branches
+    int count = m_bits.size() / EthBloomQuery::ValueBits;
+    QVarLengthArray<uchar, 256> contained(count);
+    const quint16* bits = m_bits.constData();
+    for(int i = 0; i < count; i++)
+        contained[i] = containsBits(bloom, bits + i * EthBloomQuery::ValueBits);
+
+    //Reduce the conditions of every query
+    matches.resize(m_queryEnds.size());
+    const int* values = m_values.constData();
+    int condition = 0;
+    int value = 0;
+    for(int i = 0; i < m_queryEnds.size(); i++)
+    {
+        bool match = true;
+        for(; condition < m_queryEnds[i]; condition++)
+        {
+            uchar any = 0;
+            for(; value < m_conditionEnds[condition]; value++)
+                any |= contained[values[value]];
+            match &= any != 0;
+        }
+        matches[i] = match;
+    }
+}
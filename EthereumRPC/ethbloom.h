@@ -0,0 +1,101 @@
+#ifndef ETHBLOOM_H
+#define ETHBLOOM_H
+
+#include <QVector>
+#include <QHash>
+#include <QByteArrayList>
+#include "ethrpc_global.h"
+#include "ethobject.h"
+
+/**
+ * @brief The EthBloomQuery class test addresses and topics against the 2048 bits logs bloom of the blocks.
+ * The query is a list of conditions that must all match, every condition is matched by any of its values.
+ * A value set the 3 bits of the bloom given by the first 6 Bytes of its Keccak-256 hash,
+ * the query keep only the positions of these bits.
+ */
+class ETHRPCSHARED_EXPORT EthBloomQuery
+{
+public:
+    enum
+    {
+        BloomSize = 256,
+        //Bits of the bloom set by a value
+        ValueBits = 3
+    };
+
+    EthBloomQuery();
+
+    /**
+     * @brief addCondition Add a condition matched by any of the values.
+     * A condition without values never match, so a wildcard topic position of eth_getLogs
+     * is not a condition and must not be added.
+     * @param values Addresses of 20 Bytes or topics of 32 Bytes, binary.
+     */
+    void addCondition(const QByteArrayList& values);
+    void addAddresses(const QByteArrayList& addresses);
+    void addTopics(const QByteArrayList& topics);
+
+    //An empty query match every bloom
+    bool isEmpty() const;
+    void clear();
+
+    /**
+     * @brief mayMatch Test the logs bloom of a block.
+     * @return false when no log of the block can match, true when a log may match or the bloom is null.
+     */
+    bool mayMatch(const EBloom256& bloom) const;
+    bool mayMatch(const uchar* bloom) const;
+
+    //Set the bits of the value in the bloom
+    static void addToBloom(const QByteArray& value, uchar* bloom);
+    //Positions of the bits of the value, Byte index in the bloom * 8 + bit index in the Byte
+    static void bloomBits(const QByteArray& value, quint16* bits);
+
+private:
+    friend class EthBloomQuerySet;
+
+    //Bits of every value, the values of the conditions are contiguous
+    QVector<quint16> m_bits;
+    //Index of the first value after every condition
+    QVector<int> m_conditionEnds;
+};
+
+/**
+ * @brief The EthBloomQuerySet class test a bloom against many queries at once.
+ * The values shared by several queries are stored once, every bloom is tested in two passes:
+ * the bits of all the distinct values are gathered from the bloom, then the conditions of the queries are reduced.
+ */
+class ETHRPCSHARED_EXPORT EthBloomQuerySet
+{
+public:
+    EthBloomQuerySet();
+
+    /**
+     * @brief addQuery Add a query to the set.
+     * @return Index of the query in the matches.
+     */
+    int addQuery(const EthBloomQuery& query);
+    int count() const;
+    void clear();
+
+    /**
+     * @brief mayMatch Test the logs bloom of a block against every query.
+     * @param matches Result of every query, in the order of the queries, true for every query when the bloom is null.
+     */
+    void mayMatch(const EBloom256& bloom, QVector<bool>& matches) const;
+    void mayMatch(const uchar* bloom, QVector<bool>& matches) const;
+
+private:
+    //Bits of the distinct values
+    QVector<quint16> m_bits;
+    //Index of the distinct value by its packed bits
+    QHash<quint64, int> m_valueIndex;
+    //Distinct value of every value of the queries, the values of the conditions are contiguous
+    QVector<int> m_values;
+    //Index of the first value after every condition
+    QVector<int> m_conditionEnds;
+    //Index of the first condition after every query
+    QVector<int> m_queryEnds;
+};
+
+#endif // ETHBLOOM_H
@@ -0,0 +1,454 @@
+#include "ethfiltermanager.h"
+#include "ethrpc.h"
+
+namespace FilterManager_NS {
+const int TICK_MSECS = 250;
+const int MAX_INTERVAL = 8;
+//Blocks of one eth_getLogs of a backfill, the providers cap the range of the logs queries
+const int BACKFILL_BLOCKS = 2000;
+}
+using namespace FilterManager_NS;
+
+//Drop the logs that were delivered by the backfill of a reinstalled filter, the removed logs are kept
+static ELogList dropBackfilled(const ELogList& logs, int64_t backfilledBlock)
+{
+    QVector<ELog> kept;
+    kept.reserve(logs.count());
+    for(int i = 0; i < logs.count(); i++)
+    {
+        const ELog& log = logs[i];
+        if(log.removed || log.blockNumber.isNull() || int64_t(log.blockNumber) > backfilledBlock)
+            kept.append(log);
+    }
+    return ELogList(kept);
+}
+
+EthFilterManager::EthFilterManager(EthRPC *rpc, QObject *parent) :
+    QObject(parent),
+    m_rpc(rpc),
+    m_maxInterval(MAX_INTERVAL),
+    m_nextHandle(1),
+    m_blockFilterInstalled(false),
+    m_requests(0)
+{
+    m_timer.setInterval(TICK_MSECS);
+    connect(&m_timer, SIGNAL(timeout()), this, SLOT(onTimeout()));
+}
+
+EthFilterManager::~EthFilterManager()
+{
+    //Uninstall every filter in one batch
+    m_rpc->beginBatch();
+    QVector<EBool> uninstalled(m_filters.count() + 1);
+    int index = 0;
+    for(QMap<int, ManagedFilter>::const_iterator it = m_filters.constBegin(); it != m_filters.constEnd(); ++it)
+    {
+        if(it.value().installed)
+            m_rpc->eth_uninstallFilter(it.value().id, uninstalled[index++]);
+    }
+    if(m_blockFilterInstalled)
+        m_rpc->eth_uninstallFilter(m_blockFilterId, uninstalled[index++]);
+    if(index)
+        m_rpc->sendBatch();
+    else
+        m_rpc->cancelBatch();
+}
+
+int EthFilterManager::addLogFilter(const EFilter &filter, const LogHandler &handler)
+{
+    ManagedFilter managed;
+    managed.kind = Logs;
+    managed.filter = filter;
+    managed.logHandler = handler;
+    managed.installed = false;
+    managed.reinstalled = false;
+    managed.rejected = false;
+    managed.interval = 1;
+    managed.countdown = 0;
+    managed.lastBlock = -1;
+    managed.backfilledBlock = -1;
+    int handle = m_nextHandle++;
+    m_filters.insert(handle, managed);
+    return handle;
+}
+
+int EthFilterManager::addBlockFilter(const HashHandler &handler)
+{
+    int handle = m_nextHandle++;
+    m_blockHandlers.insert(handle, handler);
+    return handle;
+}
+
+int EthFilterManager::addPendingTransactionFilter(const HashHandler &handler)
+{
+    ManagedFilter managed;
+    managed.kind = PendingTransactions;
+    managed.hashHandler = handler;
+    managed.installed = false;
+    managed.reinstalled = false;
+    managed.rejected = false;
+    managed.interval = 1;
+    managed.countdown = 0;
+    managed.lastBlock = -1;
+    managed.backfilledBlock = -1;
+    int handle = m_nextHandle++;
+    m_filters.insert(handle, managed);
+    return handle;
+}
+
+void EthFilterManager::removeFilter(int handle)
+{
+    m_blockHandlers.remove(handle);
+    ManagedFilter filter = m_filters.take(handle);
+    if(filter.installed)
+        uninstall(filter.id);
+
+    //The block filter is kept while it is needed by the block handlers or the log filters
+    bool needBlocks = !m_blockHandlers.isEmpty();
+    for(QMap<int, ManagedFilter>::const_iterator it = m_filters.constBegin(); !needBlocks && it != m_filters.constEnd(); ++it)
+        needBlocks = it.value().kind == Logs;
+    if(!needBlocks && m_blockFilterInstalled)
+    {
+        uninstall(m_blockFilterId);
+        m_blockFilterInstalled = false;
+    }
+}
+
+void EthFilterManager::setTickInterval(int msecs)
+{
+    m_timer.setInterval(msecs);
+}
+
+int EthFilterManager::tickInterval() const
+{
+    return m_timer.interval();
+}
+
+void EthFilterManager::setMaxInterval(int ticks)
+{
+    m_maxInterval = qMax(1, ticks);
+}
+
+int EthFilterManager::maxInterval() const
+{
+    return m_maxInterval;
+}
+
+bool EthFilterManager::poll()
+{
+    if(!installFilters())
+    {
+        emit pollFailed();
+        return false;
+    }
+
+    //The block number, the block filter and the due pending transaction filters go in the first batch
+    QList<int> pendingDue;
+    for(QMap<int, ManagedFilter>::iterator it = m_filters.begin(); it != m_filters.end(); ++it)
+    {
+        ManagedFilter& filter = it.value();
+        if(filter.kind == PendingTransactions && filter.installed && --filter.countdown <= 0)
+            pendingDue.append(it.key());
+    }
+
+    EByteArrayList newBlocks;
+    EInt blockNumber;
+    QVector<EByteArrayList> hashes(pendingDue.count());
+    QVector<bool> results;
+    bool pollBlocks = m_blockFilterInstalled;
+    m_rpc->beginBatch();
+    //When the block number fails the node can not be reached, otherwise a failed call is a dropped filter
+    m_rpc->eth_blockNumber(blockNumber);
+    if(pollBlocks)
+        m_rpc->eth_getFilterChanges(m_blockFilterId, newBlocks);
+    for(int i = 0; i < pendingDue.count(); i++)
+        m_rpc->eth_getFilterChanges(m_filters[pendingDue[i]].id, hashes[i]);
+    m_requests++;
+    m_rpc->sendBatch(&results);
+    if(!results[0])
+    {
+        emit pollFailed();
+        return false;
+    }
+    int index = 1;
+
+    int blockCount = 0;
+    if(pollBlocks)
+    {
+        if(results[index++])
+        {
+            QByteArrayList blocks = newBlocks;
+            blockCount = blocks.count();
+            QMap<int, HashHandler> handlers = m_blockHandlers;
+            for(QMap<int, HashHandler>::const_iterator it = handlers.constBegin(); blockCount && it != handlers.constEnd(); ++it)
+            {
+                if(m_blockHandlers.contains(it.key()))
+                    it.value()(blocks);
+            }
+        }
+        else
+        {
+            //Dropped by the node, the blocks until it is installed again are missed
+            m_blockFilterInstalled = false;
+        }
+    }
+
+    for(int i = 0; i < pendingDue.count(); i++)
+    {
+        QMap<int, ManagedFilter>::iterator it = m_filters.find(pendingDue[i]);
+        if(it == m_filters.end())
+            continue;
+        if(!results[index + i])
+        {
+            it.value().installed = false;
+            it.value().reinstalled = true;
+            continue;
+        }
+        QByteArrayList changes = hashes[i];
+        adapt(it.value(), !changes.isEmpty());
+        HashHandler handler = it.value().hashHandler;
+        if(!changes.isEmpty())
+            handler(changes);
+    }
+
+    //The logs change only with the blocks, without block filter they are polled on their interval in ticks
+    QList<int> logsDue;
+    for(QMap<int, ManagedFilter>::iterator it = m_filters.begin(); it != m_filters.end(); ++it)
+    {
+        ManagedFilter& filter = it.value();
+        if(filter.kind != Logs || !filter.installed)
+            continue;
+        filter.countdown -= m_blockFilterInstalled ? blockCount : 1;
+        if(filter.countdown <= 0)
+            logsDue.append(it.key());
+    }
+    pollFilters(logsDue);
+    return true;
+}
+
+void EthFilterManager::start()
+{
+    m_timer.start();
+}
+
+void EthFilterManager::stop()
+{
+    m_timer.stop();
+}
+
+qint64 EthFilterManager::requestCount() const
+{
+    return m_requests;
+}
+
+void EthFilterManager::onTimeout()
+{
+    poll();
+}
+
+bool EthFilterManager::installFilters()
+{
+    QList<int> handles;
+    for(QMap<int, ManagedFilter>::const_iterator it = m_filters.constBegin(); it != m_filters.constEnd(); ++it)
+    {
+        if(!it.value().installed && !it.value().rejected)
+            handles.append(it.key());
+    }
+    bool needBlocks = !m_blockHandlers.isEmpty();
+    for(QMap<int, ManagedFilter>::const_iterator it = m_filters.constBegin(); !needBlocks && it != m_filters.constEnd(); ++it)
+        needBlocks = it.value().kind == Logs;
+    bool installBlocks = needBlocks && !m_blockFilterInstalled;
+    if(handles.isEmpty() && !installBlocks)
+        return true;
+
+    QVector<EInt> ids(handles.count());
+    EInt blockFilterId;
+    EInt blockNumber;
+    QVector<bool> results;
+    m_rpc->beginBatch();
+    if(installBlocks)
+        m_rpc->eth_newBlockFilter(blockFilterId);
+    for(int i = 0; i < handles.count(); i++)
+    {
+        const ManagedFilter& filter = m_filters[handles[i]];
+        if(filter.kind == Logs)
+            m_rpc->eth_newFilter(filter.filter, ids[i]);
+        else
+            m_rpc->eth_newPendingTransactionFilter(ids[i]);
+    }
+    //Asked after the filters are created, their changes start at most at this block.
+    //When it fails the node can not be reached, otherwise a failed call is a rejected filter
+    m_rpc->eth_blockNumber(blockNumber);
+    m_requests++;
+    m_rpc->sendBatch(&results);
+    if(!results.last())
+        return false;
+    int64_t head = blockNumber;
+
+    int index = 0;
+    if(installBlocks && results[index++])
+    {
+        m_blockFilterId = blockFilterId;
+        m_blockFilterInstalled = true;
+    }
+
+    //The logs missed while a filter was dropped are fetched from the last delivered block to the head
+    QList<int> backfill;
+    QList<int> rejected;
+    for(int i = 0; i < handles.count(); i++)
+    {
+        ManagedFilter& filter = m_filters[handles[i]];
+        if(!results[index + i])
+        {
+            filter.rejected = true;
+            rejected.append(handles[i]);
+            continue;
+        }
+        filter.id = ids[i];
+        filter.installed = true;
+        filter.interval = 1;
+        filter.countdown = 1;
+        if(filter.kind != Logs)
+            continue;
+        if(filter.reinstalled && filter.lastBlock >= 0 && filter.lastBlock < head)
+            backfill.append(handles[i]);
+        else
+            filter.lastBlock = qMax(filter.lastBlock, head);
+    }
+
+    //The ranges of the backfills are fetched in steps of BACKFILL_BLOCKS, one batch per step
+    while(!backfill.isEmpty())
+    {
+        QList<int> step;
+        for(int i = 0; i < backfill.count(); i++)
+        {
+            //A handler may have removed its filter
+            if(m_filters.contains(backfill[i]))
+                step.append(backfill[i]);
+        }
+        backfill.clear();
+        if(step.isEmpty())
+            break;
+
+        QVector<ELogList> logs(step.count());
+        QVector<int64_t> toBlocks(step.count());
+        QVector<bool> logResults;
+        m_rpc->beginBatch();
+        for(int i = 0; i < step.count(); i++)
+        {
+            const ManagedFilter& managed = m_filters[step[i]];
+            EFilter filter = managed.filter;
+            toBlocks[i] = qMin(managed.lastBlock + BACKFILL_BLOCKS, head);
+            filter.fromBlock = EVariant(EInt(managed.lastBlock + 1).toRawData());
+            filter.toBlock = EVariant(EInt(toBlocks[i]).toRawData());
+            m_rpc->eth_getLogs(filter, logs[i]);
+        }
+        m_requests++;
+        m_rpc->sendBatch(&logResults);
+        for(int i = 0; i < step.count(); i++)
+        {
+            QMap<int, ManagedFilter>::iterator it = m_filters.find(step[i]);
+            if(it == m_filters.end())
+                continue;
+            ManagedFilter& filter = it.value();
+            if(!logResults[i])
+            {
+                //Installed again at the next tick, the backfill resume after the last fetched step
+                uninstall(filter.id);
+                filter.installed = false;
+                continue;
+            }
+            filter.lastBlock = toBlocks[i];
+            if(filter.lastBlock < head)
+                backfill.append(step[i]);
+            else
+            {
+                //The first changes of the filter may repeat the blocks up to the head
+                filter.backfilledBlock = head;
+            }
+            LogHandler handler = filter.logHandler;
+            if(logs[i].count())
+                handler(logs[i]);
+        }
+    }
+
+    for(int i = 0; i < handles.count(); i++)
+    {
+        QMap<int, ManagedFilter>::iterator it = m_filters.find(handles[i]);
+        if(it != m_filters.end() && it.value().installed && it.value().reinstalled)
+        {
+            it.value().reinstalled = false;
+            emit filterReinstalled(handles[i]);
+        }
+    }
+    for(int i = 0; i < rejected.count(); i++)
+    {
+        if(m_filters.contains(rejected[i]))
+            emit filterRejected(rejected[i]);
+    }
+    return true;
+}
+
+void EthFilterManager::pollFilters(const QList<int> &handles)
+{
+    if(handles.isEmpty())
+        return;
+
+    QVector<ELogList> logs(handles.count());
+    EInt blockNumber;
+    QVector<bool> results;
+    m_rpc->beginBatch();
+    m_rpc->eth_blockNumber(blockNumber);
+    for(int i = 0; i < handles.count(); i++)
+        m_rpc->eth_getFilterChanges(m_filters[handles[i]].id, logs[i]);
+    m_requests++;
+    m_rpc->sendBatch(&results);
+    if(!results[0])
+    {
+        emit pollFailed();
+        return;
+    }
+
+    for(int i = 0; i < handles.count(); i++)
+    {
+        QMap<int, ManagedFilter>::iterator it = m_filters.find(handles[i]);
+        if(it == m_filters.end())
+            continue;
+        ManagedFilter& filter = it.value();
+        if(!results[i + 1])
+        {
+            filter.installed = false;
+            filter.reinstalled = true;
+            continue;
+        }
+
+        ELogList changes = filter.backfilledBlock >= 0 ? dropBackfilled(logs[i], filter.backfilledBlock) : logs[i];
+        filter.backfilledBlock = -1;
+        //The block number is asked before the changes, every log up to it is delivered,
+        //so a quiet filter is not backfilled from the block of its install
+        filter.lastBlock = qMax(filter.lastBlock, int64_t(blockNumber));
+        for(int j = 0; j < changes.count(); j++)
+        {
+            const ELog& log = changes[j];
+            if(!log.removed && !log.blockNumber.isNull())
+                filter.lastBlock = qMax(filter.lastBlock, int64_t(log.blockNumber));
+        }
+        adapt(filter, changes.count() > 0);
+        LogHandler handler = filter.logHandler;
+        if(changes.count())
+            handler(changes);
+    }
+}
+
+void EthFilterManager::adapt(ManagedFilter &filter, bool changed)
+{
+    //The interval is reset by a change and doubled by an empty poll
+    filter.interval = changed ? 1 : qMin(filter.interval * 2, m_maxInterval);
+    filter.countdown = filter.interval;
+}
+
+void EthFilterManager::uninstall(const EInt &id)
+{
+    EBool uninstalled;
+    m_rpc->eth_uninstallFilter(id, uninstalled);
+}
@@ -0,0 +1,148 @@
+#ifndef ETHFILTERMANAGER_H
+#define ETHFILTERMANAGER_H
+
+#include <QObject>
+#include <QMap>
+#include <QTimer>
+#include <QByteArrayList>
+#include <functional>
+#include "ethrpc_global.h"
+#include "ethobject.h"
+
+class EthRPC;
+
+/**
+ * @brief The EthFilterManager class own the filters installed in the node and poll their changes.
+ * Every tick polls one block filter and the due pending transaction filters in one JSON RPC batch,
+ * the log filters are polled in a second batch only when a new block arrived, the logs change with the blocks.
+ * The interval of every filter grows while its polls are empty and is reset by a change.
+ * The filters dropped by the node are installed again, the logs of the missed blocks are fetched with eth_getLogs.
+ * Every batch ask the block number, so a node that can not be reached is told apart from a dropped filter.
+ */
+class ETHRPCSHARED_EXPORT EthFilterManager : public QObject
+{
+    Q_OBJECT
+public:
+    //Called with the changes of a filter, never with empty changes
+    typedef std::function<void(const ELogList& logs)> LogHandler;
+    typedef std::function<void(const QByteArrayList& hashes)> HashHandler;
+
+    /**
+     * @brief EthFilterManager Constructor
+     * @param rpc Connected RPC used to poll, it must stay alive while the manager is used.
+     */
+    explicit EthFilterManager(EthRPC* rpc, QObject *parent = 0);
+
+    /**
+     * @brief ~EthFilterManager Destructor, the filters are uninstalled
+     */
+    ~EthFilterManager();
+
+    /**
+     * @brief addLogFilter Add a filter of logs, installed at the next poll.
+     * @param filter The filter options, the logs from the block of the first poll are delivered.
+     * @param handler Handler of the new logs.
+     * @return Handle of the filter, for removeFilter.
+     */
+    int addLogFilter(const EFilter& filter, const LogHandler& handler);
+
+    /**
+     * @brief addBlockFilter Add a handler of the hashes of the new blocks, all of them share one filter in the node.
+     * @return Handle of the filter, for removeFilter.
+     */
+    int addBlockFilter(const HashHandler& handler);
+
+    /**
+     * @brief addPendingTransactionFilter Add a filter of the hashes of the new pending transactions.
+     * @return Handle of the filter, for removeFilter.
+     */
+    int addPendingTransactionFilter(const HashHandler& handler);
+
+    /**
+     * @brief removeFilter Remove a filter and uninstall it from the node, can be called from a handler.
+     */
+    void removeFilter(int handle);
+
+    /**
+     * @brief setTickInterval Set the interval between two ticks.
+     * @param msecs Interval, 250 by default.
+     */
+    void setTickInterval(int msecs);
+    int tickInterval() const;
+
+    /**
+     * @brief setMaxInterval Set the maximum interval of the filters that do not change.
+     * @param ticks Maximum ticks between two polls of a pending transaction filter
+     * and maximum blocks between two polls of a log filter, 8 by default.
+     */
+    void setMaxInterval(int ticks);
+    int maxInterval() const;
+
+    /**
+     * @brief poll Run one tick, called by the timer.
+     * @return false if the node could not be reached.
+     */
+    bool poll();
+
+    void start();
+    void stop();
+
+    /**
+     * @brief requestCount Return the number of JSON RPC requests sent, a batch count as one.
+     */
+    qint64 requestCount() const;
+
+signals:
+    //The filter was dropped by the node and installed again
+    void filterReinstalled(int handle);
+    //The node refused to install the filter, for example for invalid options, it is not polled
+    void filterRejected(int handle);
+    void pollFailed();
+
+private slots:
+    void onTimeout();
+
+private:
+    enum Kind
+    {
+        Logs,
+        PendingTransactions
+    };
+
+    struct ManagedFilter
+    {
+        Kind kind;
+        EFilter filter;
+        LogHandler logHandler;
+        HashHandler hashHandler;
+        EInt id;
+        bool installed;
+        bool reinstalled;
+        bool rejected;
+        //Adaptive interval, in blocks for the logs and in ticks for the pending transactions
+        int interval;
+        int countdown;
+        //Last block whose logs were delivered, the start of the logs fetched after a reinstall
+        int64_t lastBlock;
+        //After a reinstall, last block of the logs fetched with eth_getLogs, they are dropped from the next changes
+        int64_t backfilledBlock;
+    };
+
+    //Install the filters dropped or not yet installed, false when the node could not be reached
+    bool installFilters();
+    void pollFilters(const QList<int>& handles);
+    void adapt(ManagedFilter& filter, bool changed);
+    void uninstall(const EInt& id);
+
+    EthRPC* m_rpc;
+    QTimer m_timer;
+    int m_maxInterval;
+    int m_nextHandle;
+    QMap<int, ManagedFilter> m_filters;
+    QMap<int, HashHandler> m_blockHandlers;
+    EInt m_blockFilterId;
+    bool m_blockFilterInstalled;
+    qint64 m_requests;
+};
+
+#endif // ETHFILTERMANAGER_H
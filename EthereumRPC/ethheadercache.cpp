@@ -0,0 +1,158 @@
+#include "ethheadercache.h"
+#include "ethrpc.h"
+
+EthHeaderCache::EthHeaderCache(EthRPC *rpc, int depth, QObject *parent) :
+    QObject(parent),
+    m_rpc(rpc),
+    m_depth(qMax(1, depth))
+{
+    connect(&m_timer, SIGNAL(timeout()), this, SLOT(onPollTimeout()));
+}
+
+bool EthHeaderCache::update()
+{
+    EBlock head;
+    if(!m_rpc->eth_getBlockByNumber(EVariant(QString("latest")), false, head) || head.isNull())
+        return false;
+
+    int64_t latestNumber = head.number;
+    int64_t oldHead = headNumber();
+    if(m_byHash.value(head.hash, -1) == latestNumber)
+        return true;
+
+    //A gap larger than the depth restart the cache
+    if(!m_byNumber.isEmpty() && latestNumber - oldHead > m_depth)
+        clear();
+
+    //Follow the parents back to the cached chain
+    QList<EBlock> chain;
+    chain.append(head);
+    bool linked = m_byNumber.isEmpty();
+    while(!linked && chain.count() <= m_depth)
+    {
+        EBlock& first = chain.first();
+        int64_t parentNumber = int64_t(first.number) - 1;
+        if(parentNumber < m_byNumber.firstKey())
+            break;
+        QMap<int64_t, EBlock>::const_iterator it = m_byNumber.constFind(parentNumber);
+        if(it != m_byNumber.constEnd() && it.value().hash == first.parentHash)
+        {
+            linked = true;
+            break;
+        }
+
+        EBlock parent;
+        if(!fetchParent(first, parent))
+            return false;
+        chain.prepend(parent);
+    }
+
+    //The cached blocks from the first new block diverged from the chain
+    int64_t firstNew = chain.first().number;
+    bool replaced = !m_byNumber.isEmpty() && m_byNumber.lastKey() >= firstNew;
+    int64_t forkNumber = firstNew;
+    if(!linked)
+    {
+        if(!m_byNumber.isEmpty())
+            forkNumber = qMin(forkNumber, m_byNumber.firstKey());
+        clear();
+    }
+    else
+    {
+        while(!m_byNumber.isEmpty() && m_byNumber.lastKey() >= firstNew)
+        {
+            m_byHash.remove(m_byNumber.last().hash);
+            m_byNumber.remove(m_byNumber.lastKey());
+        }
+    }
+
+    for(int i = 0; i < chain.count(); i++)
+    {
+        int64_t number = chain[i].number;
+        m_byNumber.insert(number, chain[i]);
+        m_byHash.insert(chain[i].hash, number);
+    }
+    trim();
+
+    if(replaced)
+        emit reorg(forkNumber, oldHead, latestNumber);
+    emit newHead(latestNumber);
+    return true;
+}
+
+void EthHeaderCache::startPolling(int msecs)
+{
+    m_timer.start(msecs);
+}
+
+void EthHeaderCache::stopPolling()
+{
+    m_timer.stop();
+}
+
+bool EthHeaderCache::latest(EBlock &block) const
+{
+    if(m_byNumber.isEmpty())
+        return false;
+    block = m_byNumber.last();
+    return true;
+}
+
+bool EthHeaderCache::blockByNumber(int64_t number, EBlock &block) const
+{
+    QMap<int64_t, EBlock>::const_iterator it = m_byNumber.constFind(number);
+    if(it == m_byNumber.constEnd())
+        return false;
+    block = it.value();
+    return true;
+}
+
+bool EthHeaderCache::blockByHash(const EHash32 &hash, EBlock &block) const
+{
+    QHash<EHash32, int64_t>::const_iterator it = m_byHash.constFind(hash);
+    if(it == m_byHash.constEnd())
+        return false;
+    return blockByNumber(it.value(), block);
+}
+
+int64_t EthHeaderCache::headNumber() const
+{
+    return m_byNumber.isEmpty() ? -1 : m_byNumber.lastKey();
+}
+
+int EthHeaderCache::count() const
+{
+    return m_byNumber.count();
+}
+
+int EthHeaderCache::depth() const
+{
+    return m_depth;
+}
+
+void EthHeaderCache::clear()
+{
+    m_byNumber.clear();
+    m_byHash.clear();
+}
+
+void EthHeaderCache::onPollTimeout()
+{
+    if(!update())
+        emit updateFailed();
+}
+
+bool EthHeaderCache::fetchParent(const EBlock &block, EBlock &parent)
+{
+    EByteArray parentHash = block.parentHash;
+    return m_rpc->eth_getBlockByHash(parentHash, false, parent) && !parent.isNull();
+}
+
+void EthHeaderCache::trim()
+{
+    while(m_byNumber.count() > m_depth)
+    {
+        m_byHash.remove(m_byNumber.first().hash);
+        m_byNumber.remove(m_byNumber.firstKey());
+    }
+}
@@ -0,0 +1,75 @@
+#ifndef ETHHEADERCACHE_H
+#define ETHHEADERCACHE_H
+
+#include <QObject>
+#include <QMap>
+#include <QHash>
+#include <QTimer>
+#include "ethrpc_global.h"
+#include "ethobject.h"
+
+class EthRPC;
+
+/**
+ * @brief The EthHeaderCache class keep the last blocks of the canonical chain, indexed by number and hash.
+ * Every update fetch the latest block and follow the parent hashes back to the cached chain,
+ * so after a reorganization only the blocks that diverged are fetched again.
+ */
+class ETHRPCSHARED_EXPORT EthHeaderCache : public QObject
+{
+    Q_OBJECT
+public:
+    /**
+     * @brief EthHeaderCache Constructor
+     * @param rpc Connected RPC used to fetch the blocks, it must stay alive while the cache is used.
+     * @param depth Number of blocks kept below the head.
+     */
+    explicit EthHeaderCache(EthRPC* rpc, int depth = 128, QObject *parent = 0);
+
+    /**
+     * @brief update Fetch the latest block and update the cached chain.
+     * @return false if a RPC failed, the cache is left unchanged.
+     */
+    bool update();
+
+    /**
+     * @brief startPolling Call update periodically.
+     * @param msecs Interval between the updates.
+     */
+    void startPolling(int msecs);
+    void stopPolling();
+
+    /**
+     * @brief latest Return the head of the chain as of the last update.
+     * @return false when the cache is empty.
+     */
+    bool latest(EBlock& block) const;
+    bool blockByNumber(int64_t number, EBlock& block) const;
+    bool blockByHash(const EHash32& hash, EBlock& block) const;
+
+    int64_t headNumber() const;
+    int count() const;
+    int depth() const;
+    void clear();
+
+signals:
+    void newHead(qint64 number);
+    //The cached blocks from forkNumber were replaced by the ones of another chain
+    void reorg(qint64 forkNumber, qint64 oldHead, qint64 newHead);
+    void updateFailed();
+
+private slots:
+    void onPollTimeout();
+
+private:
+    bool fetchParent(const EBlock& block, EBlock& parent);
+    void trim();
+
+    EthRPC* m_rpc;
+    int m_depth;
+    QMap<int64_t, EBlock> m_byNumber;
+    QHash<EHash32, int64_t> m_byHash;
+    QTimer m_timer;
+};
+
+#endif // ETHHEADERCACHE_H
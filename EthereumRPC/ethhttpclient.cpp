@@ -0,0 +1,715 @@
+#include "ethhttpclient.h"
+#include <QElapsedTimer>
+#ifndef QT_NO_SSL
+#include <QSslSocket>
+#endif
+
+namespace EthHttpClient_NS
+{
+    const int MSECS = 2000;
+    const int TIMEOUT_MSECS = 30000;
+    const int MAX_CONNECTIONS = 8;
+}
+using namespace EthHttpClient_NS;
+
+EthHttpConnection::EthHttpConnection(const QUrl &url, QObject *parent) : QObject(parent),
+    m_socket(0),
+    m_url(url),
+    m_state(Done),
+    m_contentLength(-1),
+    m_chunkSize(0),
+    m_statusCode(0),
+    m_keepAlive(false),
+    m_received(false),
+    m_requests(0),
+    m_async(false)
+{
+#ifndef QT_NO_SSL
+    if(m_url.scheme().compare("https", Qt::CaseInsensitive) == 0)
+        m_socket = new QSslSocket(this);
+#endif
+    if(!m_socket)
+        m_socket = new QTcpSocket(this);
+    m_socket->setSocketOption(QAbstractSocket::LowDelayOption, 1);
+    m_socket->setSocketOption(QAbstractSocket::KeepAliveOption, 1);
+
+#ifndef QT_NO_SSL
+    if(qobject_cast<QSslSocket*>(m_socket))
+        connect(m_socket, SIGNAL(encrypted()), this, SLOT(onConnected()));
+    else
+#endif
+        connect(m_socket, SIGNAL(connected()), this, SLOT(onConnected()));
+    connect(m_socket, SIGNAL(readyRead()), this, SLOT(onReadyRead()));
+    connect(m_socket, SIGNAL(disconnected()), this, SLOT(onDisconnected()));
+    connect(m_socket, SIGNAL(error(QAbstractSocket::SocketError)),
+            this, SLOT(onError(QAbstractSocket::SocketError)));
+    m_timer.setSingleShot(true);
+    connect(&m_timer, SIGNAL(timeout()), this, SLOT(onTimeout()));
+
+    //The header is the same for every request, only the content length change
+    QByteArray path = m_url.path(QUrl::FullyEncoded).toLatin1();
+    if(path.isEmpty()) path = "/";
+    if(m_url.hasQuery()) path += "?" + m_url.query(QUrl::FullyEncoded).toLatin1();
+    m_requestHeader = "POST " + path + " HTTP/1.1\r\n";
+    //The IPv6 addresses keep their brackets in the host header
+    QByteArray host = m_url.host(QUrl::FullyEncoded).toLatin1();
+    if(host.contains(':')) host = "[" + host + "]";
+    m_requestHeader += "Host: " + host;
+    if(m_url.port() != -1) m_requestHeader += ":" + QByteArray::number(m_url.port());
+    m_requestHeader += "\r\n";
+    if(!m_url.userName().isEmpty())
+    {
+        QByteArray credentials = m_url.userName().toUtf8() + ":" + m_url.password().toUtf8();
+        m_requestHeader += "Authorization: Basic " + credentials.toBase64() + "\r\n";
+    }
+    m_requestHeader += "Connection: keep-alive\r\n";
+    m_requestHeader += "Content-Type: application/json\r\n";
+    m_requestHeader += "Accept: application/json\r\n";
+    m_requestHeader += "Content-Length: ";
+}
+
+EthHttpConnection::~EthHttpConnection()
+{
+    m_async = false;
+    close();
+}
+
+bool EthHttpConnection::open(int msecs)
+{
+    bool ssl = m_url.scheme().compare("https", Qt::CaseInsensitive) == 0;
+    int port = m_url.port(ssl ? 443 : 80);
+#ifndef QT_NO_SSL
+    if(ssl)
+    {
+        QSslSocket* socket = static_cast<QSslSocket*>(m_socket);
+        socket->connectToHostEncrypted(m_url.host(), port);
+        if(!socket->waitForEncrypted(msecs))
+        {
+            m_error = socket->errorString();
+            return false;
+        }
+        return true;
+    }
+#endif
+    m_socket->connectToHost(m_url.host(), port);
+    if(!m_socket->waitForConnected(msecs))
+    {
+        m_error = m_socket->errorString();
+        return false;
+    }
+    return true;
+}
+
+void EthHttpConnection::close()
+{
+    m_timer.stop();
+    m_socket->abort();
+    m_buffer.clear();
+    m_state = Done;
+}
+
+bool EthHttpConnection::isOpen() const
+{
+    return m_socket->state() == QAbstractSocket::ConnectedState;
+}
+
+bool EthHttpConnection::isReused() const
+{
+    return m_requests > 1;
+}
+
+bool EthHttpConnection::keepAlive() const
+{
+    return m_keepAlive && m_state == Done && isOpen();
+}
+
+bool EthHttpConnection::writeRequest(const QByteArray &request)
+{
+    m_buffer.clear();
+    m_body.clear();
+    m_state = ReadingHeaders;
+    m_contentLength = -1;
+    m_chunkSize = 0;
+    m_statusCode = 0;
+    m_keepAlive = true;
+    m_received = false;
+    m_requests++;
+
+    QByteArray data;
+    data.reserve(m_requestHeader.size() + 16 + request.size());
+    data += m_requestHeader;
+    data += QByteArray::number(request.size());
+    data += "\r\n\r\n";
+    data += request;
+    if(m_socket->write(data) != data.size())
+    {
+        m_error = m_socket->errorString();
+        return false;
+    }
+    return true;
+}
+
+bool EthHttpConnection::readResponse(QByteArray &response, int msecs)
+{
+    QElapsedTimer timer;
+    timer.start();
+    forever
+    {
+        QByteArray data = m_socket->readAll();
+        if(!data.isEmpty())
+        {
+            m_received = true;
+            m_buffer += data;
+        }
+        if(parseResponse())
+            break;
+        if(m_state == Failed)
+            return false;
+
+        //The body without length end when the server close the connection
+        if(m_state == ReadingUntilClose && m_socket->state() != QAbstractSocket::ConnectedState)
+        {
+            m_body += m_buffer;
+            m_buffer.clear();
+            m_state = Done;
+            break;
+        }
+
+        int remaining = msecs - int(timer.elapsed());
+        if(remaining <= 0)
+        {
+            m_error = "Timeout while waiting for the response";
+            return false;
+        }
+        if(!m_socket->waitForReadyRead(remaining) && m_state != ReadingUntilClose)
+        {
+            m_error = m_socket->errorString();
+            return false;
+        }
+    }
+
+    response = m_body;
+    m_body.clear();
+    return true;
+}
+
+void EthHttpConnection::startRequest(const QByteArray &request, int msecs)
+{
+    m_async = true;
+    m_timer.start(msecs);
+    if(isOpen())
+    {
+        if(!writeRequest(request))
+            finishRequest(false);
+        return;
+    }
+
+    m_pendingRequest = request;
+    bool ssl = m_url.scheme().compare("https", Qt::CaseInsensitive) == 0;
+    int port = m_url.port(ssl ? 443 : 80);
+#ifndef QT_NO_SSL
+    if(ssl)
+    {
+        static_cast<QSslSocket*>(m_socket)->connectToHostEncrypted(m_url.host(), port);
+        return;
+    }
+#endif
+    m_socket->connectToHost(m_url.host(), port);
+}
+
+void EthHttpConnection::waitForData(int msecs)
+{
+    if(!m_async)
+        return;
+    //The timer of the request does not fire without event loop
+    int remaining = m_timer.remainingTime();
+    if(remaining == 0)
+    {
+        onTimeout();
+        return;
+    }
+    if(remaining > 0)
+        msecs = qMin(msecs, remaining);
+
+    QAbstractSocket::SocketState state = m_socket->state();
+    if(state == QAbstractSocket::HostLookupState || state == QAbstractSocket::ConnectingState)
+    {
+        m_socket->waitForConnected(msecs);
+        return;
+    }
+#ifndef QT_NO_SSL
+    QSslSocket* socket = qobject_cast<QSslSocket*>(m_socket);
+    if(socket && state == QAbstractSocket::ConnectedState && !socket->isEncrypted())
+    {
+        socket->waitForEncrypted(msecs);
+        return;
+    }
+#endif
+    //readyRead is not emitted recursively, so drain the socket here as well
+    if(m_socket->bytesAvailable() > 0 || m_socket->waitForReadyRead(msecs))
+        onReadyRead();
+}
+
+void EthHttpConnection::takeResponse(QByteArray &response)
+{
+    response = m_body;
+    m_body.clear();
+}
+
+int EthHttpConnection::statusCode() const
+{
+    return m_statusCode;
+}
+
+bool EthHttpConnection::hasReceivedData() const
+{
+    return m_received;
+}
+
+QString EthHttpConnection::errorString() const
+{
+    return m_error;
+}
+
+void EthHttpConnection::onConnected()
+{
+    if(!m_async || m_pendingRequest.isEmpty())
+        return;
+    QByteArray request = m_pendingRequest;
+    m_pendingRequest.clear();
+    if(!writeRequest(request))
+        finishRequest(false);
+}
+
+void EthHttpConnection::onReadyRead()
+{
+    //The blocking requests read the socket themselves
+    if(!m_async)
+        return;
+
+    QByteArray data = m_socket->readAll();
+    if(!data.isEmpty())
+    {
+        m_received = true;
+        m_buffer += data;
+    }
+    if(parseResponse())
+        finishRequest(true);
+    else if(m_state == Failed)
+        finishRequest(false);
+}
+
+void EthHttpConnection::onDisconnected()
+{
+    if(!m_async)
+        return;
+
+    if(m_state == ReadingUntilClose)
+    {
+        m_body += m_buffer;
+        m_buffer.clear();
+        m_state = Done;
+        finishRequest(true);
+        return;
+    }
+    m_error = "Connection closed by the server";
+    finishRequest(false);
+}
+
+void EthHttpConnection::onError(QAbstractSocket::SocketError err)
+{
+    //A closed connection is handled when disconnected
+    if(!m_async || err == QAbstractSocket::RemoteHostClosedError)
+        return;
+    m_error = m_socket->errorString();
+    finishRequest(false);
+}
+
+void EthHttpConnection::onTimeout()
+{
+    if(!m_async)
+        return;
+    m_error = "Timeout while waiting for the response";
+    m_keepAlive = false;
+    finishRequest(false);
+}
+
+void EthHttpConnection::finishRequest(bool success)
+{
+    if(!m_async)
+        return;
+    m_async = false;
+    m_timer.stop();
+    m_pendingRequest.clear();
+    if(!success)
+        m_keepAlive = false;
+    emit finished(success);
+}
+
+bool EthHttpConnection::parseResponse()
+{
+    forever
+    {
+        switch(m_state)
+        {
+        case ReadingHeaders:
+        {
+            int end = m_buffer.indexOf("\r\n\r\n");
+            if(end < 0) return false;
+            bool ok = parseHeaders(m_buffer.left(end));
+            m_buffer.remove(0, end + 4);
+            if(!ok)
+            {
+                m_error = "Invalid HTTP response";
+                m_keepAlive = false;
+                m_state = Failed;
+                return false;
+            }
+            //Interim responses are followed by the final one
+            if(m_statusCode >= 100 && m_statusCode < 200)
+                m_state = ReadingHeaders;
+            break;
+        }
+        case ReadingBody:
+        {
+            if(m_buffer.size() < m_contentLength) return false;
+            m_body = m_buffer.left(m_contentLength);
+            m_buffer.remove(0, m_contentLength);
+            m_state = Done;
+            break;
+        }
+        case ReadingChunkSize:
+        {
+            int end = m_buffer.indexOf("\r\n");
+            if(end < 0) return false;
+            QByteArray size = m_buffer.left(end);
+            int extension = size.indexOf(';');
+            if(extension > -1) size.truncate(extension);
+            bool ok = false;
+            m_chunkSize = size.trimmed().toLongLong(&ok, 16);
+            m_buffer.remove(0, end + 2);
+            if(!ok)
+            {
+                m_error = "Invalid chunk size";
+                m_keepAlive = false;
+                m_state = Failed;
+                return false;
+            }
+            m_state = m_chunkSize == 0 ? ReadingChunkTrailer : ReadingChunk;
+            break;
+        }
+        case ReadingChunk:
+        {
+            if(m_buffer.size() < m_chunkSize + 2) return false;
+            m_body.append(m_buffer.constData(), m_chunkSize);
+            m_buffer.remove(0, m_chunkSize + 2);
+            m_state = ReadingChunkSize;
+            break;
+        }
+        case ReadingChunkTrailer:
+        {
+            if(m_buffer.startsWith("\r\n"))
+            {
+                m_buffer.remove(0, 2);
+            }
+            else
+            {
+                int end = m_buffer.indexOf("\r\n\r\n");
+                if(end < 0) return false;
+                m_buffer.remove(0, end + 4);
+            }
+            m_state = Done;
+            break;
+        }
+        case ReadingUntilClose:
+        case Failed:
+            return false;
+        case Done:
+            return true;
+        }
+    }
+}
+
+bool EthHttpConnection::parseHeaders(const QByteArray &headers)
+{
+    QList<QByteArray> lines = headers.split('\n');
+    QList<QByteArray> status = lines.value(0).trimmed().split(' ');
+    if(status.size() < 2 || !status[0].startsWith("HTTP/"))
+        return false;
+    m_statusCode = status[1].toInt();
+    m_keepAlive = status[0] != "HTTP/1.0";
+
+    bool chunked = false;
+    m_contentLength = -1;
+    for(int i = 1; i < lines.size(); i++)
+    {
+        const QByteArray& line = lines[i];
+        int colon = line.indexOf(':');
+        if(colon < 0) continue;
+        QByteArray name = line.left(colon).trimmed().toLower();
+        QByteArray value = line.mid(colon + 1).trimmed().toLower();
+        if(name == "content-length")
+            m_contentLength = value.toLongLong();
+        else if(name == "transfer-encoding")
+            chunked = value.contains("chunked");
+        else if(name == "connection")
+            m_keepAlive = value.contains("keep-alive") || (m_keepAlive && !value.contains("close"));
+    }
+
+    if(chunked)
+        m_state = ReadingChunkSize;
+    else if(m_contentLength > -1)
+        m_state = ReadingBody;
+    else if(m_statusCode == 204 || m_statusCode == 304)
+        m_state = Done;
+    else
+    {
+        m_state = ReadingUntilClose;
+        m_keepAlive = false;
+    }
+    return true;
+}
+
+EthHttpClient::EthHttpClient(QString serverUrl, QObject *parent) : QObject(parent),
+    m_code(QAbstractSocket::UnknownSocketError)
+{
+    m_parameters["serverUrl"] = serverUrl.isEmpty() ? defaultServerUrl() : serverUrl;
+    m_parameters["timeout"] = TIMEOUT_MSECS;
+    m_parameters["maxConnections"] = MAX_CONNECTIONS;
+}
+
+EthHttpClient::~EthHttpClient()
+{
+    disconnectToServer();
+}
+
+QVariantMap &EthHttpClient::clientParameters()
+{
+    return m_parameters;
+}
+
+bool EthHttpClient::connectToServer()
+{
+    disconnectToServer();
+
+    QUrl url(m_parameters["serverUrl"].toString());
+    if(!url.isValid() || url.host().isEmpty())
+    {
+        m_code = QAbstractSocket::HostNotFoundError;
+        m_error = "Invalid server url";
+        return false;
+    }
+
+    //Open the first connection of the pool to check that the server is reachable
+    EthHttpConnection* connection = acquireConnection();
+    if(!connection)
+        return false;
+    releaseConnection(connection);
+    return true;
+}
+
+bool EthHttpClient::disconnectToServer()
+{
+    qDeleteAll(m_idle);
+    m_idle.clear();
+
+    QList<AsyncRequest> requests = m_active.values() + m_queued;
+    QList<EthHttpConnection*> connections = m_active.keys();
+    m_active.clear();
+    m_queued.clear();
+    for(int i = 0; i < connections.size(); i++)
+    {
+        connections[i]->disconnect(this);
+        connections[i]->close();
+        connections[i]->deleteLater();
+    }
+    for(int i = 0; i < requests.size(); i++)
+    {
+        requests[i].handler(false, QByteArray());
+    }
+    return true;
+}
+
+bool EthHttpClient::requestingResponse(const QByteArray &request, QByteArray &response)
+{
+    EthHttpConnection* connection = acquireConnection();
+    if(!connection)
+        return false;
+
+    bool ret = exchange(connection, request, response);
+    if(!ret && connection->isReused() && !connection->hasReceivedData())
+    {
+        //The server may close idle keep-alive connections, retry once on a new one
+        delete connection;
+        connection = acquireConnection();
+        if(!connection)
+            return false;
+        ret = exchange(connection, request, response);
+    }
+
+    if(ret)
+        releaseConnection(connection);
+    else
+        delete connection;
+    return ret;
+}
+
+bool EthHttpClient::postRequest(const QByteArray &request, const ResponseHandler &handler)
+{
+    AsyncRequest asyncRequest;
+    asyncRequest.request = request;
+    asyncRequest.handler = handler;
+    asyncRequest.retried = false;
+
+    //Requests over the connection limit wait for a free connection
+    if(m_active.size() >= m_parameters["maxConnections"].toInt())
+        m_queued.append(asyncRequest);
+    else
+        startRequest(asyncRequest);
+    return true;
+}
+
+bool EthHttpClient::waitForEvents(int msecs)
+{
+    //The time is shared between the connections of the requests in flight
+    QList<EthHttpConnection*> connections = m_active.keys();
+    for(int i = 0; i < connections.size(); i++)
+    {
+        //A finished request may have released the connection
+        if(m_active.contains(connections[i]))
+            connections[i]->waitForData(msecs / connections.size());
+    }
+    return true;
+}
+
+bool EthHttpClient::canWaitForEvents() const
+{
+    //The requests in flight always hold a connection that can be waited
+    return true;
+}
+
+int64_t EthHttpClient::errorNumber()
+{
+    return m_code;
+}
+
+QString EthHttpClient::errorString()
+{
+    return m_error;
+}
+
+QString EthHttpClient::defaultServerUrl()
+{
+    return "http://localhost:8545";
+}
+
+void EthHttpClient::onConnectionFinished(bool success)
+{
+    EthHttpConnection* connection = qobject_cast<EthHttpConnection*>(sender());
+    if(!connection || !m_active.contains(connection))
+        return;
+    AsyncRequest asyncRequest = m_active.take(connection);
+    connection->disconnect(this);
+
+    QByteArray response;
+    if(success)
+    {
+        connection->takeResponse(response);
+        success = checkStatus(connection);
+    }
+    else if(connection->isReused() && !connection->hasReceivedData() && !asyncRequest.retried)
+    {
+        //The server may close idle keep-alive connections, retry once on a new one
+        connection->deleteLater();
+        asyncRequest.retried = true;
+        startRequest(asyncRequest);
+        return;
+    }
+    else
+    {
+        m_code = QAbstractSocket::RemoteHostClosedError;
+        m_error = connection->errorString();
+    }
+
+    if(connection->keepAlive() && m_idle.size() < m_parameters["maxConnections"].toInt())
+    {
+        m_idle.append(connection);
+    }
+    else
+    {
+        connection->close();
+        connection->deleteLater();
+    }
+
+    if(!m_queued.isEmpty() && m_active.size() < m_parameters["maxConnections"].toInt())
+        startRequest(m_queued.takeFirst());
+
+    asyncRequest.handler(success, response);
+}
+
+void EthHttpClient::startRequest(const AsyncRequest &asyncRequest)
+{
+    EthHttpConnection* connection = takeConnection();
+    connect(connection, SIGNAL(finished(bool)), this, SLOT(onConnectionFinished(bool)));
+    m_active.insert(connection, asyncRequest);
+    connection->startRequest(asyncRequest.request, m_parameters["timeout"].toInt());
+}
+
+bool EthHttpClient::checkStatus(EthHttpConnection *connection)
+{
+    int status = connection->statusCode();
+    if(status < 200 || status >= 300)
+    {
+        m_code = status;
+        m_error = QString("HTTP error %1").arg(status);
+        return false;
+    }
+    return true;
+}
+
+EthHttpConnection *EthHttpClient::takeConnection()
+{
+    while(!m_idle.isEmpty())
+    {
+        EthHttpConnection* connection = m_idle.takeLast();
+        if(connection->isOpen())
+            return connection;
+        delete connection;
+    }
+    return new EthHttpConnection(QUrl(m_parameters["serverUrl"].toString()));
+}
+
+EthHttpConnection *EthHttpClient::acquireConnection()
+{
+    EthHttpConnection* connection = takeConnection();
+    if(connection->isOpen())
+        return connection;
+    if(!connection->open(MSECS))
+    {
+        m_code = QAbstractSocket::ConnectionRefusedError;
+        m_error = connection->errorString();
+        delete connection;
+        return 0;
+    }
+    return connection;
+}
+
+void EthHttpClient::releaseConnection(EthHttpConnection *connection)
+{
+    if(connection->keepAlive() && m_idle.size() < m_parameters["maxConnections"].toInt())
+        m_idle.append(connection);
+    else
+        delete connection;
+}
+
+bool EthHttpClient::exchange(EthHttpConnection *connection, const QByteArray &request, QByteArray &response)
+{
+    if(!connection->writeRequest(request) ||
+            !connection->readResponse(response, m_parameters["timeout"].toInt()))
+    {
+        m_code = QAbstractSocket::RemoteHostClosedError;
+        m_error = connection->errorString();
+        return false;
+    }
+    return checkStatus(connection);
+}
@@ -0,0 +1,131 @@
+#ifndef ETHHTTPCLIENT_H
+#define ETHHTTPCLIENT_H
+
+#include <QObject>
+#include <QTcpSocket>
+#include <QUrl>
+#include <QList>
+#include <QHash>
+#include <QTimer>
+#include "iethclient.h"
+
+//Persistent HTTP/1.1 connection that post JSON RPC requests and parse the responses incrementally
+class EthHttpConnection : public QObject
+{
+    Q_OBJECT
+public:
+    explicit EthHttpConnection(const QUrl& url, QObject *parent = 0);
+    ~EthHttpConnection();
+
+    bool open(int msecs);
+    void close();
+    bool isOpen() const;
+    //true when the connection has already served a request
+    bool isReused() const;
+    //true when the connection can be returned to the pool after the response
+    bool keepAlive() const;
+
+    bool writeRequest(const QByteArray& request);
+    bool readResponse(QByteArray& response, int msecs);
+
+    //Post the request without blocking, connect first when needed, finished is emitted at the end
+    void startRequest(const QByteArray& request, int msecs);
+    //Wait for the socket of the posted request without event loop, finished is emitted from it
+    void waitForData(int msecs);
+    void takeResponse(QByteArray& response);
+
+    int statusCode() const;
+    bool hasReceivedData() const;
+    QString errorString() const;
+
+signals:
+    void finished(bool success);
+
+private slots:
+    void onConnected();
+    void onReadyRead();
+    void onDisconnected();
+    void onError(QAbstractSocket::SocketError err);
+    void onTimeout();
+
+private:
+    enum State
+    {
+        ReadingHeaders,
+        ReadingBody,
+        ReadingChunkSize,
+        ReadingChunk,
+        ReadingChunkTrailer,
+        ReadingUntilClose,
+        Done,
+        Failed
+    };
+
+    bool parseResponse();
+    bool parseHeaders(const QByteArray& headers);
+    void finishRequest(bool success);
+
+    QTcpSocket* m_socket;
+    QUrl m_url;
+    QByteArray m_requestHeader;
+    QByteArray m_buffer;
+    QByteArray m_body;
+    State m_state;
+    qint64 m_contentLength;
+    qint64 m_chunkSize;
+    int m_statusCode;
+    bool m_keepAlive;
+    bool m_received;
+    int m_requests;
+    QString m_error;
+    bool m_async;
+    QByteArray m_pendingRequest;
+    QTimer m_timer;
+};
+
+class EthHttpClient : public QObject, public IEthClient
+{
+    Q_OBJECT
+public:
+    explicit EthHttpClient(QString serverUrl = QString(), QObject *parent = 0);
+    ~EthHttpClient();
+
+    QVariantMap &clientParameters() override;
+    bool connectToServer() override;
+    bool disconnectToServer() override;
+    bool requestingResponse(const QByteArray& request, QByteArray& response) override;
+    bool postRequest(const QByteArray& request, const ResponseHandler& handler) override;
+    bool waitForEvents(int msecs) override;
+    bool canWaitForEvents() const override;
+    int64_t errorNumber() override;
+    QString errorString() override;
+
+    static QString defaultServerUrl();
+
+private slots:
+    void onConnectionFinished(bool success);
+
+private:
+    struct AsyncRequest
+    {
+        QByteArray request;
+        ResponseHandler handler;
+        bool retried;
+    };
+
+    void startRequest(const AsyncRequest& asyncRequest);
+    bool checkStatus(EthHttpConnection* connection);
+    EthHttpConnection* takeConnection();
+    EthHttpConnection* acquireConnection();
+    void releaseConnection(EthHttpConnection* connection);
+    bool exchange(EthHttpConnection* connection, const QByteArray& request, QByteArray& response);
+
+    QVariantMap m_parameters;
+    QList<EthHttpConnection*> m_idle;
+    QHash<EthHttpConnection*, AsyncRequest> m_active;
+    QList<AsyncRequest> m_queued;
+    int m_code;
+    QString m_error;
+};
+
+#endif // ETHHTTPCLIENT_H
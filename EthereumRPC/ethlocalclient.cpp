@@ -1,20 +1,36 @@
 #include "ethlocalclient.h"
+#include "jsoncoder.h"
+#include <QDir>
+#include <QElapsedTimer>
 
 namespace EthLocalClient_NS
 {
     const int MSECS = 2000;
+    const int TIMEOUT_MSECS = 30000;
+    const int CHECK_MSECS = 500;
 }
 using namespace EthLocalClient_NS;
 
-EthLocalClient::EthLocalClient(QString serverPath, QObject *parent) : QObject(parent)
+EthLocalClient::EthLocalClient(QString serverPath, QObject *parent) : QObject(parent),
+    m_code(QLocalSocket::UnknownSocketError),
+    m_scanPos(0),
+    m_depth(0),
+    m_inString(false),
+    m_escape(false),
+    m_waiting(0)
 {
     m_parameters["serverPath"] = serverPath.isEmpty() ? defaultServerPath() : serverPath;
+    m_parameters["timeout"] = TIMEOUT_MSECS;
 
     connect(&m_socket, SIGNAL(error(QLocalSocket::LocalSocketError)),
             this, SLOT(onSocketError(QLocalSocket::LocalSocketError)));
     connect(&m_socket, SIGNAL(readyRead()), this, SLOT(onSocketReadyRead()));
     connect(&m_socket, SIGNAL(connected()), this, SLOT(connectedToServer()));
     connect(&m_socket, SIGNAL(disconnected()), this, SLOT(disconnectedFromServer()));
+
+    m_clock.start();
+    m_timeoutTimer.setInterval(CHECK_MSECS);
+    connect(&m_timeoutTimer, SIGNAL(timeout()), this, SLOT(checkTimeouts()));
 }
 
 EthLocalClient::~EthLocalClient()
@@ -37,33 +53,158 @@ bool EthLocalClient::connectToServer()
 
 bool EthLocalClient::disconnectToServer()
 {
+    if(m_socket.state() == QLocalSocket::UnconnectedState)
+        return true;
     m_socket.disconnectFromServer();
-    return m_socket.waitForDisconnected(MSECS);
+    return m_socket.state() == QLocalSocket::UnconnectedState ||
+            m_socket.waitForDisconnected(MSECS);
 }
 
 bool EthLocalClient::requestingResponse(const QByteArray &request, QByteArray &response)
 {
-    bool ret = false;
-    if(m_socket.isWritable())
+    int64_t id = 0;
+    if(!peekJsonRPCId(request, id))
+    {
+        m_code = QLocalSocket::UnknownSocketError;
+        m_error = "Invalid JSON RPC request";
+        return false;
+    }
+    if(!sendRequest(request, id))
+        return false;
+    return waitForResponse(id, response);
+}
+
+bool EthLocalClient::postRequest(const QByteArray &request, const ResponseHandler &handler)
+{
+    int64_t id = 0;
+    if(!peekJsonRPCId(request, id))
     {
+        m_code = QLocalSocket::UnknownSocketError;
+        m_error = "Invalid JSON RPC request";
+        handler(false, QByteArray());
+        return false;
+    }
 
+    AsyncRequest asyncRequest;
+    asyncRequest.handler = handler;
+    asyncRequest.deadline = m_clock.elapsed() + m_parameters["timeout"].toInt();
+    m_handlers.insert(id, asyncRequest);
+    if(!sendRequest(request, id))
+    {
+        m_handlers.remove(id);
+        handler(false, QByteArray());
+        return false;
     }
+    //The handler owns the request, it is not waited synchronously
+    m_pending.remove(id);
+
+    if(!m_timeoutTimer.isActive())
+        m_timeoutTimer.start();
+    return true;
+}
+
+bool EthLocalClient::setNotificationHandler(const NotificationHandler &handler)
+{
+    m_notificationHandler = handler;
+    return true;
+}
+
+bool EthLocalClient::sendRequest(const QByteArray &request, int64_t id)
+{
+    if(m_socket.state() != QLocalSocket::ConnectedState || !m_socket.isWritable())
+    {
+        m_code = QLocalSocket::PeerClosedError;
+        m_error = "Not connected to the server";
+        return false;
+    }
+
+    m_pending.insert(id);
+    if(m_socket.write(request) != request.size())
+    {
+        m_pending.remove(id);
+        return false;
+    }
+    m_socket.flush();
+    return true;
+}
+
+bool EthLocalClient::waitForResponse(int64_t id, QByteArray &response, int msecs)
+{
+    if(!m_pending.contains(id))
+        return false;
+    if(msecs < 0)
+        msecs = m_parameters["timeout"].toInt();
+
+    QElapsedTimer timer;
+    timer.start();
+    bool ret = true;
+    m_waiting++;
+    while(!m_responses.contains(id))
+    {
+        int remaining = msecs - int(timer.elapsed());
+        if(remaining <= 0)
+        {
+            connectionTimeout();
+            ret = false;
+            break;
+        }
+        if(!m_socket.waitForReadyRead(remaining))
+        {
+            if(m_socket.error() == QLocalSocket::SocketTimeoutError)
+                connectionTimeout();
+            ret = false;
+            break;
+        }
+        //readyRead is not emitted recursively, so drain the socket here as well
+        onSocketReadyRead();
+    }
+    m_waiting--;
+
+    if(ret)
+        response = m_responses.take(id);
+    m_pending.remove(id);
     return ret;
 }
 
+bool EthLocalClient::waitForEvents(int msecs)
+{
+    if(m_socket.state() != QLocalSocket::ConnectedState)
+        return false;
+    m_waiting++;
+    //readyRead is not emitted recursively, so drain the socket here as well
+    if(m_socket.bytesAvailable() > 0 || m_socket.waitForReadyRead(msecs))
+        onSocketReadyRead();
+    m_waiting--;
+    //The deadlines of the posted requests are checked here, the timer does not fire
+    if(!m_handlers.isEmpty())
+        checkTimeouts();
+    return m_socket.state() == QLocalSocket::ConnectedState;
+}
+
+bool EthLocalClient::canWaitForEvents() const
+{
+    return m_socket.state() == QLocalSocket::ConnectedState;
+}
+
 int64_t EthLocalClient::errorNumber()
 {
-    return m_socket.error();
+    return m_code;
 }
 
 QString EthLocalClient::errorString()
 {
-    return m_socket.errorString();
+    return m_error;
 }
 
 QString EthLocalClient::defaultServerPath()
 {
-    return "";
+#if defined(Q_OS_WIN)
+    return "\\\\.\\pipe\\geth.ipc";
+#elif defined(Q_OS_MAC)
+    return QDir::homePath() + "/Library/Ethereum/geth.ipc";
+#else
+    return QDir::homePath() + "/.ethereum/geth.ipc";
+#endif
 }
 
 void EthLocalClient::onSocketError(QLocalSocket::LocalSocketError err)
@@ -74,20 +215,172 @@ void EthLocalClient::onSocketError(QLocalSocket::LocalSocketError err)
 
 void EthLocalClient::onSocketReadyRead()
 {
+    if(m_socket.bytesAvailable() <= 0)
+        return;
+    m_buffer.append(m_socket.readAll());
+
+    //Split the stream into top level JSON values, the node does not delimit them
+    const char* data = m_buffer.constData();
+    int size = m_buffer.size();
+    int start = 0;
+    QList<QByteArray> frames;
+    for(int i = m_scanPos; i < size; i++)
+    {
+        char c = data[i];
+        if(m_inString)
+        {
+            if(m_escape)
+                m_escape = false;
+            else if(c == '\\')
+                m_escape = true;
+            else if(c == '"')
+                m_inString = false;
+            continue;
+        }
+
+        switch(c)
+        {
+        case '"':
+            m_inString = true;
+            break;
+        case '{':
+        case '[':
+            m_depth++;
+            break;
+        case '}':
+        case ']':
+            m_depth--;
+            if(m_depth <= 0)
+            {
+                if(m_depth == 0)
+                    frames.append(m_buffer.mid(start, i + 1 - start));
+                m_depth = 0;
+                start = i + 1;
+            }
+            break;
+        default:
+            break;
+        }
+    }
 
+    m_buffer.remove(0, start);
+    m_scanPos = m_buffer.size();
+
+    //Dispatch once the stream state is consistent, the handlers may call back into the client
+    for(int i = 0; i < frames.size(); i++)
+    {
+        dispatchFrame(frames[i]);
+    }
 }
 
 void EthLocalClient::connectedToServer()
 {
-
+    resetStream();
 }
 
 void EthLocalClient::disconnectedFromServer()
 {
-
+    resetStream();
+    m_pending.clear();
+    m_responses.clear();
+    failAsyncRequests();
 }
 
 void EthLocalClient::connectionTimeout()
 {
+    m_code = QLocalSocket::SocketTimeoutError;
+    m_error = "Timeout while waiting for the response";
+}
+
+void EthLocalClient::checkTimeouts()
+{
+    qint64 now = m_clock.elapsed();
+    QList<ResponseHandler> expired;
+    QMutableHashIterator<int64_t, AsyncRequest> it(m_handlers);
+    while(it.hasNext())
+    {
+        it.next();
+        if(it.value().deadline <= now)
+        {
+            expired.append(it.value().handler);
+            it.remove();
+        }
+    }
+
+    if(m_handlers.isEmpty())
+        m_timeoutTimer.stop();
+    if(!expired.isEmpty())
+        connectionTimeout();
+    for(int i = 0; i < expired.size(); i++)
+    {
+        expired[i](false, QByteArray());
+    }
+}
+
+void EthLocalClient::deliverNotifications()
+{
+    QList<QByteArray> notifications;
+    notifications.swap(m_notifications);
+    for(int i = 0; i < notifications.size(); i++)
+    {
+        if(m_notificationHandler)
+            m_notificationHandler(notifications[i]);
+    }
+}
+
+void EthLocalClient::failAsyncRequests()
+{
+    QList<AsyncRequest> requests = m_handlers.values();
+    m_handlers.clear();
+    m_timeoutTimer.stop();
+    for(int i = 0; i < requests.size(); i++)
+    {
+        requests[i].handler(false, QByteArray());
+    }
+}
+
+void EthLocalClient::resetStream()
+{
+    m_buffer.clear();
+    m_scanPos = 0;
+    m_depth = 0;
+    m_inString = false;
+    m_escape = false;
+}
+
+void EthLocalClient::dispatchFrame(const QByteArray &frame)
+{
+    int64_t id = 0;
+    if(!peekJsonRPCId(frame, id))
+    {
+        //Messages without id are notifications, they are not delivered inside a blocking call
+        //so the handler can use the connection and the subscription is known before its first notification
+        if(!m_notificationHandler)
+            return;
+        if(m_waiting || !m_notifications.isEmpty())
+        {
+            if(m_notifications.isEmpty())
+                QMetaObject::invokeMethod(this, "deliverNotifications", Qt::QueuedConnection);
+            m_notifications.append(frame);
+            return;
+        }
+        m_notificationHandler(frame);
+        return;
+    }
 
+    if(m_handlers.contains(id))
+    {
+        ResponseHandler handler = m_handlers.take(id).handler;
+        if(m_handlers.isEmpty())
+            m_timeoutTimer.stop();
+        handler(true, frame);
+        return;
+    }
+
+    //Responses nobody waits for anymore (timed out) are dropped
+    if(m_pending.contains(id))
+    {
+        m_responses.insert(id, frame);
+        emit responseReceived(id);
+    }
 }
@@ -3,6 +3,10 @@
 
 #include <QObject>
 #include <QLocalSocket>
+#include <QHash>
+#include <QSet>
+#include <QTimer>
+#include <QElapsedTimer>
 #include "iethclient.h"
 
 class EthLocalClient : public QObject, public IEthClient
@@ -16,12 +20,22 @@ public:
     bool connectToServer() override;
     bool disconnectToServer() override;
     bool requestingResponse(const QByteArray& request, QByteArray& response) override;
+    bool postRequest(const QByteArray& request, const ResponseHandler& handler) override;
+    bool setNotificationHandler(const NotificationHandler& handler) override;
+    bool waitForEvents(int msecs) override;
+    bool canWaitForEvents() const override;
     int64_t errorNumber() override;
     QString errorString() override;
 
+    //Write the request without waiting, several requests can be in flight on the connection
+    bool sendRequest(const QByteArray& request, int64_t id);
+    //Wait for the response with the given id, msecs < 0 use the "timeout" parameter
+    bool waitForResponse(int64_t id, QByteArray& response, int msecs = -1);
+
     static QString defaultServerPath();
 
 signals:
+    void responseReceived(qint64 id);
 
 public slots:
     void onSocketError(QLocalSocket::LocalSocketError err);
@@ -31,12 +45,44 @@ public slots:
 
     void connectionTimeout();
 
+private slots:
+    void checkTimeouts();
+    void deliverNotifications();
+
 private:
+    struct AsyncRequest
+    {
+        ResponseHandler handler;
+        qint64 deadline;
+    };
+
+    void failAsyncRequests();
+
+    void resetStream();
+    void dispatchFrame(const QByteArray& frame);
+
     QLocalSocket m_socket;
     QVariantMap m_parameters;
     int m_code;
     QString m_error;
+
+    //Incremental framing state of the response stream
+    QByteArray m_buffer;
+    int m_scanPos;
+    int m_depth;
+    bool m_inString;
+    bool m_escape;
+
+    QSet<int64_t> m_pending;
+    QHash<int64_t, QByteArray> m_responses;
+    QHash<int64_t, AsyncRequest> m_handlers;
+    QElapsedTimer m_clock;
+    QTimer m_timeoutTimer;
+
+    NotificationHandler m_notificationHandler;
+    //Notifications received while waiting for a response, delivered from the event loop
+    QList<QByteArray> m_notifications;
+    int m_waiting;
 };
 
 #endif // ETHLOCALCLIENT_H
-
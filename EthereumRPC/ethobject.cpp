@@ -1,7 +1,8 @@
 #include "ethobject.h"
 #include "ethrpc_utils.h"
+#include "jsoncoder.h"
 
-bool ESyncing::isSyncing()
+bool ESyncing::isSyncing() const
 {
     return !isNull();
 }
@@ -35,6 +36,16 @@ QVariant EBool::toRawData() const
     return rowData;
 }
 
+void EBool::fromJson(JsonReader &reader)
+{
+    if(reader.peek() != JsonReader::Bool)
+    {
+        EValue::fromJson(reader);
+        return;
+    }
+    m_isNull = !reader.readBool(m_value);
+}
+
 EInt::EInt():
     m_value(0)
 {}
@@ -65,6 +76,103 @@ QVariant EInt::toRawData() const
     return rowData;
 }
 
+void EInt::fromJson(JsonReader &reader)
+{
+    if(reader.peek() != JsonReader::String)
+    {
+        EValue::fromJson(reader);
+        return;
+    }
+    const char* data = 0;
+    int size = 0;
+    m_isNull = !reader.readRawString(data, size) || !hex2int(data, size, m_value);
+}
+
+EUInt256::EUInt256()
+{}
+
+EUInt256::EUInt256(const UInt256 &value):
+    m_value(value)
+{
+    m_isNull = false;
+}
+
+EUInt256::EUInt256(uint64_t value):
+    m_value(value)
+{
+    m_isNull = false;
+}
+
+void EUInt256::fromRawData(const QVariant &rowData)
+{
+    m_isNull = rowData.isNull();
+    if(!m_isNull)
+    {
+        QByteArray rowString = rowData.toString().toLatin1();
+        m_isNull = !m_value.fromHex(rowString.constData(), rowString.size());
+    }
+}
+
+QVariant EUInt256::toRawData() const
+{
+    QVariant rowData;
+    if(!m_isNull)
+    {
+        char digits[UInt256::HEX_DIGITS];
+        int size = m_value.toHex(digits);
+        rowData = "0x" + QByteArray(digits, size);
+    }
+    return rowData;
+}
+
+void EUInt256::fromJson(JsonReader &reader)
+{
+    if(reader.peek() != JsonReader::String)
+    {
+        EValue::fromJson(reader);
+        return;
+    }
+    const char* data = 0;
+    int size = 0;
+    m_isNull = !reader.readRawString(data, size) || !m_value.fromHex(data, size);
+}
+
+bool fixedFromRawData(const QVariant &rowData, uchar *data, int size)
+{
+    bool ok = false;
+    if(!rowData.isNull())
+    {
+        QByteArray rowString = rowData.toString().toLatin1();
+        ok = hex2binary(rowString.constData(), rowString.size(), data, size);
+    }
+    if(!ok)
+        memset(data, 0, size);
+    return ok;
+}
+
+QVariant fixedToRawData(const uchar *data, int size)
+{
+    return binary2hex(QByteArray::fromRawData(reinterpret_cast<const char*>(data), size));
+}
+
+bool fixedFromJson(JsonReader &reader, uchar *data, int size)
+{
+    bool ok = false;
+    if(reader.peek() == JsonReader::String)
+    {
+        const char* hexData = 0;
+        int hexSize = 0;
+        ok = reader.readRawString(hexData, hexSize) && hex2binary(hexData, hexSize, data, size);
+    }
+    else
+    {
+        reader.skipValue();
+    }
+    if(!ok)
+        memset(data, 0, size);
+    return ok;
+}
+
 EByteArray::EByteArray()
 {}
 
@@ -100,6 +208,19 @@ QVariant EByteArray::toRawData() const
     return rowData;
 }
 
+void EByteArray::fromJson(JsonReader &reader)
+{
+    if(reader.peek() != JsonReader::String)
+    {
+        EValue::fromJson(reader);
+        return;
+    }
+    const char* data = 0;
+    int size = 0;
+    m_isNull = !reader.readRawString(data, size);
+    m_value = m_isNull ? QByteArray() : hex2binary(data, size);
+}
+
 EString::EString()
 {}
 
@@ -128,6 +249,16 @@ QVariant EString::toRawData() const
     return rowData;
 }
 
+void EString::fromJson(JsonReader &reader)
+{
+    if(reader.peek() != JsonReader::String)
+    {
+        EValue::fromJson(reader);
+        return;
+    }
+    m_isNull = !reader.readString(m_value);
+}
+
 EVariant::EVariant()
 {}
 
@@ -185,6 +316,7 @@ EByteArrayList::EByteArrayList(const QByteArrayList &value):
 void EByteArrayList::fromRawData(const QVariant &rowData)
 {
     m_isNull = rowData.isNull();
+    m_value.clear();
     if(!m_isNull)
     {
         QList<QVariant> rowValues = rowData.toList();
@@ -210,6 +342,34 @@ QVariant EByteArrayList::toRawData() const
     return rowData;
 }
 
+void EByteArrayList::fromJson(JsonReader &reader)
+{
+    if(reader.peek() != JsonReader::Array)
+    {
+        EValue::fromJson(reader);
+        return;
+    }
+    m_isNull = false;
+    m_value.clear();
+    reader.beginArray();
+    while(reader.nextElement())
+    {
+        const char* data = 0;
+        int size = 0;
+        if(reader.peek() == JsonReader::String && reader.readRawString(data, size))
+        {
+            m_value.append(hex2binary(data, size));
+        }
+        else
+        {
+            QVariant rowValue;
+            reader.readVariant(rowValue);
+            m_value.append(hex2binary(rowValue.toString()));
+        }
+    }
+    m_isNull = reader.hasError();
+}
+
 EObject::EObject()
 {}
 
@@ -219,6 +379,31 @@ void EObject::fromRawData(const QVariant &rowData)
     serialize(in, true);
 }
 
+void EObject::fromJson(JsonReader &reader)
+{
+    if(reader.peek() != JsonReader::Object)
+    {
+        EValue::fromJson(reader);
+        return;
+    }
+
+    //The parameters missing in the object are null like with fromRawData
+    QVariantMap empty;
+    serialize(empty, true);
+
+    const char* key = 0;
+    int size = 0;
+    reader.beginObject();
+    while(reader.nextKey(key, size))
+    {
+        EValue* value = field(key, size);
+        if(value)
+            value->fromJson(reader);
+        else
+            reader.skipValue();
+    }
+}
+
 QVariant EObject::toRawData() const
 {
     QVariantMap out;
@@ -229,16 +414,248 @@ QVariant EObject::toRawData() const
 ETransaction::ETransaction()
 {}
 
+ETransactionList::ETransactionList():
+    m_full(false)
+{}
+
+ETransactionList::operator QByteArrayList() const
+{
+    QByteArrayList value;
+    value.reserve(m_hashes.count());
+    for(int i = 0; i < m_hashes.count(); i++)
+    {
+        value.append(m_hashes[i]);
+    }
+    return value;
+}
+
+void ETransactionList::fromRawData(const QVariant &rowData)
+{
+    clear();
+    m_isNull = rowData.isNull();
+    if(!m_isNull)
+    {
+        QList<QVariant> rowValues = rowData.toList();
+        m_hashes.resize(rowValues.count());
+        for(int i = 0 ; i < rowValues.count(); i++)
+        {
+            const QVariant& rowValue = rowValues[i];
+            if(rowValue.type() == QVariant::Map)
+            {
+                m_full = true;
+                m_transactions.append(ETransaction());
+                m_transactions.last().fromRawData(rowValue);
+                m_hashes[i] = m_transactions.last().hash;
+            }
+            else
+            {
+                m_hashes[i].fromRawData(rowValue);
+            }
+        }
+    }
+}
+
+QVariant ETransactionList::toRawData() const
+{
+    QList<QVariant> rowData;
+    if(!m_isNull)
+    {
+        if(m_full)
+        {
+            for(int i = 0 ; i < m_transactions.count(); i++)
+            {
+                rowData.append(m_transactions[i].toRawData());
+            }
+        }
+        else
+        {
+            for(int i = 0 ; i < m_hashes.count(); i++)
+            {
+                rowData.append(m_hashes[i].toRawData());
+            }
+        }
+    }
+    return rowData;
+}
+
+void ETransactionList::fromJson(JsonReader &reader)
+{
+    if(reader.peek() != JsonReader::Array)
+    {
+        EValue::fromJson(reader);
+        return;
+    }
+    clear();
+    reader.beginArray();
+    while(reader.nextElement())
+    {
+        if(reader.peek() == JsonReader::Object)
+        {
+            //Decode in place in the vector, no temporary transaction is copied
+            m_full = true;
+            m_transactions.resize(m_transactions.count() + 1);
+            ETransaction& transaction = m_transactions.last();
+            transaction.fromJson(reader);
+            m_hashes.append(transaction.hash);
+        }
+        else
+        {
+            m_hashes.append(EHash32());
+            m_hashes.last().fromJson(reader);
+        }
+    }
+    m_isNull = reader.hasError();
+}
+
+void ETransactionList::clear()
+{
+    m_hashes.clear();
+    m_transactions.clear();
+    m_full = false;
+}
+
 EValue::EValue() :
     m_isNull(true)
 {}
 
+void EValue::fromJson(JsonReader &reader)
+{
+    QVariant rowData;
+    reader.readVariant(rowData);
+    fromRawData(rowData);
+}
+
 ESyncing::ESyncing()
 {}
 
 EBlock::EBlock()
 {}
 
+ETopicList::ETopicList():
+    m_count(0)
+{}
+
+ETopicList::operator QByteArrayList() const
+{
+    QByteArrayList value;
+    for(int i = 0; i < m_count; i++)
+    {
+        value.append(m_topics[i]);
+    }
+    return value;
+}
+
+void ETopicList::fromRawData(const QVariant &rowData)
+{
+    m_count = 0;
+    m_isNull = rowData.isNull();
+    if(!m_isNull)
+    {
+        QList<QVariant> rowValues = rowData.toList();
+        m_isNull = rowValues.count() > MaxTopics;
+        for(int i = 0 ; i < rowValues.count() && i < MaxTopics; i++)
+        {
+            m_topics[m_count++].fromRawData(rowValues[i]);
+        }
+    }
+}
+
+QVariant ETopicList::toRawData() const
+{
+    QList<QVariant> rowData;
+    if(!m_isNull)
+    {
+        for(int i = 0 ; i < m_count; i++)
+        {
+            rowData.append(m_topics[i].toRawData());
+        }
+    }
+    return rowData;
+}
+
+void ETopicList::fromJson(JsonReader &reader)
+{
+    if(reader.peek() != JsonReader::Array)
+    {
+        EValue::fromJson(reader);
+        return;
+    }
+    m_count = 0;
+    bool overflow = false;
+    reader.beginArray();
+    while(reader.nextElement())
+    {
+        if(m_count < MaxTopics)
+        {
+            m_topics[m_count++].fromJson(reader);
+        }
+        else
+        {
+            overflow = true;
+            reader.skipValue();
+        }
+    }
+    m_isNull = overflow || reader.hasError();
+}
+
+ELog::ELog()
+{}
+
+ELogList::ELogList()
+{}
+
+ELogList::ELogList(const QVector<ELog> &logs):
+    m_value(logs)
+{
+    m_isNull = false;
+}
+
+void ELogList::fromRawData(const QVariant &rowData)
+{
+    m_value.clear();
+    m_isNull = rowData.isNull();
+    if(!m_isNull)
+    {
+        QList<QVariant> rowValues = rowData.toList();
+        m_value.resize(rowValues.count());
+        for(int i = 0 ; i < rowValues.count(); i++)
+        {
+            m_value[i].fromRawData(rowValues[i]);
+        }
+    }
+}
+
+QVariant ELogList::toRawData() const
+{
+    QList<QVariant> rowData;
+    if(!m_isNull)
+    {
+        for(int i = 0 ; i < m_value.count(); i++)
+        {
+            rowData.append(m_value[i].toRawData());
+        }
+    }
+    return rowData;
+}
+
+void ELogList::fromJson(JsonReader &reader)
+{
+    if(reader.peek() != JsonReader::Array)
+    {
+        EValue::fromJson(reader);
+        return;
+    }
+    m_value.clear();
+    reader.beginArray();
+    while(reader.nextElement())
+    {
+        //Decode in place in the vector, no temporary log is copied
+        m_value.resize(m_value.count() + 1);
+        m_value.last().fromJson(reader);
+    }
+    m_isNull = reader.hasError();
+}
+
 EReceipt::EReceipt()
 {}
 
@@ -7,34 +7,74 @@
 #include <QVariant>
 #include <QByteArray>
 #include <QByteArrayList>
+#include <QHash>
+#include <cstring>
+#include <type_traits>
+#include "uint256.h"
+
+//The macro generate the functions that copy ETH Values of the same type
+#define ETH_VALUE \
+    EValue* clone() const override\
+    {\
+        return new typename std::decay<decltype(*this)>::type(*this);\
+    }\
+    void assign(const EValue& other) override\
+    {\
+        *this = static_cast<const typename std::decay<decltype(*this)>::type&>(other);\
+    }
 
 //The macro generate functions necessary for working with ETH Objects
 #define ETH_OBJECT(Params) \
     void serialize(QVariantMap& map, bool read) override\
     {\
+        const char* fieldName = 0;\
+        int fieldSize = 0;\
+        EValue* found = 0;\
         bool nullCheck = false;\
         int notNull = 0;\
         if(!read)map.clear();\
         Params\
+        Q_UNUSED(fieldSize);\
+        Q_UNUSED(found);\
     }\
-    bool isNull() {\
+    bool isNull() const override {\
         QVariantMap map;\
+        const char* fieldName = 0;\
+        int fieldSize = 0;\
+        const EValue* found = 0;\
         bool read = false;\
         bool nullCheck = true;\
         int notNull = 0;\
         Params\
+        Q_UNUSED(fieldSize);\
+        Q_UNUSED(found);\
         return notNull == 0; \
-    }
+    }\
+    EValue* field(const char* fieldName, int fieldSize) override\
+    {\
+        QVariantMap map;\
+        EValue* found = 0;\
+        bool read = false;\
+        bool nullCheck = false;\
+        int notNull = 0;\
+        Params\
+        return found;\
+    }\
+    ETH_VALUE
 
 //The macro generate code for working with ETH Parameters
 #define ETH_PARAM(Param) \
-    if(nullCheck)\
+    if(fieldName)\
+    {\
+        if(!found && jsonKeyEquals(fieldName, fieldSize, #Param)) found = &Param;\
+    }\
+    else if(nullCheck)\
     {\
         if(!Param.isNull()) notNull++;\
     }\
     else if(read)\
     {\
-        Param.fromRawData(map[#Param]);\
+        ethReadParam(Param, map.value(#Param));\
     }\
     else\
     {\
@@ -44,18 +84,46 @@
         }\
     }
 
+class JsonReader;
+
+//Compare a JSON key that is not null terminated with a string literal
+template<int N>
+inline bool jsonKeyEquals(const char* key, int size, const char (&name)[N])
+{
+    return size == N - 1 && memcmp(key, name, N - 1) == 0;
+}
+
 class EValue
 {
 public:
     EValue();
-    virtual bool isNull() { return m_isNull; }
+    virtual ~EValue() {}
+    virtual bool isNull() const { return m_isNull; }
     virtual void fromRawData(const QVariant& rowData) = 0;
     virtual QVariant toRawData() const = 0;
+    //Decode the next JSON value of the reader, the default implementation go through fromRawData
+    virtual void fromJson(JsonReader& reader);
+    //Return a copy of the value, null when the type can not be copied
+    virtual EValue* clone() const { return 0; }
+    //Copy a value of the same type, returned by clone
+    virtual void assign(const EValue& other) { Q_UNUSED(other); }
 
 protected:
     bool m_isNull;
 };
 
+//Read a parameter of an object, the parameters of a const object are never read,
+//the null check of ETH_OBJECT is const
+template<class T>
+inline void ethReadParam(T& param, const QVariant& value)
+{
+    param.fromRawData(value);
+}
+
+template<class T>
+inline void ethReadParam(const T&, const QVariant&)
+{}
+
 class EObject : public EValue
 {
 public:
@@ -63,17 +131,22 @@ public:
 
     void fromRawData(const QVariant& rowData);
     QVariant toRawData() const;
+    void fromJson(JsonReader& reader) override;
     virtual void serialize(QVariantMap& map, bool read) = 0;
+    //Return the parameter with the given name, null when it is not a parameter of the object
+    virtual EValue* field(const char* fieldName, int fieldSize) = 0;
 };
 
 class EBool : public EValue
 {
 public:
+    ETH_VALUE
     EBool();
     EBool(bool value);
-    inline operator bool() { return m_value; }
+    inline operator bool() const { return m_value; }
     void fromRawData(const QVariant& rowData) override;
     QVariant toRawData() const override;
+    void fromJson(JsonReader& reader) override;
 
 private:
     bool m_value;
@@ -82,25 +155,125 @@ private:
 class EInt : public EValue
 {
 public:
+    ETH_VALUE
     EInt();
     EInt(int64_t value);
-    inline operator int64_t() { return m_value; }
+    inline operator int64_t() const { return m_value; }
     void fromRawData(const QVariant& rowData) override;
     QVariant toRawData() const override;
+    void fromJson(JsonReader& reader) override;
 
 private:
     int64_t m_value;
 };
 
+class EUInt256 : public EValue
+{
+public:
+    ETH_VALUE
+    EUInt256();
+    EUInt256(const UInt256& value);
+    EUInt256(uint64_t value);
+    inline operator UInt256() const { return m_value; }
+    void fromRawData(const QVariant& rowData) override;
+    QVariant toRawData() const override;
+    void fromJson(JsonReader& reader) override;
+
+private:
+    UInt256 m_value;
+};
+
+//Helpers of the fixed size DATA, the data is null when it has not the expected size
+bool fixedFromRawData(const QVariant& rowData, uchar* data, int size);
+QVariant fixedToRawData(const uchar* data, int size);
+bool fixedFromJson(JsonReader& reader, uchar* data, int size);
+
+//DATA with a fixed size stored inline, usable as key of QHash and QMap
+template<int N>
+class EFixedByteArray : public EValue
+{
+public:
+    ETH_VALUE
+    enum { Size = N };
+
+    EFixedByteArray()
+    {
+        memset(m_value, 0, N);
+    }
+    EFixedByteArray(const QByteArray& value)
+    {
+        memset(m_value, 0, N);
+        if(value.size() == N)
+        {
+            memcpy(m_value, value.constData(), N);
+            m_isNull = false;
+        }
+    }
+    inline operator QByteArray() const { return QByteArray(reinterpret_cast<const char*>(m_value), N); }
+    inline const uchar* data() const { return m_value; }
+    inline uchar* data() { return m_value; }
+    inline int size() const { return N; }
+
+    void fromRawData(const QVariant& rowData) override
+    {
+        m_isNull = !fixedFromRawData(rowData, m_value, N);
+    }
+    QVariant toRawData() const override
+    {
+        return m_isNull ? QVariant() : fixedToRawData(m_value, N);
+    }
+    void fromJson(JsonReader& reader) override
+    {
+        m_isNull = !fixedFromJson(reader, m_value, N);
+    }
+
+    inline bool operator==(const EFixedByteArray& other) const
+    {
+        return m_isNull == other.m_isNull && memcmp(m_value, other.m_value, N) == 0;
+    }
+    inline bool operator!=(const EFixedByteArray& other) const { return !(*this == other); }
+    inline bool operator<(const EFixedByteArray& other) const
+    {
+        if(m_isNull != other.m_isNull) return m_isNull;
+        return memcmp(m_value, other.m_value, N) < 0;
+    }
+
+private:
+    uchar m_value[N];
+};
+
+template<int N>
+inline uint qHash(const EFixedByteArray<N>& key, uint seed = 0)
+{
+    return qHashBits(key.data(), N, seed);
+}
+
+//DATA, 8 Bytes
+typedef EFixedByteArray<8> ENonce8;
+//DATA, 20 Bytes
+typedef EFixedByteArray<20> EAddress20;
+//DATA, 32 Bytes
+typedef EFixedByteArray<32> EHash32;
+//DATA, 256 Bytes
+typedef EFixedByteArray<256> EBloom256;
+
 class EByteArray : public EValue
 {
 public:
+    ETH_VALUE
     EByteArray();
     EByteArray(const QByteArray& value);
     EByteArray(char* value);
-    inline operator QByteArray() { return m_value; }
+    template<int N>
+    EByteArray(const EFixedByteArray<N>& value):
+        m_value(value)
+    {
+        m_isNull = value.isNull();
+    }
+    inline operator QByteArray() const { return m_value; }
     void fromRawData(const QVariant& rowData) override;
     QVariant toRawData() const override;
+    void fromJson(JsonReader& reader) override;
 
 private:
     QByteArray m_value;
@@ -109,11 +282,13 @@ private:
 class EString : public EValue
 {
 public:
+    ETH_VALUE
     EString();
     EString(const QString& value);
     inline operator QString() { return m_value; }
     void fromRawData(const QVariant& rowData) override;
     QVariant toRawData() const override;
+    void fromJson(JsonReader& reader) override;
 
 private:
     QString m_value;
@@ -122,6 +297,7 @@ private:
 class EVariant : public EValue
 {
 public:
+    ETH_VALUE
     EVariant();
     EVariant(const QVariant& value);
     inline operator QVariant() { return m_value; }
@@ -135,11 +311,13 @@ private:
 class EByteArrayList : public EValue
 {
 public:
+    ETH_VALUE
     EByteArrayList();
     EByteArrayList(const QByteArrayList& value);
     inline operator QByteArrayList() { return m_value; }
     void fromRawData(const QVariant& rowData) override;
     QVariant toRawData() const override;
+    void fromJson(JsonReader& reader) override;
 
 private:
     QByteArrayList m_value;
@@ -152,7 +330,7 @@ class ESyncing : public EObject
 public:
     ESyncing();
     //It is true when syncing, false when not syncing
-    bool isSyncing();
+    bool isSyncing() const;
     //The block at which the import started (will only be reset, after the sync reached his head)
     EInt startingBlock;
     //The current block, same as eth_blockNumber
@@ -173,23 +351,25 @@ class ETransaction : public EObject{
 public:
     ETransaction();
     //DATA, 20 Bytes - The address the transaction is send from.
-    EByteArray from;
+    EAddress20 from;
     //DATA, 20 Bytes - The address the transaction is directed to.
-    EByteArray to;
+    EAddress20 to;
     //QUANTITY - Integer of the gas provided for the transaction execution. It will return unused gas.
     EInt gas;
     //QUANTITY - Integer of the gasPrice used for each paid gas
     EInt gasPrice;
     //QUANTITY - Integer of the value send with this transaction
-    EInt value;
+    EUInt256 value;
     //DATA - The compiled code of a contract OR the hash of the invoked method signature and encoded parameters. For details see Ethereum Contract ABI
     EByteArray data;
+    //DATA - The data send along with the transaction, returned by the node instead of data.
+    EByteArray input;
     //QUANTITY - Integer of a nonce. This allows to overwrite your own pending transactions that use the same nonce.
     EInt nonce;
     //DATA, 32 Bytes - hash of the transaction.
-    EByteArray hash;
+    EHash32 hash;
     //DATA, 32 Bytes - hash of the block where this transaction was in. null when its pending.
-    EByteArray blockHash;
+    EHash32 blockHash;
     //QUANTITY - block number where this transaction was in. null when its pending.
     EInt blockNumber;
     //QUANTITY - integer of the transactions index position in the block. null when its pending.
@@ -203,6 +383,7 @@ public:
         ETH_PARAM(gasPrice);
         ETH_PARAM(value);
         ETH_PARAM(data);
+        ETH_PARAM(input);
         ETH_PARAM(nonce);
         ETH_PARAM(hash);
         ETH_PARAM(blockHash);
@@ -211,33 +392,59 @@ public:
     )
 };
 
+//Array of transaction objects or 32 Bytes transaction hashes, the objects are stored contiguously
+class ETransactionList : public EValue
+{
+public:
+    ETH_VALUE
+    ETransactionList();
+    //true when the list hold transaction objects
+    inline bool isFull() const { return m_full; }
+    inline int count() const { return m_hashes.count(); }
+    //Hashes of the transactions, available for both forms of the list
+    inline const QVector<EHash32>& hashes() const { return m_hashes; }
+    //Transaction objects, empty when the list hold only hashes
+    inline const QVector<ETransaction>& transactions() const { return m_transactions; }
+    operator QByteArrayList() const;
+    void fromRawData(const QVariant& rowData) override;
+    QVariant toRawData() const override;
+    void fromJson(JsonReader& reader) override;
+
+private:
+    void clear();
+
+    QVector<EHash32> m_hashes;
+    QVector<ETransaction> m_transactions;
+    bool m_full;
+};
+
 class EBlock : public EObject{
 public:
     EBlock();
     //QUANTITY - the block number. null when its pending block.
     EInt number;
     //DATA, 32 Bytes - hash of the block. null when its pending block.
-    EByteArray hash;
+    EHash32 hash;
     //DATA, 32 Bytes - hash of the parent block.
-    EByteArray parentHash;
+    EHash32 parentHash;
     //DATA, 8 Bytes - hash of the generated proof-of-work. null when its pending block.
-    EByteArray nonce;
+    ENonce8 nonce;
     //DATA, 32 Bytes - SHA3 of the uncles data in the block.
-    EByteArray sha3Uncles;
+    EHash32 sha3Uncles;
     //DATA, 256 Bytes - the bloom filter for the logs of the block. null when its pending block.
-    EByteArray logsBloom;
+    EBloom256 logsBloom;
     //DATA, 32 Bytes - the root of the transaction trie of the block.
-    EByteArray transactionsRoot;
+    EHash32 transactionsRoot;
     //DATA, 32 Bytes - the root of the final state trie of the block.
-    EByteArray stateRoot;
+    EHash32 stateRoot;
     //DATA, 32 Bytes - the root of the receipts trie of the block.
-    EByteArray receiptsRoot;
+    EHash32 receiptsRoot;
     //DATA, 20 Bytes - the address of the beneficiary to whom the mining rewards were given.
-    EByteArray miner;
+    EAddress20 miner;
     //QUANTITY - integer of the difficulty for this block.
     EInt difficulty;
     //QUANTITY - integer of the total difficulty of the chain until this block.
-    EInt totalDifficulty;
+    EUInt256 totalDifficulty;
     //DATA - the "extra data" field of this block.
     EByteArray extraData;
     //QUANTITY - integer the size of this block in bytes.
@@ -249,7 +456,7 @@ public:
     //QUANTITY - the unix timestamp for when the block was collated.
     EInt timestamp;
     //Array - Array of transaction objects, or 32 Bytes transaction hashes depending on the last given parameter.
-    EByteArrayList transactions;
+    ETransactionList transactions;
     //Array - Array of uncle hashes.
     EByteArrayList uncles;
 
@@ -277,15 +484,92 @@ public:
     )
 };
 
+//Array of up to 4 topics of 32 Bytes, stored inline
+class ETopicList : public EValue
+{
+public:
+    ETH_VALUE
+    enum { MaxTopics = 4 };
+
+    ETopicList();
+    inline int count() const { return m_count; }
+    inline const EHash32& at(int index) const { return m_topics[index]; }
+    inline const EHash32& operator[](int index) const { return m_topics[index]; }
+    operator QByteArrayList() const;
+    void fromRawData(const QVariant& rowData) override;
+    QVariant toRawData() const override;
+    void fromJson(JsonReader& reader) override;
+
+private:
+    EHash32 m_topics[MaxTopics];
+    int m_count;
+};
+
+//Object for log data
+class ELog : public EObject{
+public:
+    ELog();
+    //TAG - true when the log was removed, due to a chain reorganization. false if its a valid log.
+    EBool removed;
+    //QUANTITY - integer of the log index position in the block. null when its pending log.
+    EInt logIndex;
+    //QUANTITY - integer of the transactions index position log was created from. null when its pending log.
+    EInt transactionIndex;
+    //DATA, 32 Bytes - hash of the transactions this log was created from. null when its pending log.
+    EHash32 transactionHash;
+    //DATA, 32 Bytes - hash of the block where this log was in. null when its pending.
+    EHash32 blockHash;
+    //QUANTITY - the block number where this log was in. null when its pending.
+    EInt blockNumber;
+    //DATA, 20 Bytes - address from which this log originated.
+    EAddress20 address;
+    //DATA - contains the non-indexed arguments of the log.
+    EByteArray data;
+    //Array of DATA - Array of 0 to 4 32 Bytes DATA of indexed log arguments.
+    ETopicList topics;
+
+    ETH_OBJECT
+    (
+        ETH_PARAM(removed);
+        ETH_PARAM(logIndex);
+        ETH_PARAM(transactionIndex);
+        ETH_PARAM(transactionHash);
+        ETH_PARAM(blockHash);
+        ETH_PARAM(blockNumber);
+        ETH_PARAM(address);
+        ETH_PARAM(data);
+        ETH_PARAM(topics);
+    )
+};
+
+//Array of log objects, stored contiguously
+class ELogList : public EValue
+{
+public:
+    ETH_VALUE
+    ELogList();
+    ELogList(const QVector<ELog>& logs);
+    inline int count() const { return m_value.count(); }
+    inline const ELog& at(int index) const { return m_value.at(index); }
+    inline const ELog& operator[](int index) const { return m_value.at(index); }
+    inline const QVector<ELog>& logs() const { return m_value; }
+    void fromRawData(const QVariant& rowData) override;
+    QVariant toRawData() const override;
+    void fromJson(JsonReader& reader) override;
+
+private:
+    QVector<ELog> m_value;
+};
+
 class EReceipt : public EObject{
 public:
     EReceipt();
     //DATA, 32 Bytes - hash of the transaction.
-    EByteArray transactionHash;
+    EHash32 transactionHash;
     //QUANTITY - integer of the transactions index position in the block.
     EInt transactionIndex;
     //DATA, 32 Bytes - hash of the block where this transaction was in.
-    EByteArray blockHash;
+    EHash32 blockHash;
     //QUANTITY - block number where this transaction was in.
     EInt blockNumber;
     //QUANTITY - The total amount of gas used when this transaction was executed in the block.
@@ -293,9 +577,9 @@ public:
     //QUANTITY - The amount of gas used by this specific transaction alone.
     EInt gasUsed;
     //DATA, 20 Bytes - The contract address created, if the transaction was a contract creation, otherwise null.
-    EByteArray contractAddress;
+    EAddress20 contractAddress;
     //Array - Array of log objects, which this transaction generated.
-    EByteArrayList logs;
+    ELogList logs;
 
     ETH_OBJECT
     (
@@ -385,7 +669,7 @@ class SFilterMessage : public EObject{
 public:
     SFilterMessage();
     //DATA, 32 Bytes - The hash of the message.
-    EByteArray hash;
+    EHash32 hash;
     //DATA, 60 Bytes - The sender of the message, if a sender was specified.
     EByteArray from;
     //DATA, 60 Bytes - The receiver of the message, if a receiver was specified.
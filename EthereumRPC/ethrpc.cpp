@@ -1,11 +1,55 @@
 #include "ethrpc.h"
 #include "iethclient.h"
+#include "ethlocalclient.h"
+#include "ethhttpclient.h"
+#include "ethwebsocketclient.h"
+#include "ethbalancedclient.h"
 #include "jsoncoder.h"
+#include "ethrpc_utils.h"
+#include "ethrpccache.h"
+#include "ethblockstore.h"
+#include "ethheadercache.h"
+#include <QFutureInterface>
+#include <QSharedPointer>
+
+namespace RPC_NS {
+//The reads that can be sent twice without side effect
+bool isHedgeable(const QString& method)
+{
+    static const QSet<QString> methods = []()
+    {
+        QSet<QString> methods;
+        methods.insert("eth_call");
+        methods.insert("eth_estimateGas");
+        methods.insert("eth_getBalance");
+        methods.insert("eth_getStorageAt");
+        methods.insert("eth_getTransactionCount");
+        methods.insert("eth_getCode");
+        methods.insert("eth_getLogs");
+        methods.insert("eth_getBlockByHash");
+        methods.insert("eth_getBlockByNumber");
+        methods.insert("eth_getTransactionByHash");
+        methods.insert("eth_getTransactionByBlockHashAndIndex");
+        methods.insert("eth_getTransactionByBlockNumberAndIndex");
+        methods.insert("eth_getTransactionReceipt");
+        return methods;
+    }();
+    return methods.contains(method);
+}
+}
+using namespace RPC_NS;
 
 class RPC_Private{
 public:
     RPC_Private():
-        m_client(0)
+        m_client(0),
+        m_balanced(0),
+        m_hedging(false),
+        m_batching(false),
+        m_capturing(false),
+        m_capturedMethod(0),
+        m_localHashing(false),
+        m_notifying(false)
     {}
 
     ~RPC_Private()
@@ -14,22 +58,292 @@ public:
             delete m_client;
     }
 
-    bool call_rpc_method(const QString& method, const QVariantList& params, EValue& out)
+    //Create the transport from the scheme of the uri, a path without scheme is an IPC socket
+    static IEthClient* create_client(const QString& uri)
+    {
+        if(uri.startsWith("http://", Qt::CaseInsensitive) || uri.startsWith("https://", Qt::CaseInsensitive))
+            return new EthHttpClient(uri);
+        if(uri.startsWith("ws://", Qt::CaseInsensitive) || uri.startsWith("wss://", Qt::CaseInsensitive))
+            return new EthWebSocketClient(uri);
+        if(uri.startsWith("ipc://", Qt::CaseInsensitive))
+            return new EthLocalClient(uri.mid(6));
+        if(uri.startsWith("file://", Qt::CaseInsensitive))
+            return new EthLocalClient(uri.mid(7));
+        return new EthLocalClient(uri);
+    }
+
+    bool call_rpc_method(const JsonRPCMethod& method, const QVariantList& params, EValue& out)
     {
         bool ret = true;
         int64_t id = 0;
+        QByteArray response;
+        if(m_capturing)
+        {
+            m_capturedMethod = &method;
+            m_capturedParams = params;
+            return true;
+        }
+        if(m_batching)
+        {
+            m_batchMethods.append(&method);
+            m_batchParams.append(QVariant(params));
+            m_batchOutputs.append(&out);
+            return true;
+        }
+        QByteArray cacheKey;
+        if(load_local(m_cache, m_store, m_headers, method, params, out, cacheKey))
+            return true;
+        if(!m_client) return false;
+        encodeJsonRPC(method, params, id, m_request);
+        if(m_hedging && m_balanced && isHedgeable(method.name()))
+            ret = m_balanced->requestingHedgedResponse(m_request, response);
+        else
+            ret = m_client->requestingResponse(m_request, response);
+        if(!ret) return ret;
+        ret &= decodeJsonRPC(response, id, out);
+        if(ret) save_local(m_cache, m_store, method, params, out, cacheKey);
+        return ret;
+    }
+
+    bool call_rpc_batch(QVector<bool>* results)
+    {
+        bool ret = true;
+        QVector<int64_t> ids;
         QByteArray request;
         QByteArray response;
-        QVariant result;
-        request = encodeJsonRPC(method, params, id);
+        QHash<int64_t, EValue*> batchOutputs;
+        QSet<int64_t> decoded;
+        QList<const JsonRPCMethod*> methods = m_batchMethods;
+        QVariantList params = m_batchParams;
+        QList<EValue*> outputs = m_batchOutputs;
+        clear_batch();
+        if(results) results->fill(false, outputs.size());
+        if(outputs.isEmpty()) return true;
+
+        //The calls answered by the cache or the block store are not sent
+        QVector<QByteArray> cacheKeys(outputs.size());
+        QVector<int> sent;
+        QList<const JsonRPCMethod*> sentMethods;
+        QVariantList sentParams;
+        for(int i = 0; i < outputs.size(); i++)
+        {
+            if(load_local(m_cache, m_store, m_headers, *methods[i], params[i].toList(), *outputs[i], cacheKeys[i]))
+            {
+                if(results) (*results)[i] = true;
+                continue;
+            }
+            sent.append(i);
+            sentMethods.append(methods[i]);
+            sentParams.append(params[i]);
+        }
+        if(sent.isEmpty()) return true;
+        if(!m_client) return false;
+
+        request = encodeJsonRPCBatch(sentMethods, sentParams, ids);
         ret = m_client->requestingResponse(request, response);
         if(!ret) return ret;
-        ret &= decodeJsonRPC(response, id, result);
-        out.fromRawData(result);
+        for(int i = 0; i < sent.size(); i++)
+        {
+            batchOutputs.insert(ids[i], outputs[sent[i]]);
+        }
+        ret &= decodeJsonRPCBatch(response, batchOutputs, decoded);
+        for(int i = 0; i < sent.size(); i++)
+        {
+            int index = sent[i];
+            bool found = decoded.contains(ids[i]);
+            if(!found) outputs[index]->fromRawData(QVariant());
+            if(results) (*results)[index] = found;
+            ret &= found;
+            if(found) save_local(m_cache, m_store, *methods[index], params[index].toList(), *outputs[index], cacheKeys[index]);
+        }
         return ret;
     }
 
+    //Run the blocking method to capture its request, then post it without waiting
+    template<class T>
+    QFuture<T> call_rpc_async(const std::function<bool(T&)>& method)
+    {
+        QFutureInterface<T> future;
+        QSharedPointer<T> out(new T());
+        future.reportStarted();
+
+        m_capturing = true;
+        m_capturedMethod = 0;
+        m_capturedParams.clear();
+        bool ret = method(*out);
+        m_capturing = false;
+        //The methods answered locally capture nothing
+        if(ret && !m_capturedMethod)
+        {
+            finish_async(future, *out, true);
+            return future.future();
+        }
+        if(!ret || !m_client)
+        {
+            finish_async(future, *out, false);
+            return future.future();
+        }
+
+        QByteArray cacheKey;
+        QSharedPointer<EthRPCCache> cache = m_cache;
+        QSharedPointer<EthBlockStore> store = m_store;
+        const JsonRPCMethod* rpcMethod = m_capturedMethod;
+        QVariantList params = m_capturedParams;
+        if(load_local(cache, store, m_headers, *rpcMethod, params, *out, cacheKey))
+        {
+            finish_async(future, *out, true);
+            return future.future();
+        }
+
+        int64_t id = 0;
+        QByteArray request;
+        encodeJsonRPC(*rpcMethod, params, id, request);
+        IEthClient::ResponseHandler handler = [future, out, id, cache, store, cacheKey, rpcMethod, params](bool success, const QByteArray& response) mutable
+        {
+            if(success)
+                success = decodeJsonRPC(response, id, *out);
+            else
+                out->fromRawData(QVariant());
+            if(success)
+                RPC_Private::save_local(cache, store, *rpcMethod, params, *out, cacheKey);
+            RPC_Private::finish_async(future, *out, success);
+        };
+        if(m_hedging && m_balanced && isHedgeable(rpcMethod->name()))
+            m_balanced->postHedgedRequest(request, handler);
+        else
+            m_client->postRequest(request, handler);
+        return future.future();
+    }
+
+    template<class T>
+    static void finish_async(QFutureInterface<T>& future, const T& out, bool success)
+    {
+        future.reportResult(out);
+        if(!success)
+            future.reportCanceled();
+        future.reportFinished();
+    }
+
+    //Answer the call from the header cache, the cache or the block store, the key of the cache is returned for save_local
+    static bool load_local(const QSharedPointer<EthRPCCache>& cache, const QSharedPointer<EthBlockStore>& store,
+                           const QSharedPointer<EthHeaderCache>& headers,
+                           const JsonRPCMethod& method, const QVariantList& params, EValue& out, QByteArray& cacheKey)
+    {
+        if(headers && load_head(*headers, method, params, out))
+            return true;
+        if(cache)
+        {
+            cacheKey = EthRPCCache::makeKey(method, params, out);
+            if(!cacheKey.isEmpty() && cache->lookup(cacheKey, out))
+                return true;
+        }
+        if(store && store->loadCall(method, params, out))
+        {
+            if(!cacheKey.isEmpty())
+                cache->insert(cacheKey, out);
+            return true;
+        }
+        return false;
+    }
+
+    //Answer the calls about the head of the chain, the cached blocks hold only the hashes of their transactions
+    static bool load_head(const EthHeaderCache& headers, const JsonRPCMethod& method, const QVariantList& params, EValue& out)
+    {
+        if(method.name() == "eth_blockNumber")
+        {
+            EInt* number = dynamic_cast<EInt*>(&out);
+            int64_t head = headers.headNumber();
+            if(!number || head < 0)
+                return false;
+            *number = EInt(head);
+            return true;
+        }
+        if(method.name() == "eth_getBlockByNumber" && params.value(0).toString() == "latest" && !params.value(1).toBool())
+        {
+            EBlock* block = dynamic_cast<EBlock*>(&out);
+            return block && headers.latest(*block);
+        }
+        return false;
+    }
+
+    //Keep the decoded result in the cache and the block store when it can not change
+    static void save_local(const QSharedPointer<EthRPCCache>& cache, const QSharedPointer<EthBlockStore>& store,
+                           const JsonRPCMethod& method, const QVariantList& params, EValue& out, const QByteArray& cacheKey)
+    {
+        if(!cacheKey.isEmpty() && EthRPCCache::isCacheable(method, out))
+            cache->insert(cacheKey, out);
+        if(store)
+            store->storeCall(method, params, out);
+    }
+
+    //Subscribe with eth_subscribe, the notifications are decoded into an output of the type of the handler
+    template<class T>
+    bool subscribe(const QVariantList& params, const std::function<void(const T&)>& handler, EString& subscriptionId)
+    {
+        if(!m_client || !m_notifying || m_batching || m_capturing)
+        {
+            subscriptionId.fromRawData(QVariant());
+            return false;
+        }
+        if(!call_rpc_method(JSONRPC_METHOD("eth_subscribe"), params, subscriptionId))
+            return false;
+
+        QSharedPointer<T> out(new T());
+        Subscription subscription;
+        subscription.out = out;
+        subscription.notify = [out, handler]() { handler(*out); };
+        m_subscriptions.insert(QString(subscriptionId).toUtf8(), subscription);
+        return true;
+    }
+
+    void dispatch_notification(const QByteArray& notification)
+    {
+        //Hold the subscription, the handler may unsubscribe
+        Subscription current;
+        QByteArray subscriptionId;
+        bool ret = decodeJsonRPCNotification(notification, [this, &current](const QByteArray& id) -> EValue* {
+            QHash<QByteArray, Subscription>::const_iterator it = m_subscriptions.constFind(id);
+            if(it == m_subscriptions.constEnd())
+                return 0;
+            current = it.value();
+            return current.out.data();
+        }, subscriptionId);
+        if(ret)
+            current.notify();
+    }
+
+    void clear_batch()
+    {
+        m_batching = false;
+        m_batchMethods.clear();
+        m_batchParams.clear();
+        m_batchOutputs.clear();
+    }
+
     IEthClient* m_client;
+    //The client when it balance several backends, the reads can be hedged
+    EthBalancedClient* m_balanced;
+    bool m_hedging;
+    QByteArray m_request;
+    bool m_batching;
+    QList<const JsonRPCMethod*> m_batchMethods;
+    QVariantList m_batchParams;
+    QList<EValue*> m_batchOutputs;
+    bool m_capturing;
+    const JsonRPCMethod* m_capturedMethod;
+    QVariantList m_capturedParams;
+    QSharedPointer<EthRPCCache> m_cache;
+    QSharedPointer<EthBlockStore> m_store;
+    QSharedPointer<EthHeaderCache> m_headers;
+    bool m_localHashing;
+
+    struct Subscription
+    {
+        QSharedPointer<EValue> out;
+        std::function<void()> notify;
+    };
+    bool m_notifying;
+    QHash<QByteArray, Subscription> m_subscriptions;
 };
 
 EthRPC::EthRPC():
@@ -44,10 +358,113 @@ EthRPC::~EthRPC()
     m_p = 0;
 }
 
+void EthRPC::beginBatch()
+{
+    m_p->clear_batch();
+    m_p->m_batching = true;
+}
+
+bool EthRPC::sendBatch(QVector<bool>* results)
+{
+    return m_p->call_rpc_batch(results);
+}
+
+void EthRPC::cancelBatch()
+{
+    m_p->clear_batch();
+}
+
+int EthRPC::batchSize() const
+{
+    return m_p->m_batchOutputs.size();
+}
+
+void EthRPC::setCache(const QSharedPointer<EthRPCCache> &cache)
+{
+    m_p->m_cache = cache;
+}
+
+QSharedPointer<EthRPCCache> EthRPC::cache() const
+{
+    return m_p->m_cache;
+}
+
+void EthRPC::setLocalHashing(bool local)
+{
+    m_p->m_localHashing = local;
+}
+
+bool EthRPC::localHashing() const
+{
+    return m_p->m_localHashing;
+}
+
+void EthRPC::setHedging(bool hedging)
+{
+    m_p->m_hedging = hedging;
+}
+
+bool EthRPC::hedging() const
+{
+    return m_p->m_hedging;
+}
+
+void EthRPC::setBlockStore(const QSharedPointer<EthBlockStore> &store)
+{
+    m_p->m_store = store;
+}
+
+QSharedPointer<EthBlockStore> EthRPC::blockStore() const
+{
+    return m_p->m_store;
+}
+
+void EthRPC::setHeaderCache(const QSharedPointer<EthHeaderCache> &headers)
+{
+    m_p->m_headers = headers;
+}
+
+QSharedPointer<EthHeaderCache> EthRPC::headerCache() const
+{
+    return m_p->m_headers;
+}
+
 bool EthRPC::connect(const EString &serverUri)
 {
-    Q_UNUSED(serverUri);
-    return false;
+    return connect(RPC_Private::create_client(serverUri.toRawData().toString()));
+}
+
+bool EthRPC::connect(const QStringList &serverUris)
+{
+    if(serverUris.size() == 1)
+        return connect(RPC_Private::create_client(serverUris[0]));
+
+    QList<IEthClient*> backends;
+    for(int i = 0; i < serverUris.size(); i++)
+        backends.append(RPC_Private::create_client(serverUris[i]));
+    return connect(new EthBalancedClient(backends));
+}
+
+bool EthRPC::connect(IEthClient *client)
+{
+    if(m_p->m_client)
+    {
+        delete m_p->m_client;
+        m_p->m_client = 0;
+        m_p->m_balanced = 0;
+    }
+
+    //The subscriptions do not survive the connection
+    m_p->m_subscriptions.clear();
+    m_p->m_client = client;
+    if(!m_p->m_client)
+        return false;
+    m_p->m_balanced = dynamic_cast<EthBalancedClient*>(client);
+    RPC_Private* p = m_p;
+    m_p->m_notifying = m_p->m_client->setNotificationHandler([p](const QByteArray& notification) {
+        p->dispatch_notification(notification);
+    });
+    return m_p->m_client->connectToServer();
 }
 
 /*
@@ -63,7 +480,7 @@ curl -X POST --data '{"jsonrpc":"2.0","method":"web3_clientVersion","params":[],
 */
 bool EthRPC::web3_clientVersion(EString &clientVersion)
 {
-    return m_p->call_rpc_method("web3_clientVersion", QVariantList(), clientVersion);
+    return m_p->call_rpc_method(JSONRPC_METHOD("web3_clientVersion"), QVariantList(), clientVersion);
 }
 
 /*
@@ -79,9 +496,14 @@ curl -X POST --data '{"jsonrpc":"2.0","method":"web3_sha3","params":["0x68656c6c
 */
 bool EthRPC::web3_sha3(const EByteArray &rowData, EByteArray &hash)
 {
+    if(m_p->m_localHashing)
+    {
+        hash = keccak256(rowData);
+        return true;
+    }
     QVariantList params;
     params.append(rowData.toRawData());
-    return m_p->call_rpc_method("web3_sha3", params, hash);
+    return m_p->call_rpc_method(JSONRPC_METHOD("web3_sha3"), params, hash);
 }
 
 /*
@@ -97,7 +519,7 @@ curl -X POST --data '{"jsonrpc":"2.0","method":"net_version","params":[],"id":67
 */
 bool EthRPC::net_version(EString &clientVersion)
 {
-    return m_p->call_rpc_method("net_version", QVariantList(), clientVersion);
+    return m_p->call_rpc_method(JSONRPC_METHOD("net_version"), QVariantList(), clientVersion);
 }
 
 /*
@@ -113,7 +535,7 @@ curl -X POST --data '{"jsonrpc":"2.0","method":"net_listening","params":[],"id":
 */
 bool EthRPC::net_listening(EBool &isListening)
 {
-    return m_p->call_rpc_method("net_listening", QVariantList(), isListening);
+    return m_p->call_rpc_method(JSONRPC_METHOD("net_listening"), QVariantList(), isListening);
 }
 
 /*
@@ -129,7 +551,7 @@ curl -X POST --data '{"jsonrpc":"2.0","method":"net_peerCount","params":[],"id":
 */
 bool EthRPC::net_peerCount(EInt &numberConnected)
 {
-    return m_p->call_rpc_method("net_peerCount", QVariantList(), numberConnected);
+    return m_p->call_rpc_method(JSONRPC_METHOD("net_peerCount"), QVariantList(), numberConnected);
 }
 
 /*
@@ -145,7 +567,7 @@ curl -X POST --data '{"jsonrpc":"2.0","method":"eth_protocolVersion","params":[]
 */
 bool EthRPC::eth_protocolVersion(EString &clientVersion)
 {
-    return m_p->call_rpc_method("eth_protocolVersion", QVariantList(), clientVersion);
+    return m_p->call_rpc_method(JSONRPC_METHOD("eth_protocolVersion"), QVariantList(), clientVersion);
 }
 
 /*
@@ -171,7 +593,7 @@ curl -X POST --data '{"jsonrpc":"2.0","method":"eth_syncing","params":[],"id":1}
 */
 bool EthRPC::eth_syncing(ESyncing &syncing)
 {
-    return m_p->call_rpc_method("eth_syncing", QVariantList(), syncing);
+    return m_p->call_rpc_method(JSONRPC_METHOD("eth_syncing"), QVariantList(), syncing);
 }
 
 /*
@@ -187,7 +609,7 @@ curl -X POST --data '{"jsonrpc":"2.0","method":"eth_coinbase","params":[],"id":6
 */
 bool EthRPC::eth_coinbase(EByteArray &coinbaseAddress)
 {
-    return m_p->call_rpc_method("eth_coinbase", QVariantList(), coinbaseAddress);
+    return m_p->call_rpc_method(JSONRPC_METHOD("eth_coinbase"), QVariantList(), coinbaseAddress);
 }
 
 /*
@@ -203,7 +625,7 @@ curl -X POST --data '{"jsonrpc":"2.0","method":"eth_mining","params":[],"id":71}
 */
 bool EthRPC::eth_mining(EBool &isMining)
 {
-    return m_p->call_rpc_method("eth_mining", QVariantList(), isMining);
+    return m_p->call_rpc_method(JSONRPC_METHOD("eth_mining"), QVariantList(), isMining);
 }
 
 /*
@@ -219,7 +641,7 @@ curl -X POST --data '{"jsonrpc":"2.0","method":"eth_hashrate","params":[],"id":7
 */
 bool EthRPC::eth_hashrate(EInt &hashesPerSec)
 {
-    return m_p->call_rpc_method("eth_hashrate", QVariantList(), hashesPerSec);
+    return m_p->call_rpc_method(JSONRPC_METHOD("eth_hashrate"), QVariantList(), hashesPerSec);
 }
 
 /*
@@ -235,7 +657,7 @@ curl -X POST --data '{"jsonrpc":"2.0","method":"eth_gasPrice","params":[],"id":7
 */
 bool EthRPC::eth_gasPrice(EInt &currentGasPrice)
 {
-    return m_p->call_rpc_method("eth_gasPrice", QVariantList(), currentGasPrice);
+    return m_p->call_rpc_method(JSONRPC_METHOD("eth_gasPrice"), QVariantList(), currentGasPrice);
 }
 
 /*
@@ -251,7 +673,7 @@ curl -X POST --data '{"jsonrpc":"2.0","method":"eth_accounts","params":[],"id":1
 */
 bool EthRPC::eth_accounts(EByteArrayList &ethAddresses)
 {
-    return m_p->call_rpc_method("eth_accounts", QVariantList(), ethAddresses);
+    return m_p->call_rpc_method(JSONRPC_METHOD("eth_accounts"), QVariantList(), ethAddresses);
 }
 
 /*
@@ -267,7 +689,7 @@ curl -X POST --data '{"jsonrpc":"2.0","method":"eth_blockNumber","params":[],"id
 */
 bool EthRPC::eth_blockNumber(EInt &currentBlockNumber)
 {
-    return m_p->call_rpc_method("eth_blockNumber", QVariantList(), currentBlockNumber);
+    return m_p->call_rpc_method(JSONRPC_METHOD("eth_blockNumber"), QVariantList(), currentBlockNumber);
 }
 
 /*
@@ -281,12 +703,12 @@ curl -X POST --data '{"jsonrpc":"2.0","method":"eth_getBalance","params":["0x407
   "result": "0x0234c8a3397aab58" // 158972490234375000
 }
 */
-bool EthRPC::eth_getBalance(const EByteArray &ethAddress, const EVariant& blockId, EInt &currentBalance)
+bool EthRPC::eth_getBalance(const EByteArray &ethAddress, const EVariant& blockId, EUInt256 &currentBalance)
 {
     QVariantList params;
     params.append(ethAddress.toRawData());
     params.append(blockId.toRawData());
-    return m_p->call_rpc_method("eth_getBalance", params, currentBalance);
+    return m_p->call_rpc_method(JSONRPC_METHOD("eth_getBalance"), params, currentBalance);
 }
 
 /*
@@ -306,7 +728,7 @@ bool EthRPC::eth_getStorageAt(const EByteArray &storageAddress, const EInt &posi
     params.append(storageAddress.toRawData());
     params.append(position.toRawData());
     params.append(blockId.toRawData());
-    return m_p->call_rpc_method("eth_getStorageAt", params, value);
+    return m_p->call_rpc_method(JSONRPC_METHOD("eth_getStorageAt"), params, value);
 }
 
 /*
@@ -325,7 +747,7 @@ bool EthRPC::eth_getTransactionCount(const EByteArray &ethAddress, const EVarian
     QVariantList params;
     params.append(ethAddress.toRawData());
     params.append(blockId.toRawData());
-    return m_p->call_rpc_method("eth_getTransactionCount", params, numberTransactions);
+    return m_p->call_rpc_method(JSONRPC_METHOD("eth_getTransactionCount"), params, numberTransactions);
 }
 
 /*
@@ -343,7 +765,7 @@ bool EthRPC::eth_getBlockTransactionCountByHash(const EByteArray &hashBlock, EIn
 {
     QVariantList params;
     params.append(hashBlock.toRawData());
-    return m_p->call_rpc_method("eth_getBlockTransactionCountByHash", params, numberTransactions);
+    return m_p->call_rpc_method(JSONRPC_METHOD("eth_getBlockTransactionCountByHash"), params, numberTransactions);
 }
 
 /*
@@ -361,7 +783,7 @@ bool EthRPC::eth_getBlockTransactionCountByNumber(const EVariant& blockId, EInt
 {
     QVariantList params;
     params.append(blockId.toRawData());
-    return m_p->call_rpc_method("eth_getBlockTransactionCountByNumber", params, numberTransactions);
+    return m_p->call_rpc_method(JSONRPC_METHOD("eth_getBlockTransactionCountByNumber"), params, numberTransactions);
 }
 
 /*
@@ -379,7 +801,7 @@ bool EthRPC::eth_getUncleCountByBlockHash(const EByteArray &hashBlock, EInt &num
 {
     QVariantList params;
     params.append(hashBlock.toRawData());
-    return m_p->call_rpc_method("eth_getUncleCountByBlockHash", params, numberUncles);
+    return m_p->call_rpc_method(JSONRPC_METHOD("eth_getUncleCountByBlockHash"), params, numberUncles);
 }
 
 /*
@@ -397,7 +819,7 @@ bool EthRPC::eth_getUncleCountByBlockNumber(const EVariant& blockId, EInt &numbe
 {
     QVariantList params;
     params.append(blockId.toRawData());
-    return m_p->call_rpc_method("eth_getUncleCountByBlockNumber", params, numberUncles);
+    return m_p->call_rpc_method(JSONRPC_METHOD("eth_getUncleCountByBlockNumber"), params, numberUncles);
 }
 
 /*
@@ -416,7 +838,7 @@ bool EthRPC::eth_getCode(const EByteArray &ethAddress, const EVariant& blockId,
     QVariantList params;
     params.append(ethAddress.toRawData());
     params.append(blockId.toRawData());
-    return m_p->call_rpc_method("eth_getCode", params, addressCode);
+    return m_p->call_rpc_method(JSONRPC_METHOD("eth_getCode"), params, addressCode);
 }
 
 /*
@@ -435,7 +857,7 @@ bool EthRPC::eth_sign(const EByteArray &ethAddress, const EByteArray &plainData,
     QVariantList params;
     params.append(ethAddress.toRawData());
     params.append(plainData.toRawData());
-    return m_p->call_rpc_method("eth_sign", params, cipheredData);
+    return m_p->call_rpc_method(JSONRPC_METHOD("eth_sign"), params, cipheredData);
 }
 
 /*
@@ -462,7 +884,7 @@ bool EthRPC::eth_sendTransaction(const ETransaction &transaction, EByteArray &tr
 {
     QVariantList params;
     params.append(transaction.toRawData());
-    return m_p->call_rpc_method("eth_sendTransaction", params, transactionHash);
+    return m_p->call_rpc_method(JSONRPC_METHOD("eth_sendTransaction"), params, transactionHash);
 }
 
 /*
@@ -482,7 +904,7 @@ bool EthRPC::eth_sendRawTransaction(const EByteArray &signedData, EByteArray &tr
 {
     QVariantList params;
     params.append(signedData.toRawData());
-    return m_p->call_rpc_method("eth_sendRawTransaction", params, transactionHash);
+    return m_p->call_rpc_method(JSONRPC_METHOD("eth_sendRawTransaction"), params, transactionHash);
 }
 
 /*
@@ -501,7 +923,7 @@ bool EthRPC::eth_call(const ETransaction &transaction, const EVariant& blockId,
     QVariantList params;
     params.append(transaction.toRawData());
     params.append(blockId.toRawData());
-    return m_p->call_rpc_method("eth_call", params, returnValue);
+    return m_p->call_rpc_method(JSONRPC_METHOD("eth_call"), params, returnValue);
 }
 
 /*
@@ -520,7 +942,7 @@ bool EthRPC::eth_estimateGas(const ETransaction &transaction, const EInt &blockN
     QVariantList params;
     params.append(transaction.toRawData());
     params.append(blockNumber.toRawData());
-    return m_p->call_rpc_method("eth_estimateGas", params, gasUsed);
+    return m_p->call_rpc_method(JSONRPC_METHOD("eth_estimateGas"), params, gasUsed);
 }
 
 /*
@@ -539,7 +961,7 @@ bool EthRPC::eth_estimateGas(const ETransaction &transaction, const EString &blo
     QVariantList params;
     params.append(transaction.toRawData());
     params.append(blockTag.toRawData());
-    return m_p->call_rpc_method("eth_estimateGas", params, gasUsed);
+    return m_p->call_rpc_method(JSONRPC_METHOD("eth_estimateGas"), params, gasUsed);
 }
 
 /*
@@ -578,7 +1000,7 @@ bool EthRPC::eth_getBlockByHash(const EByteArray &hashBlock, const EBool &full,
     QVariantList params;
     params.append(hashBlock.toRawData());
     params.append(full.toRawData());
-    return m_p->call_rpc_method("eth_getBlockByHash", params, block);
+    return m_p->call_rpc_method(JSONRPC_METHOD("eth_getBlockByHash"), params, block);
 }
 
 /*
@@ -590,7 +1012,7 @@ bool EthRPC::eth_getBlockByNumber(const EVariant &blockId, const EBool &full, EB
     QVariantList params;
     params.append(blockId.toRawData());
     params.append(full.toRawData());
-    return m_p->call_rpc_method("eth_getBlockByNumber", params, block);
+    return m_p->call_rpc_method(JSONRPC_METHOD("eth_getBlockByNumber"), params, block);
 }
 
 /*
@@ -620,7 +1042,7 @@ bool EthRPC::eth_getTransactionByHash(const EByteArray &transactionHash, ETransa
 {
     QVariantList params;
     params.append(transactionHash.toRawData());
-    return m_p->call_rpc_method("eth_getTransactionByHash", params, transaction);
+    return m_p->call_rpc_method(JSONRPC_METHOD("eth_getTransactionByHash"), params, transaction);
 }
 
 /*
@@ -632,7 +1054,7 @@ bool EthRPC::eth_getTransactionByBlockHashAndIndex(const EByteArray &hashBlock,
     QVariantList params;
     params.append(hashBlock.toRawData());
     params.append(transactionIndex.toRawData());
-    return m_p->call_rpc_method("eth_getTransactionByBlockHashAndIndex", params, transaction);
+    return m_p->call_rpc_method(JSONRPC_METHOD("eth_getTransactionByBlockHashAndIndex"), params, transaction);
 }
 
 /*
@@ -644,7 +1066,7 @@ bool EthRPC::eth_getTransactionByBlockNumberAndIndex(const EVariant &blockId, co
     QVariantList params;
     params.append(blockId.toRawData());
     params.append(transactionIndex.toRawData());
-    return m_p->call_rpc_method("eth_getTransactionByBlockNumberAndIndex", params, transaction);
+    return m_p->call_rpc_method(JSONRPC_METHOD("eth_getTransactionByBlockNumberAndIndex"), params, transaction);
 }
 
 /*
@@ -673,7 +1095,7 @@ bool EthRPC::eth_getTransactionReceipt(const EByteArray &transactionHash, ERecei
 {
     QVariantList params;
     params.append(transactionHash.toRawData());
-    return m_p->call_rpc_method("eth_getTransactionReceipt", params, receipt);
+    return m_p->call_rpc_method(JSONRPC_METHOD("eth_getTransactionReceipt"), params, receipt);
 }
 
 /*
@@ -685,7 +1107,7 @@ bool EthRPC::eth_getUncleByBlockHashAndIndex(const EByteArray &hashBlock, const
     QVariantList params;
     params.append(hashBlock.toRawData());
     params.append(possition.toRawData());
-    return m_p->call_rpc_method("eth_getUncleByBlockHashAndIndex", params, block);
+    return m_p->call_rpc_method(JSONRPC_METHOD("eth_getUncleByBlockHashAndIndex"), params, block);
 }
 
 /*
@@ -697,7 +1119,7 @@ bool EthRPC::eth_getUncleByBlockNumberAndIndex(const EVariant &blockId, const EI
     QVariantList params;
     params.append(blockId.toRawData());
     params.append(possition.toRawData());
-    return m_p->call_rpc_method("eth_getUncleByBlockNumberAndIndex", params, block);
+    return m_p->call_rpc_method(JSONRPC_METHOD("eth_getUncleByBlockNumberAndIndex"), params, block);
 }
 
 /*
@@ -765,7 +1187,7 @@ bool EthRPC::eth_compileSolidity(const EString &sourceCode, EString &compiledCod
 {
     QVariantList params;
     params.append(sourceCode.toRawData());
-    return m_p->call_rpc_method("eth_compileSolidity", params, compiledCode);
+    return m_p->call_rpc_method(JSONRPC_METHOD("eth_compileSolidity"), params, compiledCode);
 }
 
 /*
@@ -783,7 +1205,7 @@ bool EthRPC::eth_compileLLL(const EString &sourceCode, EString &compiledCode)
 {
     QVariantList params;
     params.append(sourceCode.toRawData());
-    return m_p->call_rpc_method("eth_compileLLL", params, compiledCode);
+    return m_p->call_rpc_method(JSONRPC_METHOD("eth_compileLLL"), params, compiledCode);
 }
 
 /*
@@ -801,7 +1223,7 @@ bool EthRPC::eth_compileSerpent(const EString &sourceCode, EString &compiledCode
 {
     QVariantList params;
     params.append(sourceCode.toRawData());
-    return m_p->call_rpc_method("eth_compileSerpent", params, compiledCode);
+    return m_p->call_rpc_method(JSONRPC_METHOD("eth_compileSerpent"), params, compiledCode);
 }
 
 /*
@@ -826,7 +1248,7 @@ bool EthRPC::eth_newFilter(const EFilter &filter, EInt &filterId)
 {
     QVariantList params;
     params.append(filter.toRawData());
-    return m_p->call_rpc_method("eth_newFilter", params, filterId);
+    return m_p->call_rpc_method(JSONRPC_METHOD("eth_newFilter"), params, filterId);
 }
 
 /*
@@ -842,7 +1264,7 @@ curl -X POST --data '{"jsonrpc":"2.0","method":"eth_newBlockFilter","params":[],
 */
 bool EthRPC::eth_newBlockFilter(EInt &filterId)
 {
-    return m_p->call_rpc_method("eth_newBlockFilter", QVariantList(), filterId);
+    return m_p->call_rpc_method(JSONRPC_METHOD("eth_newBlockFilter"), QVariantList(), filterId);
 }
 
 /*
@@ -858,7 +1280,7 @@ curl -X POST --data '{"jsonrpc":"2.0","method":"eth_newPendingTransactionFilter"
 */
 bool EthRPC::eth_newPendingTransactionFilter(EInt &filterId)
 {
-    return m_p->call_rpc_method("eth_newPendingTransactionFilter", QVariantList(), filterId);
+    return m_p->call_rpc_method(JSONRPC_METHOD("eth_newPendingTransactionFilter"), QVariantList(), filterId);
 }
 
 /*
@@ -876,7 +1298,7 @@ bool EthRPC::eth_uninstallFilter(const EInt &filterId, EBool &uninstalled)
 {
     QVariantList params;
     params.append(filterId.toRawData());
-    return m_p->call_rpc_method("eth_uninstallFilter", params, uninstalled);
+    return m_p->call_rpc_method(JSONRPC_METHOD("eth_uninstallFilter"), params, uninstalled);
 }
 
 /*
@@ -905,7 +1327,14 @@ bool EthRPC::eth_getFilterChanges(const EInt &filterId, EByteArrayList &logs)
 {
     QVariantList params;
     params.append(filterId.toRawData());
-    return m_p->call_rpc_method("eth_getFilterChanges", params, logs);
+    return m_p->call_rpc_method(JSONRPC_METHOD("eth_getFilterChanges"), params, logs);
+}
+
+bool EthRPC::eth_getFilterChanges(const EInt &filterId, ELogList &logs)
+{
+    QVariantList params;
+    params.append(filterId.toRawData());
+    return m_p->call_rpc_method(JSONRPC_METHOD("eth_getFilterChanges"), params, logs);
 }
 
 /*
@@ -916,7 +1345,100 @@ bool EthRPC::eth_getFilterLogs(const EInt &filterId, EByteArrayList &logs)
 {
     QVariantList params;
     params.append(filterId.toRawData());
-    return m_p->call_rpc_method("eth_getFilterLogs", params, logs);
+    return m_p->call_rpc_method(JSONRPC_METHOD("eth_getFilterLogs"), params, logs);
+}
+
+bool EthRPC::eth_getFilterLogs(const EInt &filterId, ELogList &logs)
+{
+    QVariantList params;
+    params.append(filterId.toRawData());
+    return m_p->call_rpc_method(JSONRPC_METHOD("eth_getFilterLogs"), params, logs);
+}
+
+/*
+// Request
+curl -X POST --data '{"jsonrpc":"2.0","method":"eth_getLogs","params":[{"topics":["0x000000000000000000000000a94f5374fce5edbc8e2a8697c15331677e6ebf0b"]}],"id":74}'
+*/
+bool EthRPC::eth_getLogs(const EFilter &filter, ELogList &logs)
+{
+    QVariantList params;
+    params.append(filter.toRawData());
+    return m_p->call_rpc_method(JSONRPC_METHOD("eth_getLogs"), params, logs);
+}
+
+/*
+// Request
+{"jsonrpc":"2.0","method":"eth_subscribe","params":["newHeads"],"id":1}
+
+// Result
+{
+  "id":1,
+  "jsonrpc":"2.0",
+  "result": "0x9cef478923ff08bf67fde6c64013158d"
+}
+
+// Notification
+{
+  "jsonrpc":"2.0",
+  "method":"eth_subscription",
+  "params": {
+    "subscription":"0x9cef478923ff08bf67fde6c64013158d",
+    "result": {
+      "number":"0x1b4",
+      "hash":"0x...",
+      ...
+    }
+  }
+}
+*/
+bool EthRPC::eth_subscribeNewHeads(const HeadHandler &handler, EString &subscriptionId)
+{
+    QVariantList params;
+    params.append("newHeads");
+    return m_p->subscribe<EBlock>(params, handler, subscriptionId);
+}
+
+/*
+// Request
+{"jsonrpc":"2.0","method":"eth_subscribe","params":["logs",{"address":"0x8320fe7702b96808f7bbc0d4a888ed1468216cfd","topics":["0xd78a0cb8bb633d06981248b816e7bd33c2a35a6089241d099fa519e361cab902"]}],"id":2}
+*/
+bool EthRPC::eth_subscribeLogs(const EFilter &filter, const LogHandler &handler, EString &subscriptionId)
+{
+    QVariantList params;
+    params.append("logs");
+    params.append(filter.toRawData());
+    return m_p->subscribe<ELog>(params, handler, subscriptionId);
+}
+
+/*
+// Request
+{"jsonrpc":"2.0","method":"eth_subscribe","params":["newPendingTransactions"],"id":3}
+*/
+bool EthRPC::eth_subscribeNewPendingTransactions(const PendingTransactionHandler &handler, EString &subscriptionId)
+{
+    QVariantList params;
+    params.append("newPendingTransactions");
+    return m_p->subscribe<EHash32>(params, handler, subscriptionId);
+}
+
+/*
+// Request
+{"jsonrpc":"2.0","method":"eth_unsubscribe","params":["0x9cef478923ff08bf67fde6c64013158d"],"id":4}
+
+// Result
+{
+  "id":4,
+  "jsonrpc":"2.0",
+  "result": true
+}
+*/
+bool EthRPC::eth_unsubscribe(const EString &subscriptionId, EBool &unsubscribed)
+{
+    //The notifications already in flight are dropped
+    m_p->m_subscriptions.remove(subscriptionId.toRawData().toString().toUtf8());
+    QVariantList params;
+    params.append(subscriptionId.toRawData());
+    return m_p->call_rpc_method(JSONRPC_METHOD("eth_unsubscribe"), params, unsubscribed);
 }
 
 /*
@@ -936,7 +1458,7 @@ curl -X POST --data '{"jsonrpc":"2.0","method":"eth_getWork","params":[],"id":73
 */
 bool EthRPC::eth_getWork(EByteArrayList &properties)
 {
-    return m_p->call_rpc_method("eth_getWork", QVariantList(), properties);
+    return m_p->call_rpc_method(JSONRPC_METHOD("eth_getWork"), QVariantList(), properties);
 }
 
 /*
@@ -956,7 +1478,7 @@ bool EthRPC::eth_submitWork(const EByteArray &nonce, const EByteArray &powHash,
     params.append(nonce.toRawData());
     params.append(powHash.toRawData());
     params.append(mixDigest.toRawData());
-    return m_p->call_rpc_method("eth_submitWork", params, isValid);
+    return m_p->call_rpc_method(JSONRPC_METHOD("eth_submitWork"), params, isValid);
 }
 
 /*
@@ -975,7 +1497,7 @@ bool EthRPC::eth_submitHashrate(const EByteArray &hashrate, const EByteArray &ID
     QVariantList params;
     params.append(hashrate.toRawData());
     params.append(ID.toRawData());
-    return m_p->call_rpc_method("eth_submitHashrate", params, isSubmited);
+    return m_p->call_rpc_method(JSONRPC_METHOD("eth_submitHashrate"), params, isSubmited);
 }
 
 /*
@@ -995,7 +1517,7 @@ bool EthRPC::db_putString(const EString &databaseName, const EString &keyName, c
     params.append(databaseName.toRawData());
     params.append(keyName.toRawData());
     params.append(stringValue.toRawData());
-    return m_p->call_rpc_method("db_putString", params, isStored);
+    return m_p->call_rpc_method(JSONRPC_METHOD("db_putString"), params, isStored);
 }
 
 /*
@@ -1014,7 +1536,7 @@ bool EthRPC::db_getString(const EString &databaseName, const EString &keyName, E
     QVariantList params;
     params.append(databaseName.toRawData());
     params.append(keyName.toRawData());
-    return m_p->call_rpc_method("db_getString", params, stringValue);
+    return m_p->call_rpc_method(JSONRPC_METHOD("db_getString"), params, stringValue);
 }
 
 /*
@@ -1034,7 +1556,7 @@ bool EthRPC::db_putHex(const EString &databaseName, const EString &keyName, cons
     params.append(databaseName.toRawData());
     params.append(keyName.toRawData());
     params.append(hexValue.toRawData());
-    return m_p->call_rpc_method("db_putHex", params, isStored);
+    return m_p->call_rpc_method(JSONRPC_METHOD("db_putHex"), params, isStored);
 }
 
 /*
@@ -1053,7 +1575,7 @@ bool EthRPC::db_getHex(const EString &databaseName, const EString &keyName, EByt
     QVariantList params;
     params.append(databaseName.toRawData());
     params.append(keyName.toRawData());
-    return m_p->call_rpc_method("db_getHex", params, hexValue);
+    return m_p->call_rpc_method(JSONRPC_METHOD("db_getHex"), params, hexValue);
 }
 
 /*
@@ -1071,7 +1593,7 @@ bool EthRPC::shh_post(const SWhisper &message, EBool &wasSend)
 {
     QVariantList params;
     params.append(message.toRawData());
-    return m_p->call_rpc_method("shh_post", params, wasSend);
+    return m_p->call_rpc_method(JSONRPC_METHOD("shh_post"), params, wasSend);
 }
 
 /*
@@ -1087,7 +1609,7 @@ curl -X POST --data '{"jsonrpc":"2.0","method":"shh_newIdentity","params":[],"id
 */
 bool EthRPC::shh_newIdentity(EByteArray &address)
 {
-    return m_p->call_rpc_method("shh_newIdentity", QVariantList(), address);
+    return m_p->call_rpc_method(JSONRPC_METHOD("shh_newIdentity"), QVariantList(), address);
 }
 
 /*
@@ -1105,7 +1627,7 @@ bool EthRPC::shh_hasIdentity(const EByteArray &address, EBool &hasIdentity)
 {
     QVariantList params;
     params.append(address.toRawData());
-    return m_p->call_rpc_method("shh_hasIdentity", params, hasIdentity);
+    return m_p->call_rpc_method(JSONRPC_METHOD("shh_hasIdentity"), params, hasIdentity);
 }
 
 /*
@@ -1121,7 +1643,7 @@ curl -X POST --data '{"jsonrpc":"2.0","method":"shh_newIdentity","params":[],"id
 */
 bool EthRPC::shh_newGroup(EByteArray &address)
 {
-    return m_p->call_rpc_method("shh_newGroup", QVariantList(), address);
+    return m_p->call_rpc_method(JSONRPC_METHOD("shh_newGroup"), QVariantList(), address);
 }
 
 /*
@@ -1139,7 +1661,7 @@ bool EthRPC::shh_addToGroup(const EByteArray &address, EBool &wasAdded)
 {
     QVariantList params;
     params.append(address.toRawData());
-    return m_p->call_rpc_method("shh_addToGroup", params, wasAdded);
+    return m_p->call_rpc_method(JSONRPC_METHOD("shh_addToGroup"), params, wasAdded);
 }
 
 /*
@@ -1157,7 +1679,7 @@ bool EthRPC::shh_newFilter(const SFilter &filter, EInt &filterId)
 {
     QVariantList params;
     params.append(filter.toRawData());
-    return m_p->call_rpc_method("shh_newFilter", params, filterId);
+    return m_p->call_rpc_method(JSONRPC_METHOD("shh_newFilter"), params, filterId);
 }
 
 /*
@@ -1199,3 +1721,303 @@ bool EthRPC::shh_getMessages(const EInt &filterId, QList<SFilterMessage> &messag
     */
     return false;
 }
+
+QFuture<EString> EthRPC::web3_clientVersionAsync()
+{
+    return m_p->call_rpc_async<EString>([&](EString& out) { return web3_clientVersion(out); });
+}
+
+QFuture<EByteArray> EthRPC::web3_sha3Async(const EByteArray &rowData)
+{
+    return m_p->call_rpc_async<EByteArray>([&](EByteArray& out) { return web3_sha3(rowData, out); });
+}
+
+QFuture<EString> EthRPC::net_versionAsync()
+{
+    return m_p->call_rpc_async<EString>([&](EString& out) { return net_version(out); });
+}
+
+QFuture<EBool> EthRPC::net_listeningAsync()
+{
+    return m_p->call_rpc_async<EBool>([&](EBool& out) { return net_listening(out); });
+}
+
+QFuture<EInt> EthRPC::net_peerCountAsync()
+{
+    return m_p->call_rpc_async<EInt>([&](EInt& out) { return net_peerCount(out); });
+}
+
+QFuture<EString> EthRPC::eth_protocolVersionAsync()
+{
+    return m_p->call_rpc_async<EString>([&](EString& out) { return eth_protocolVersion(out); });
+}
+
+QFuture<ESyncing> EthRPC::eth_syncingAsync()
+{
+    return m_p->call_rpc_async<ESyncing>([&](ESyncing& out) { return eth_syncing(out); });
+}
+
+QFuture<EByteArray> EthRPC::eth_coinbaseAsync()
+{
+    return m_p->call_rpc_async<EByteArray>([&](EByteArray& out) { return eth_coinbase(out); });
+}
+
+QFuture<EBool> EthRPC::eth_miningAsync()
+{
+    return m_p->call_rpc_async<EBool>([&](EBool& out) { return eth_mining(out); });
+}
+
+QFuture<EInt> EthRPC::eth_hashrateAsync()
+{
+    return m_p->call_rpc_async<EInt>([&](EInt& out) { return eth_hashrate(out); });
+}
+
+QFuture<EInt> EthRPC::eth_gasPriceAsync()
+{
+    return m_p->call_rpc_async<EInt>([&](EInt& out) { return eth_gasPrice(out); });
+}
+
+QFuture<EByteArrayList> EthRPC::eth_accountsAsync()
+{
+    return m_p->call_rpc_async<EByteArrayList>([&](EByteArrayList& out) { return eth_accounts(out); });
+}
+
+QFuture<EInt> EthRPC::eth_blockNumberAsync()
+{
+    return m_p->call_rpc_async<EInt>([&](EInt& out) { return eth_blockNumber(out); });
+}
+
+QFuture<EUInt256> EthRPC::eth_getBalanceAsync(const EByteArray &ethAddress, const EVariant &blockId)
+{
+    return m_p->call_rpc_async<EUInt256>([&](EUInt256& out) { return eth_getBalance(ethAddress, blockId, out); });
+}
+
+QFuture<EByteArray> EthRPC::eth_getStorageAtAsync(const EByteArray &storageAddress, const EInt &position, const EVariant &blockId)
+{
+    return m_p->call_rpc_async<EByteArray>([&](EByteArray& out) { return eth_getStorageAt(storageAddress, position, blockId, out); });
+}
+
+QFuture<EInt> EthRPC::eth_getTransactionCountAsync(const EByteArray &ethAddress, const EVariant &blockId)
+{
+    return m_p->call_rpc_async<EInt>([&](EInt& out) { return eth_getTransactionCount(ethAddress, blockId, out); });
+}
+
+QFuture<EInt> EthRPC::eth_getBlockTransactionCountByHashAsync(const EByteArray &hashBlock)
+{
+    return m_p->call_rpc_async<EInt>([&](EInt& out) { return eth_getBlockTransactionCountByHash(hashBlock, out); });
+}
+
+QFuture<EInt> EthRPC::eth_getBlockTransactionCountByNumberAsync(const EVariant &blockId)
+{
+    return m_p->call_rpc_async<EInt>([&](EInt& out) { return eth_getBlockTransactionCountByNumber(blockId, out); });
+}
+
+QFuture<EInt> EthRPC::eth_getUncleCountByBlockHashAsync(const EByteArray &hashBlock)
+{
+    return m_p->call_rpc_async<EInt>([&](EInt& out) { return eth_getUncleCountByBlockHash(hashBlock, out); });
+}
+
+QFuture<EInt> EthRPC::eth_getUncleCountByBlockNumberAsync(const EVariant &blockId)
+{
+    return m_p->call_rpc_async<EInt>([&](EInt& out) { return eth_getUncleCountByBlockNumber(blockId, out); });
+}
+
+QFuture<EByteArray> EthRPC::eth_getCodeAsync(const EByteArray &ethAddress, const EVariant &blockId)
+{
+    return m_p->call_rpc_async<EByteArray>([&](EByteArray& out) { return eth_getCode(ethAddress, blockId, out); });
+}
+
+QFuture<EByteArray> EthRPC::eth_signAsync(const EByteArray &ethAddress, const EByteArray &plainData)
+{
+    return m_p->call_rpc_async<EByteArray>([&](EByteArray& out) { return eth_sign(ethAddress, plainData, out); });
+}
+
+QFuture<EByteArray> EthRPC::eth_sendTransactionAsync(const ETransaction &transaction)
+{
+    return m_p->call_rpc_async<EByteArray>([&](EByteArray& out) { return eth_sendTransaction(transaction, out); });
+}
+
+QFuture<EByteArray> EthRPC::eth_sendRawTransactionAsync(const EByteArray &signedData)
+{
+    return m_p->call_rpc_async<EByteArray>([&](EByteArray& out) { return eth_sendRawTransaction(signedData, out); });
+}
+
+QFuture<EByteArray> EthRPC::eth_callAsync(const ETransaction &transaction, const EVariant &blockId)
+{
+    return m_p->call_rpc_async<EByteArray>([&](EByteArray& out) { return eth_call(transaction, blockId, out); });
+}
+
+QFuture<EInt> EthRPC::eth_estimateGasAsync(const ETransaction &transaction, const EInt &blockNumber)
+{
+    return m_p->call_rpc_async<EInt>([&](EInt& out) { return eth_estimateGas(transaction, blockNumber, out); });
+}
+
+QFuture<EInt> EthRPC::eth_estimateGasAsync(const ETransaction &transaction, const EString &blockTag)
+{
+    return m_p->call_rpc_async<EInt>([&](EInt& out) { return eth_estimateGas(transaction, blockTag, out); });
+}
+
+QFuture<EBlock> EthRPC::eth_getBlockByHashAsync(const EByteArray &hashBlock, const EBool &full)
+{
+    return m_p->call_rpc_async<EBlock>([&](EBlock& out) { return eth_getBlockByHash(hashBlock, full, out); });
+}
+
+QFuture<EBlock> EthRPC::eth_getBlockByNumberAsync(const EVariant &blockId, const EBool &full)
+{
+    return m_p->call_rpc_async<EBlock>([&](EBlock& out) { return eth_getBlockByNumber(blockId, full, out); });
+}
+
+QFuture<ETransaction> EthRPC::eth_getTransactionByHashAsync(const EByteArray &transactionHash)
+{
+    return m_p->call_rpc_async<ETransaction>([&](ETransaction& out) { return eth_getTransactionByHash(transactionHash, out); });
+}
+
+QFuture<ETransaction> EthRPC::eth_getTransactionByBlockHashAndIndexAsync(const EByteArray &hashBlock, const EInt &transactionIndex)
+{
+    return m_p->call_rpc_async<ETransaction>([&](ETransaction& out) { return eth_getTransactionByBlockHashAndIndex(hashBlock, transactionIndex, out); });
+}
+
+QFuture<ETransaction> EthRPC::eth_getTransactionByBlockNumberAndIndexAsync(const EVariant &blockId, const EInt &transactionIndex)
+{
+    return m_p->call_rpc_async<ETransaction>([&](ETransaction& out) { return eth_getTransactionByBlockNumberAndIndex(blockId, transactionIndex, out); });
+}
+
+QFuture<EReceipt> EthRPC::eth_getTransactionReceiptAsync(const EByteArray &transactionHash)
+{
+    return m_p->call_rpc_async<EReceipt>([&](EReceipt& out) { return eth_getTransactionReceipt(transactionHash, out); });
+}
+
+QFuture<EBlock> EthRPC::eth_getUncleByBlockHashAndIndexAsync(const EByteArray &hashBlock, const EInt &possition)
+{
+    return m_p->call_rpc_async<EBlock>([&](EBlock& out) { return eth_getUncleByBlockHashAndIndex(hashBlock, possition, out); });
+}
+
+QFuture<EBlock> EthRPC::eth_getUncleByBlockNumberAndIndexAsync(const EVariant &blockId, const EInt &possition)
+{
+    return m_p->call_rpc_async<EBlock>([&](EBlock& out) { return eth_getUncleByBlockNumberAndIndex(blockId, possition, out); });
+}
+
+QFuture<EString> EthRPC::eth_compileSolidityAsync(const EString &sourceCode)
+{
+    return m_p->call_rpc_async<EString>([&](EString& out) { return eth_compileSolidity(sourceCode, out); });
+}
+
+QFuture<EString> EthRPC::eth_compileLLLAsync(const EString &sourceCode)
+{
+    return m_p->call_rpc_async<EString>([&](EString& out) { return eth_compileLLL(sourceCode, out); });
+}
+
+QFuture<EString> EthRPC::eth_compileSerpentAsync(const EString &sourceCode)
+{
+    return m_p->call_rpc_async<EString>([&](EString& out) { return eth_compileSerpent(sourceCode, out); });
+}
+
+QFuture<EInt> EthRPC::eth_newFilterAsync(const EFilter &filter)
+{
+    return m_p->call_rpc_async<EInt>([&](EInt& out) { return eth_newFilter(filter, out); });
+}
+
+QFuture<EInt> EthRPC::eth_newBlockFilterAsync()
+{
+    return m_p->call_rpc_async<EInt>([&](EInt& out) { return eth_newBlockFilter(out); });
+}
+
+QFuture<EInt> EthRPC::eth_newPendingTransactionFilterAsync()
+{
+    return m_p->call_rpc_async<EInt>([&](EInt& out) { return eth_newPendingTransactionFilter(out); });
+}
+
+QFuture<EBool> EthRPC::eth_uninstallFilterAsync(const EInt &filterId)
+{
+    return m_p->call_rpc_async<EBool>([&](EBool& out) { return eth_uninstallFilter(filterId, out); });
+}
+
+QFuture<EByteArrayList> EthRPC::eth_getFilterChangesAsync(const EInt &filterId)
+{
+    return m_p->call_rpc_async<EByteArrayList>([&](EByteArrayList& out) { return eth_getFilterChanges(filterId, out); });
+}
+
+QFuture<ELogList> EthRPC::eth_getFilterChangesLogsAsync(const EInt &filterId)
+{
+    return m_p->call_rpc_async<ELogList>([&](ELogList& out) { return eth_getFilterChanges(filterId, out); });
+}
+
+QFuture<ELogList> EthRPC::eth_getFilterLogsAsync(const EInt &filterId)
+{
+    return m_p->call_rpc_async<ELogList>([&](ELogList& out) { return eth_getFilterLogs(filterId, out); });
+}
+
+QFuture<EByteArrayList> EthRPC::eth_getWorkAsync()
+{
+    return m_p->call_rpc_async<EByteArrayList>([&](EByteArrayList& out) { return eth_getWork(out); });
+}
+
+QFuture<EBool> EthRPC::eth_submitWorkAsync(const EByteArray &nonce, const EByteArray &powHash, const EByteArray &mixDigest)
+{
+    return m_p->call_rpc_async<EBool>([&](EBool& out) { return eth_submitWork(nonce, powHash, mixDigest, out); });
+}
+
+QFuture<EBool> EthRPC::eth_submitHashrateAsync(const EByteArray &hashrate, const EByteArray &ID)
+{
+    return m_p->call_rpc_async<EBool>([&](EBool& out) { return eth_submitHashrate(hashrate, ID, out); });
+}
+
+QFuture<EBool> EthRPC::db_putStringAsync(const EString &databaseName, const EString &keyName, const EString &stringValue)
+{
+    return m_p->call_rpc_async<EBool>([&](EBool& out) { return db_putString(databaseName, keyName, stringValue, out); });
+}
+
+QFuture<EString> EthRPC::db_getStringAsync(const EString &databaseName, const EString &keyName)
+{
+    return m_p->call_rpc_async<EString>([&](EString& out) { return db_getString(databaseName, keyName, out); });
+}
+
+QFuture<EBool> EthRPC::db_putHexAsync(const EString &databaseName, const EString &keyName, const EByteArray &hexValue)
+{
+    return m_p->call_rpc_async<EBool>([&](EBool& out) { return db_putHex(databaseName, keyName, hexValue, out); });
+}
+
+QFuture<EByteArray> EthRPC::db_getHexAsync(const EString &databaseName, const EString &keyName)
+{
+    return m_p->call_rpc_async<EByteArray>([&](EByteArray& out) { return db_getHex(databaseName, keyName, out); });
+}
+
+QFuture<EString> EthRPC::shh_versionAsync()
+{
+    return m_p->call_rpc_async<EString>([&](EString& out) { return shh_version(out); });
+}
+
+QFuture<EBool> EthRPC::shh_postAsync(const SWhisper &message)
+{
+    return m_p->call_rpc_async<EBool>([&](EBool& out) { return shh_post(message, out); });
+}
+
+QFuture<EByteArray> EthRPC::shh_newIdentityAsync()
+{
+    return m_p->call_rpc_async<EByteArray>([&](EByteArray& out) { return shh_newIdentity(out); });
+}
+
+QFuture<EBool> EthRPC::shh_hasIdentityAsync(const EByteArray &address)
+{
+    return m_p->call_rpc_async<EBool>([&](EBool& out) { return shh_hasIdentity(address, out); });
+}
+
+QFuture<EByteArray> EthRPC::shh_newGroupAsync()
+{
+    return m_p->call_rpc_async<EByteArray>([&](EByteArray& out) { return shh_newGroup(out); });
+}
+
+QFuture<EBool> EthRPC::shh_addToGroupAsync(const EByteArray &address)
+{
+    return m_p->call_rpc_async<EBool>([&](EBool& out) { return shh_addToGroup(address, out); });
+}
+
+QFuture<EInt> EthRPC::shh_newFilterAsync(const SFilter &filter)
+{
+    return m_p->call_rpc_async<EInt>([&](EInt& out) { return shh_newFilter(filter, out); });
+}
+
+QFuture<EBool> EthRPC::shh_uninstallFilterAsync(const EInt &filterId)
+{
+    return m_p->call_rpc_async<EBool>([&](EBool& out) { return shh_uninstallFilter(filterId, out); });
+}
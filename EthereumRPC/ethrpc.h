@@ -3,8 +3,16 @@
 
 #include "ethrpc_global.h"
 #include "ethobject.h"
+#include <QFuture>
+#include <QSharedPointer>
+#include <functional>
+
+class IEthClient;
 
 class RPC_Private;
+class EthRPCCache;
+class EthBlockStore;
+class EthHeaderCache;
 
 /**
  * @brief The EthRPC class that implement the interface for the JSON RTC API defined in the link:
@@ -14,6 +22,11 @@ class ETHRPCSHARED_EXPORT EthRPC
 {
 
 public:
+    //Called with every value pushed by the server for a subscription
+    typedef std::function<void(const EBlock& header)> HeadHandler;
+    typedef std::function<void(const ELog& log)> LogHandler;
+    typedef std::function<void(const EHash32& transactionHash)> PendingTransactionHandler;
+
     /**
      * @brief EthRPC Constructor
      */
@@ -26,11 +39,103 @@ public:
 
     /**
      * @brief connect Return true of the connection to the server
-     * @param serverUri Uri to the server
+     * @param serverUri Uri to the server, http:// or https:// for HTTP, ws:// or wss:// for WebSocket,
+     * ipc:// or a path for the IPC socket, empty for the default IPC socket
      * @return true if can connect, otherwise false
      */
     bool connect(const EString& serverUri);
 
+    /**
+     * @brief connect Return true of the connection to at least one of the servers
+     * @param serverUris Uris of the servers, with several servers the requests are balanced between them
+     * by latency and the servers that are behind the others are not used, see EthBalancedClient.
+     * @return true if can connect to one server, otherwise false
+     */
+    bool connect(const QStringList& serverUris);
+
+    /**
+     * @brief connect Return true of the connection with the client
+     * @param client Transport to the server, the RPC take its ownership.
+     * @return true if can connect, otherwise false
+     */
+    bool connect(IEthClient* client);
+
+    /**
+     * @brief beginBatch Start a JSON RPC batch, the following calls are queued and return true
+     * without being sent, their outputs are filled by sendBatch and must stay alive until then.
+     */
+    void beginBatch();
+
+    /**
+     * @brief sendBatch Send the queued calls in one request and fill their outputs by id.
+     * @param results Optional success of every queued call, in the order of the calls.
+     * @return true if every call succeeded, otherwise false.
+     */
+    bool sendBatch(QVector<bool>* results = 0);
+
+    /**
+     * @brief cancelBatch Drop the queued calls without sending them.
+     */
+    void cancelBatch();
+
+    /**
+     * @brief batchSize Return the number of queued calls.
+     * @return Number of calls waiting for sendBatch.
+     */
+    int batchSize() const;
+
+    /**
+     * @brief setCache Serve the results that can not change from the cache, like the blocks by hash,
+     * the mined transactions and receipts, and the state at a block number. Disabled by default.
+     * @param cache The cache, it can be shared between several EthRPC, null to disable the cache.
+     */
+    void setCache(const QSharedPointer<EthRPCCache>& cache);
+
+    /**
+     * @brief cache Return the cache, with its hit and miss counters.
+     * @return The cache, null when disabled.
+     */
+    QSharedPointer<EthRPCCache> cache() const;
+
+    /**
+     * @brief setLocalHashing Compute web3_sha3 in the process instead of sending the data to the server.
+     * @param local true for the local Keccak-256, false by default.
+     */
+    void setLocalHashing(bool local);
+    bool localHashing() const;
+
+    /**
+     * @brief setHedging Hedge the reads like eth_call and eth_getBalance when connected to several servers,
+     * a read not answered within the hedge delay is sent to a second server and the first response is used.
+     * The delay and the budget of the hedges are the parameters "hedgePercentile" and "hedgeBudget" of EthBalancedClient.
+     * The blocking calls wait on the sockets of the servers without running the event loop. Disabled by default.
+     * @param hedging true to hedge the reads.
+     */
+    void setHedging(bool hedging);
+    bool hedging() const;
+
+    /**
+     * @brief setBlockStore Serve the blocks by hash, the confirmed blocks by number, the mined transactions
+     * and the receipts from the store, the results fetched from the server are appended to it. Disabled by default.
+     * @param store The opened store, it can be shared between several EthRPC, null to disable the store.
+     */
+    void setBlockStore(const QSharedPointer<EthBlockStore>& store);
+
+    /**
+     * @brief blockStore Return the block store.
+     * @return The store, null when disabled.
+     */
+    QSharedPointer<EthBlockStore> blockStore() const;
+
+    /**
+     * @brief setHeaderCache Answer eth_blockNumber and eth_getBlockByNumber("latest", false) with the head
+     * of the cache as of its last update, the calls are sent to the server while the cache is empty. Disabled by default.
+     * The cache is not thread safe, it is updated by another EthRPC, its own calls would be answered by itself.
+     * @param headers The polled cache, null to disable it.
+     */
+    void setHeaderCache(const QSharedPointer<EthHeaderCache>& headers);
+    QSharedPointer<EthHeaderCache> headerCache() const;
+
     /**
      * @brief web3_clientVersion Returns the current client version.
      * @param clientVersion The current client version.
@@ -130,7 +235,7 @@ public:
      * @param currentBalance Integer of the current balance in wei.
      * @return Success of the RPC.
      */
-    bool eth_getBalance(const EByteArray& ethAddress, const EVariant& blockId, EInt& currentBalance);
+    bool eth_getBalance(const EByteArray& ethAddress, const EVariant& blockId, EUInt256& currentBalance);
 
     /**
      * @brief eth_getStorageAt Returns the value from a storage position at a given address.
@@ -407,6 +512,14 @@ public:
      */
     bool eth_getFilterChanges(const EInt& filterId, EByteArrayList& logs);
 
+    /**
+     * @brief eth_getFilterChanges Polling method for a filter created with eth_newFilter, the logs are decoded into log objects.
+     * @param filterId QUANTITY - the filter id.
+     * @param logs Array - Array of log objects, or an empty array if nothing has changed since last poll.
+     * @return Success of the RPC.
+     */
+    bool eth_getFilterChanges(const EInt& filterId, ELogList& logs);
+
     /**
      * @brief eth_getFilterLogs Returns an array of all logs matching filter with given id.
      * @param filterId QUANTITY - the filter id.
@@ -415,6 +528,58 @@ public:
      */
     bool eth_getFilterLogs(const EInt& filterId, EByteArrayList& logs);
 
+    /**
+     * @brief eth_getFilterLogs Returns an array of all logs matching filter with given id, decoded into log objects.
+     * @param filterId QUANTITY - the filter id.
+     * @param logs Array - Array of log objects, or an empty array if nothing has changed since last poll.
+     * @return Success of the RPC.
+     */
+    bool eth_getFilterLogs(const EInt& filterId, ELogList& logs);
+
+    /**
+     * @brief eth_getLogs Returns an array of all logs matching the filter, without installing a filter.
+     * @param filter The filter options.
+     * @param logs Array - Array of log objects.
+     * @return Success of the RPC.
+     */
+    bool eth_getLogs(const EFilter& filter, ELogList& logs);
+
+    /**
+     * @brief eth_subscribeNewHeads Subscribe to the headers of the new blocks, including the blocks of a chain reorganization.
+     * The subscriptions need a transport that receive notifications, like IPC or WebSocket, they fail with HTTP.
+     * The handler is called from the event loop of the thread of the connection.
+     * @param handler Handler of the headers, the transactions of the blocks are empty.
+     * @param subscriptionId String - The subscription id, for eth_unsubscribe.
+     * @return Success of the RPC.
+     */
+    bool eth_subscribeNewHeads(const HeadHandler& handler, EString& subscriptionId);
+
+    /**
+     * @brief eth_subscribeLogs Subscribe to the logs of the new blocks that match the filter.
+     * The logs removed by a chain reorganization are sent again with removed set to true.
+     * @param filter The filter options, only address and topics are used.
+     * @param handler Handler of the logs.
+     * @param subscriptionId String - The subscription id, for eth_unsubscribe.
+     * @return Success of the RPC.
+     */
+    bool eth_subscribeLogs(const EFilter& filter, const LogHandler& handler, EString& subscriptionId);
+
+    /**
+     * @brief eth_subscribeNewPendingTransactions Subscribe to the hashes of the transactions added to the pending state.
+     * @param handler Handler of the transaction hashes.
+     * @param subscriptionId String - The subscription id, for eth_unsubscribe.
+     * @return Success of the RPC.
+     */
+    bool eth_subscribeNewPendingTransactions(const PendingTransactionHandler& handler, EString& subscriptionId);
+
+    /**
+     * @brief eth_unsubscribe Cancel a subscription, its handler is not called anymore.
+     * @param subscriptionId The subscription id.
+     * @param unsubscribed Boolean - true if the subscription was cancelled, otherwise false.
+     * @return Success of the RPC.
+     */
+    bool eth_unsubscribe(const EString& subscriptionId, EBool& unsubscribed);
+
     /**
      * @brief eth_getWork Returns the hash of the current block, the seedHash, and the boundary condition to be met ("target").
      * @param properties Array - Array with the following properties:
@@ -572,6 +737,373 @@ public:
      */
     bool shh_getMessages(const EInt& filterId, QList<SFilterMessage>& messages);
 
+    /*
+     * Asynchronous API, the calls are sent through the same path as the blocking methods
+     * without waiting for the response. The futures are finished from the event loop of the
+     * thread that own the connection, several calls can be in flight on one transport.
+     */
+
+    /**
+     * @brief web3_clientVersionAsync Asynchronous web3_clientVersion, the future is canceled when the RPC fails.
+     * @return The future clientVersion.
+     */
+    QFuture<EString> web3_clientVersionAsync();
+
+    /**
+     * @brief web3_sha3Async Asynchronous web3_sha3, the future is canceled when the RPC fails.
+     * @return The future hash.
+     */
+    QFuture<EByteArray> web3_sha3Async(const EByteArray& rowData);
+
+    /**
+     * @brief net_versionAsync Asynchronous net_version, the future is canceled when the RPC fails.
+     * @return The future clientVersion.
+     */
+    QFuture<EString> net_versionAsync();
+
+    /**
+     * @brief net_listeningAsync Asynchronous net_listening, the future is canceled when the RPC fails.
+     * @return The future isListening.
+     */
+    QFuture<EBool> net_listeningAsync();
+
+    /**
+     * @brief net_peerCountAsync Asynchronous net_peerCount, the future is canceled when the RPC fails.
+     * @return The future numberConnected.
+     */
+    QFuture<EInt> net_peerCountAsync();
+
+    /**
+     * @brief eth_protocolVersionAsync Asynchronous eth_protocolVersion, the future is canceled when the RPC fails.
+     * @return The future clientVersion.
+     */
+    QFuture<EString> eth_protocolVersionAsync();
+
+    /**
+     * @brief eth_syncingAsync Asynchronous eth_syncing, the future is canceled when the RPC fails.
+     * @return The future syncing.
+     */
+    QFuture<ESyncing> eth_syncingAsync();
+
+    /**
+     * @brief eth_coinbaseAsync Asynchronous eth_coinbase, the future is canceled when the RPC fails.
+     * @return The future coinbaseAddress.
+     */
+    QFuture<EByteArray> eth_coinbaseAsync();
+
+    /**
+     * @brief eth_miningAsync Asynchronous eth_mining, the future is canceled when the RPC fails.
+     * @return The future isMining.
+     */
+    QFuture<EBool> eth_miningAsync();
+
+    /**
+     * @brief eth_hashrateAsync Asynchronous eth_hashrate, the future is canceled when the RPC fails.
+     * @return The future hashesPerSec.
+     */
+    QFuture<EInt> eth_hashrateAsync();
+
+    /**
+     * @brief eth_gasPriceAsync Asynchronous eth_gasPrice, the future is canceled when the RPC fails.
+     * @return The future currentGasPrice.
+     */
+    QFuture<EInt> eth_gasPriceAsync();
+
+    /**
+     * @brief eth_accountsAsync Asynchronous eth_accounts, the future is canceled when the RPC fails.
+     * @return The future ethAddresses.
+     */
+    QFuture<EByteArrayList> eth_accountsAsync();
+
+    /**
+     * @brief eth_blockNumberAsync Asynchronous eth_blockNumber, the future is canceled when the RPC fails.
+     * @return The future currentBlockNumber.
+     */
+    QFuture<EInt> eth_blockNumberAsync();
+
+    /**
+     * @brief eth_getBalanceAsync Asynchronous eth_getBalance, the future is canceled when the RPC fails.
+     * @return The future currentBalance.
+     */
+    QFuture<EUInt256> eth_getBalanceAsync(const EByteArray& ethAddress, const EVariant& blockId);
+
+    /**
+     * @brief eth_getStorageAtAsync Asynchronous eth_getStorageAt, the future is canceled when the RPC fails.
+     * @return The future value.
+     */
+    QFuture<EByteArray> eth_getStorageAtAsync(const EByteArray& storageAddress, const EInt& position, const EVariant& blockId);
+
+    /**
+     * @brief eth_getTransactionCountAsync Asynchronous eth_getTransactionCount, the future is canceled when the RPC fails.
+     * @return The future numberTransactions.
+     */
+    QFuture<EInt> eth_getTransactionCountAsync(const EByteArray& ethAddress, const EVariant& blockId);
+
+    /**
+     * @brief eth_getBlockTransactionCountByHashAsync Asynchronous eth_getBlockTransactionCountByHash, the future is canceled when the RPC fails.
+     * @return The future numberTransactions.
+     */
+    QFuture<EInt> eth_getBlockTransactionCountByHashAsync(const EByteArray& hashBlock);
+
+    /**
+     * @brief eth_getBlockTransactionCountByNumberAsync Asynchronous eth_getBlockTransactionCountByNumber, the future is canceled when the RPC fails.
+     * @return The future numberTransactions.
+     */
+    QFuture<EInt> eth_getBlockTransactionCountByNumberAsync(const EVariant& blockId);
+
+    /**
+     * @brief eth_getUncleCountByBlockHashAsync Asynchronous eth_getUncleCountByBlockHash, the future is canceled when the RPC fails.
+     * @return The future numberUncles.
+     */
+    QFuture<EInt> eth_getUncleCountByBlockHashAsync(const EByteArray& hashBlock);
+
+    /**
+     * @brief eth_getUncleCountByBlockNumberAsync Asynchronous eth_getUncleCountByBlockNumber, the future is canceled when the RPC fails.
+     * @return The future numberUncles.
+     */
+    QFuture<EInt> eth_getUncleCountByBlockNumberAsync(const EVariant& blockId);
+
+    /**
+     * @brief eth_getCodeAsync Asynchronous eth_getCode, the future is canceled when the RPC fails.
+     * @return The future addressCode.
+     */
+    QFuture<EByteArray> eth_getCodeAsync(const EByteArray& ethAddress, const EVariant& blockId);
+
+    /**
+     * @brief eth_signAsync Asynchronous eth_sign, the future is canceled when the RPC fails.
+     * @return The future cipheredData.
+     */
+    QFuture<EByteArray> eth_signAsync(const EByteArray& ethAddress, const EByteArray& plainData);
+
+    /**
+     * @brief eth_sendTransactionAsync Asynchronous eth_sendTransaction, the future is canceled when the RPC fails.
+     * @return The future transactionHash.
+     */
+    QFuture<EByteArray> eth_sendTransactionAsync(const ETransaction& transaction);
+
+    /**
+     * @brief eth_sendRawTransactionAsync Asynchronous eth_sendRawTransaction, the future is canceled when the RPC fails.
+     * @return The future transactionHash.
+     */
+    QFuture<EByteArray> eth_sendRawTransactionAsync(const EByteArray& signedData);
+
+    /**
+     * @brief eth_callAsync Asynchronous eth_call, the future is canceled when the RPC fails.
+     * @return The future returnValue.
+     */
+    QFuture<EByteArray> eth_callAsync(const ETransaction& transaction, const EVariant& blockId);
+
+    /**
+     * @brief eth_estimateGasAsync Asynchronous eth_estimateGas, the future is canceled when the RPC fails.
+     * @return The future gasUsed.
+     */
+    QFuture<EInt> eth_estimateGasAsync(const ETransaction& transaction, const EInt& blockNumber);
+
+    /**
+     * @brief eth_estimateGasAsync Asynchronous eth_estimateGas, the future is canceled when the RPC fails.
+     * @return The future gasUsed.
+     */
+    QFuture<EInt> eth_estimateGasAsync(const ETransaction& transaction, const EString& blockTag);
+
+    /**
+     * @brief eth_getBlockByHashAsync Asynchronous eth_getBlockByHash, the future is canceled when the RPC fails.
+     * @return The future block.
+     */
+    QFuture<EBlock> eth_getBlockByHashAsync(const EByteArray& hashBlock, const EBool& full);
+
+    /**
+     * @brief eth_getBlockByNumberAsync Asynchronous eth_getBlockByNumber, the future is canceled when the RPC fails.
+     * @return The future block.
+     */
+    QFuture<EBlock> eth_getBlockByNumberAsync(const EVariant& blockId, const EBool& full);
+
+    /**
+     * @brief eth_getTransactionByHashAsync Asynchronous eth_getTransactionByHash, the future is canceled when the RPC fails.
+     * @return The future transaction.
+     */
+    QFuture<ETransaction> eth_getTransactionByHashAsync(const EByteArray& transactionHash);
+
+    /**
+     * @brief eth_getTransactionByBlockHashAndIndexAsync Asynchronous eth_getTransactionByBlockHashAndIndex, the future is canceled when the RPC fails.
+     * @return The future transaction.
+     */
+    QFuture<ETransaction> eth_getTransactionByBlockHashAndIndexAsync(const EByteArray& hashBlock, const EInt& transactionIndex);
+
+    /**
+     * @brief eth_getTransactionByBlockNumberAndIndexAsync Asynchronous eth_getTransactionByBlockNumberAndIndex, the future is canceled when the RPC fails.
+     * @return The future transaction.
+     */
+    QFuture<ETransaction> eth_getTransactionByBlockNumberAndIndexAsync(const EVariant& blockId, const EInt& transactionIndex);
+
+    /**
+     * @brief eth_getTransactionReceiptAsync Asynchronous eth_getTransactionReceipt, the future is canceled when the RPC fails.
+     * @return The future receipt.
+     */
+    QFuture<EReceipt> eth_getTransactionReceiptAsync(const EByteArray& transactionHash);
+
+    /**
+     * @brief eth_getUncleByBlockHashAndIndexAsync Asynchronous eth_getUncleByBlockHashAndIndex, the future is canceled when the RPC fails.
+     * @return The future block.
+     */
+    QFuture<EBlock> eth_getUncleByBlockHashAndIndexAsync(const EByteArray& hashBlock, const EInt& possition);
+
+    /**
+     * @brief eth_getUncleByBlockNumberAndIndexAsync Asynchronous eth_getUncleByBlockNumberAndIndex, the future is canceled when the RPC fails.
+     * @return The future block.
+     */
+    QFuture<EBlock> eth_getUncleByBlockNumberAndIndexAsync(const EVariant& blockId, const EInt& possition);
+
+    /**
+     * @brief eth_compileSolidityAsync Asynchronous eth_compileSolidity, the future is canceled when the RPC fails.
+     * @return The future compiledCode.
+     */
+    QFuture<EString> eth_compileSolidityAsync(const EString& sourceCode);
+
+    /**
+     * @brief eth_compileLLLAsync Asynchronous eth_compileLLL, the future is canceled when the RPC fails.
+     * @return The future compiledCode.
+     */
+    QFuture<EString> eth_compileLLLAsync(const EString& sourceCode);
+
+    /**
+     * @brief eth_compileSerpentAsync Asynchronous eth_compileSerpent, the future is canceled when the RPC fails.
+     * @return The future compiledCode.
+     */
+    QFuture<EString> eth_compileSerpentAsync(const EString& sourceCode);
+
+    /**
+     * @brief eth_newFilterAsync Asynchronous eth_newFilter, the future is canceled when the RPC fails.
+     * @return The future filterId.
+     */
+    QFuture<EInt> eth_newFilterAsync(const EFilter& filter);
+
+    /**
+     * @brief eth_newBlockFilterAsync Asynchronous eth_newBlockFilter, the future is canceled when the RPC fails.
+     * @return The future filterId.
+     */
+    QFuture<EInt> eth_newBlockFilterAsync();
+
+    /**
+     * @brief eth_newPendingTransactionFilterAsync Asynchronous eth_newPendingTransactionFilter, the future is canceled when the RPC fails.
+     * @return The future filterId.
+     */
+    QFuture<EInt> eth_newPendingTransactionFilterAsync();
+
+    /**
+     * @brief eth_uninstallFilterAsync Asynchronous eth_uninstallFilter, the future is canceled when the RPC fails.
+     * @return The future uninstalled.
+     */
+    QFuture<EBool> eth_uninstallFilterAsync(const EInt& filterId);
+
+    /**
+     * @brief eth_getFilterChangesAsync Asynchronous eth_getFilterChanges, the future is canceled when the RPC fails.
+     * @return The future logs.
+     */
+    QFuture<EByteArrayList> eth_getFilterChangesAsync(const EInt& filterId);
+
+    /**
+     * @brief eth_getFilterChangesLogsAsync Asynchronous eth_getFilterChanges for a filter created with eth_newFilter,
+     * the logs are decoded into log objects, the future is canceled when the RPC fails.
+     * @return The future logs.
+     */
+    QFuture<ELogList> eth_getFilterChangesLogsAsync(const EInt& filterId);
+
+    /**
+     * @brief eth_getFilterLogsAsync Asynchronous eth_getFilterLogs, the future is canceled when the RPC fails.
+     * @return The future logs.
+     */
+    QFuture<ELogList> eth_getFilterLogsAsync(const EInt& filterId);
+
+    /**
+     * @brief eth_getWorkAsync Asynchronous eth_getWork, the future is canceled when the RPC fails.
+     * @return The future properties.
+     */
+    QFuture<EByteArrayList> eth_getWorkAsync();
+
+    /**
+     * @brief eth_submitWorkAsync Asynchronous eth_submitWork, the future is canceled when the RPC fails.
+     * @return The future isValid.
+     */
+    QFuture<EBool> eth_submitWorkAsync(const EByteArray& nonce, const EByteArray& powHash, const EByteArray& mixDigest);
+
+    /**
+     * @brief eth_submitHashrateAsync Asynchronous eth_submitHashrate, the future is canceled when the RPC fails.
+     * @return The future isSubmited.
+     */
+    QFuture<EBool> eth_submitHashrateAsync(const EByteArray& hashrate, const EByteArray& ID);
+
+    /**
+     * @brief db_putStringAsync Asynchronous db_putString, the future is canceled when the RPC fails.
+     * @return The future isStored.
+     */
+    QFuture<EBool> db_putStringAsync(const EString& databaseName, const EString& keyName, const EString& stringValue);
+
+    /**
+     * @brief db_getStringAsync Asynchronous db_getString, the future is canceled when the RPC fails.
+     * @return The future stringValue.
+     */
+    QFuture<EString> db_getStringAsync(const EString& databaseName, const EString& keyName);
+
+    /**
+     * @brief db_putHexAsync Asynchronous db_putHex, the future is canceled when the RPC fails.
+     * @return The future isStored.
+     */
+    QFuture<EBool> db_putHexAsync(const EString& databaseName, const EString& keyName, const EByteArray& hexValue);
+
+    /**
+     * @brief db_getHexAsync Asynchronous db_getHex, the future is canceled when the RPC fails.
+     * @return The future hexValue.
+     */
+    QFuture<EByteArray> db_getHexAsync(const EString& databaseName, const EString& keyName);
+
+    /**
+     * @brief shh_versionAsync Asynchronous shh_version, the future is canceled when the RPC fails.
+     * @return The future version.
+     */
+    QFuture<EString> shh_versionAsync();
+
+    /**
+     * @brief shh_postAsync Asynchronous shh_post, the future is canceled when the RPC fails.
+     * @return The future wasSend.
+     */
+    QFuture<EBool> shh_postAsync(const SWhisper& message);
+
+    /**
+     * @brief shh_newIdentityAsync Asynchronous shh_newIdentity, the future is canceled when the RPC fails.
+     * @return The future address.
+     */
+    QFuture<EByteArray> shh_newIdentityAsync();
+
+    /**
+     * @brief shh_hasIdentityAsync Asynchronous shh_hasIdentity, the future is canceled when the RPC fails.
+     * @return The future hasIdentity.
+     */
+    QFuture<EBool> shh_hasIdentityAsync(const EByteArray& address);
+
+    /**
+     * @brief shh_newGroupAsync Asynchronous shh_newGroup, the future is canceled when the RPC fails.
+     * @return The future address.
+     */
+    QFuture<EByteArray> shh_newGroupAsync();
+
+    /**
+     * @brief shh_addToGroupAsync Asynchronous shh_addToGroup, the future is canceled when the RPC fails.
+     * @return The future wasAdded.
+     */
+    QFuture<EBool> shh_addToGroupAsync(const EByteArray& address);
+
+    /**
+     * @brief shh_newFilterAsync Asynchronous shh_newFilter, the future is canceled when the RPC fails.
+     * @return The future filterId.
+     */
+    QFuture<EInt> shh_newFilterAsync(const SFilter& filter);
+
+    /**
+     * @brief shh_uninstallFilterAsync Asynchronous shh_uninstallFilter, the future is canceled when the RPC fails.
+     * @return The future wasUninstalled.
+     */
+    QFuture<EBool> shh_uninstallFilterAsync(const EInt& filterId);
+
 private:
     RPC_Private* m_p;
 };
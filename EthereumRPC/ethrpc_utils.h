@@ -2,6 +2,9 @@
 #define ETHEREUMUTILS_H
 #include <QByteArray>
 #include <QString>
+#include <stdint.h>
+#include "hexcodec.h"
+#include "keccak.h"
 
 inline QString removeHexMark(QString hexString)
 {
@@ -10,22 +13,22 @@ inline QString removeHexMark(QString hexString)
     return hexString;
 }
 
-inline bool isHexValid(const QString& hexString, int size = -1)
+inline bool isHexValid(const char* data, int size, int bytes = -1)
 {
-    if(!hexString.startsWith("0x"))
+    if(size < 2 || data[0] != '0' || data[1] != 'x')
         return false;
-    if(size > -1)
-    {
-        if(hexString.size() != 2 * size + 2)
-            return false;
-    }
-    for(int i = 2; i < hexString.size(); i++)
+    if(bytes > -1)
     {
-        char c = hexString[i].toLatin1();
-        if(!((c >= '0' && c <= '9') || (c >= 'a' && c <= 'f') || (c >= 'A' && c <= 'F')))
+        if(size != 2 * bytes + 2)
             return false;
     }
-    return true;
+    return hexValidate(data + 2, size - 2);
+}
+
+inline bool isHexValid(const QString& hexString, int size = -1)
+{
+    QByteArray hexData = hexString.toLatin1();
+    return isHexValid(hexData.constData(), hexData.size(), size);
 }
 
 inline QByteArray formatHex(const QByteArray& hexString, int size = -1)
@@ -38,10 +41,7 @@ inline QByteArray formatHex(const QByteArray& hexString, int size = -1)
         {
             if(data.size() < totalSize)
             {
-                for(int i = data.size(); i < totalSize; i++)
-                {
-                    data.prepend('0');
-                }
+                data.prepend(QByteArray(totalSize - data.size(), '0'));
             }
             else
             {
@@ -59,29 +59,93 @@ inline QByteArray int2hex(const int64_t& rawData)
     return formatHex(binaryData);
 }
 
+inline bool hex2int(const char* data, int size, int64_t& value)
+{
+    if(size >= 2 && data[0] == '0' && (data[1] == 'x' || data[1] == 'X'))
+    {
+        data += 2;
+        size -= 2;
+    }
+    if(size <= 0)
+        return false;
+
+    uint64_t result = 0;
+    for(int i = 0; i < size; i++)
+    {
+        int digit = hexDigitValue(data[i]);
+        if(digit < 0)
+            return false;
+        if(result > (uint64_t(INT64_MAX) >> 4))
+            return false;
+        result = (result << 4) | digit;
+    }
+    if(result > uint64_t(INT64_MAX))
+        return false;
+    value = int64_t(result);
+    return true;
+}
+
 inline bool hex2int(const QString& rawData, int64_t& value)
 {
-    bool ok = true;
-    value = rawData.toLongLong(&ok, 16);
-    return ok;
+    QByteArray hexData = rawData.toLatin1();
+    return hex2int(hexData.constData(), hexData.size(), value);
 }
 
 inline int64_t hex2int(const QString& rawData)
 {
-    return rawData.toLongLong(0, 16);
+    int64_t value = 0;
+    hex2int(rawData, value);
+    return value;
 }
 
 inline QByteArray binary2hex(const QByteArray& rawData)
 {
-    QByteArray binaryData = rawData.toHex();
-    return formatHex(binaryData);
+    QByteArray hexData(2 + rawData.size() * 2, Qt::Uninitialized);
+    char* out = hexData.data();
+    out[0] = '0';
+    out[1] = 'x';
+    hexEncode(reinterpret_cast<const unsigned char*>(rawData.constData()), rawData.size(), out + 2);
+    return hexData;
+}
+
+inline QByteArray hex2binary(const char* data, int size)
+{
+    if(size >= 2 && data[0] == '0' && data[1] == 'x')
+    {
+        data += 2;
+        size -= 2;
+    }
+    QByteArray binaryData(size / 2, Qt::Uninitialized);
+    if(hexDecode(data, size, reinterpret_cast<unsigned char*>(binaryData.data())))
+        return binaryData;
+    //Odd sizes and invalid digits keep the lenient behavior of QByteArray::fromHex
+    return QByteArray::fromHex(QByteArray::fromRawData(data, size));
 }
 
 inline QByteArray hex2binary(const QString& rawData)
 {
-    QString hexData = removeHexMark(rawData);
-    QByteArray binaryData = QByteArray::fromHex(hexData.toUtf8());
-    return binaryData;
+    QByteArray hexData = rawData.toLatin1();
+    return hex2binary(hexData.constData(), hexData.size());
+}
+
+//Decode exactly outSize bytes into the output, false when the size or the digits are invalid
+inline bool hex2binary(const char* data, int size, unsigned char* out, int outSize)
+{
+    if(size >= 2 && data[0] == '0' && data[1] == 'x')
+    {
+        data += 2;
+        size -= 2;
+    }
+    if(size != outSize * 2)
+        return false;
+    return hexDecode(data, size, out);
+}
+
+inline QByteArray keccak256(const QByteArray& data)
+{
+    QByteArray hash(Keccak256::HashSize, Qt::Uninitialized);
+    Keccak256::hash(data.constData(), data.size(), reinterpret_cast<unsigned char*>(hash.data()));
+    return hash;
 }
 
 #endif // ETHEREUMUTILS_H
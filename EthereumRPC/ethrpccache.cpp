@@ -0,0 +1,254 @@
+#include "ethrpccache.h"
+#include "jsoncoder.h"
+#include <QHash>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QSharedPointer>
+#include <typeinfo>
+
+namespace RPCCache_NS {
+enum CachePolicy
+{
+    NotCached,
+    //The result never change once it exists
+    Immutable,
+    //The result never change when the last parameter is a block number and not a tag
+    AtBlockNumber,
+    //The transaction never change once it is in a block
+    WhenMined
+};
+
+CachePolicy cachePolicy(const QString& method)
+{
+    static const QHash<QString, CachePolicy> policies = []()
+    {
+        QHash<QString, CachePolicy> policies;
+        policies.insert("web3_sha3", Immutable);
+        policies.insert("eth_getBlockByHash", Immutable);
+        policies.insert("eth_getBlockTransactionCountByHash", Immutable);
+        policies.insert("eth_getUncleCountByBlockHash", Immutable);
+        policies.insert("eth_getTransactionByBlockHashAndIndex", Immutable);
+        policies.insert("eth_getUncleByBlockHashAndIndex", Immutable);
+        policies.insert("eth_getTransactionReceipt", Immutable);
+        policies.insert("eth_getTransactionByHash", WhenMined);
+        policies.insert("eth_getBalance", AtBlockNumber);
+        policies.insert("eth_getStorageAt", AtBlockNumber);
+        policies.insert("eth_getTransactionCount", AtBlockNumber);
+        policies.insert("eth_getCode", AtBlockNumber);
+        policies.insert("eth_call", AtBlockNumber);
+        return policies;
+    }();
+    return policies.value(method, NotCached);
+}
+}
+using namespace RPCCache_NS;
+
+//LRU of one shard, the entries are linked from the most to the least recently used
+class RPCCacheShard
+{
+public:
+    struct Entry
+    {
+        QByteArray key;
+        QSharedPointer<EValue> value;
+        Entry* previous;
+        Entry* next;
+    };
+
+    explicit RPCCacheShard(int capacity):
+        m_capacity(capacity),
+        m_first(0),
+        m_last(0)
+    {}
+
+    ~RPCCacheShard()
+    {
+        clear();
+    }
+
+    bool lookup(const QByteArray& key, EValue& out)
+    {
+        QMutexLocker locker(&m_mutex);
+        Entry* entry = m_index.value(key);
+        if(!entry)
+            return false;
+        unlink(entry);
+        pushFront(entry);
+        out.assign(*entry->value);
+        return true;
+    }
+
+    void insert(const QByteArray& key, const QSharedPointer<EValue>& value)
+    {
+        QMutexLocker locker(&m_mutex);
+        Entry* entry = m_index.value(key);
+        if(entry)
+        {
+            unlink(entry);
+        }
+        else
+        {
+            entry = new Entry;
+            entry->key = key;
+            m_index.insert(key, entry);
+        }
+        entry->value = value;
+        pushFront(entry);
+
+        while(m_index.count() > m_capacity && m_last)
+        {
+            Entry* last = m_last;
+            unlink(last);
+            m_index.remove(last->key);
+            delete last;
+        }
+    }
+
+    void clear()
+    {
+        QMutexLocker locker(&m_mutex);
+        qDeleteAll(m_index);
+        m_index.clear();
+        m_first = m_last = 0;
+    }
+
+    int count()
+    {
+        QMutexLocker locker(&m_mutex);
+        return m_index.count();
+    }
+
+private:
+    void unlink(Entry* entry)
+    {
+        if(entry->previous) entry->previous->next = entry->next;
+        else m_first = entry->next;
+        if(entry->next) entry->next->previous = entry->previous;
+        else m_last = entry->previous;
+        entry->previous = entry->next = 0;
+    }
+
+    void pushFront(Entry* entry)
+    {
+        entry->previous = 0;
+        entry->next = m_first;
+        if(m_first) m_first->previous = entry;
+        m_first = entry;
+        if(!m_last) m_last = entry;
+    }
+
+    QMutex m_mutex;
+    QHash<QByteArray, Entry*> m_index;
+    int m_capacity;
+    Entry* m_first;
+    Entry* m_last;
+};
+
+EthRPCCache::EthRPCCache(int capacity, int shards):
+    m_capacity(qMax(1, capacity)),
+    m_hits(0),
+    m_misses(0)
+{
+    shards = qBound(1, shards, m_capacity);
+    int shardCapacity = (m_capacity + shards - 1) / shards;
+    for(int i = 0; i < shards; i++)
+    {
+        m_shards.append(new RPCCacheShard(shardCapacity));
+    }
+}
+
+EthRPCCache::~EthRPCCache()
+{
+    qDeleteAll(m_shards);
+}
+
+QByteArray EthRPCCache::makeKey(const JsonRPCMethod &method, const QVariantList &params, const EValue &out)
+{
+    QByteArray key;
+    CachePolicy policy = cachePolicy(method.name());
+    if(policy == NotCached)
+        return key;
+    if(policy == AtBlockNumber && (params.isEmpty() || !params.last().toString().startsWith("0x")))
+        return key;
+
+    key.reserve(128);
+    key.append(method.name().toLatin1());
+    key.append('\0');
+    writeJson(params, key);
+    key.append('\0');
+    key.append(typeid(out).name());
+    return key;
+}
+
+bool EthRPCCache::isCacheable(const JsonRPCMethod &method, EValue &out)
+{
+    if(out.isNull())
+        return false;
+    if(cachePolicy(method.name()) == WhenMined)
+    {
+        ETransaction* transaction = dynamic_cast<ETransaction*>(&out);
+        return transaction && !transaction->blockHash.isNull();
+    }
+    return true;
+}
+
+bool EthRPCCache::lookup(const QByteArray &key, EValue &out)
+{
+    bool hit = shard(key)->lookup(key, out);
+    if(hit)
+        m_hits.fetchAndAddRelaxed(1);
+    else
+        m_misses.fetchAndAddRelaxed(1);
+    return hit;
+}
+
+void EthRPCCache::insert(const QByteArray &key, const EValue &value)
+{
+    QSharedPointer<EValue> copy(value.clone());
+    if(copy)
+        shard(key)->insert(key, copy);
+}
+
+void EthRPCCache::clear()
+{
+    for(int i = 0; i < m_shards.count(); i++)
+    {
+        m_shards[i]->clear();
+    }
+}
+
+int EthRPCCache::capacity() const
+{
+    return m_capacity;
+}
+
+int EthRPCCache::count() const
+{
+    int count = 0;
+    for(int i = 0; i < m_shards.count(); i++)
+    {
+        count += m_shards[i]->count();
+    }
+    return count;
+}
+
+qint64 EthRPCCache::hits() const
+{
+    return m_hits.load();
+}
+
+qint64 EthRPCCache::misses() const
+{
+    return m_misses.load();
+}
+
+void EthRPCCache::resetCounters()
+{
+    m_hits.store(0);
+    m_misses.store(0);
+}
+
+RPCCacheShard *EthRPCCache::shard(const QByteArray &key) const
+{
+    return m_shards[qHash(key) % uint(m_shards.count())];
+}
@@ -0,0 +1,81 @@
+#ifndef ETHRPCCACHE_H
+#define ETHRPCCACHE_H
+
+#include <QByteArray>
+#include <QVariantList>
+#include <QAtomicInteger>
+#include "ethrpc_global.h"
+#include "ethobject.h"
+
+class JsonRPCMethod;
+class RPCCacheShard;
+
+/**
+ * @brief The EthRPCCache class keep the decoded results of the RPC methods that can not change,
+ * like the blocks by hash and the mined transactions and receipts, in a size bounded LRU.
+ * The cache is split in shards with their own lock so it can be shared between threads.
+ */
+class ETHRPCSHARED_EXPORT EthRPCCache
+{
+public:
+    /**
+     * @brief EthRPCCache Constructor
+     * @param capacity Maximum number of cached results.
+     * @param shards Number of shards, every shard has its own lock.
+     */
+    explicit EthRPCCache(int capacity = 4096, int shards = 16);
+
+    /**
+     * @brief ~EthRPCCache Destructor
+     */
+    virtual ~EthRPCCache();
+
+    /**
+     * @brief makeKey Return the key of a call.
+     * @param method The method.
+     * @param params The encoded parameters.
+     * @param out The output, the type of the output is part of the key.
+     * @return The key, empty when the result of the call can change.
+     */
+    static QByteArray makeKey(const JsonRPCMethod& method, const QVariantList& params, const EValue& out);
+
+    /**
+     * @brief isCacheable Return true when the decoded result of the call can be cached.
+     * @param method The method.
+     * @param out The decoded output.
+     * @return true if the result is final, false for null results and pending transactions.
+     */
+    static bool isCacheable(const JsonRPCMethod& method, EValue& out);
+
+    /**
+     * @brief lookup Copy the cached result of the key into the output.
+     * @return true on a hit, otherwise false.
+     */
+    bool lookup(const QByteArray& key, EValue& out);
+
+    /**
+     * @brief insert Cache a copy of the result, the least recently used result is dropped when full.
+     */
+    void insert(const QByteArray& key, const EValue& value);
+
+    /**
+     * @brief clear Drop all the cached results.
+     */
+    void clear();
+
+    int capacity() const;
+    int count() const;
+    qint64 hits() const;
+    qint64 misses() const;
+    void resetCounters();
+
+private:
+    RPCCacheShard* shard(const QByteArray& key) const;
+
+    QVector<RPCCacheShard*> m_shards;
+    int m_capacity;
+    QAtomicInteger<qint64> m_hits;
+    QAtomicInteger<qint64> m_misses;
+};
+
+#endif // ETHRPCCACHE_H
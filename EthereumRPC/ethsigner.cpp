@@ -0,0 +1,229 @@
+#include "ethsigner.h"
+#include "rlp.h"
+#include "keccak.h"
+#include <secp256k1.h>
+#include <secp256k1_recovery.h>
+#include <random>
+#include <string.h>
+
+namespace Signer_NS {
+const int KEY_SIZE = 32;
+const int ADDRESS_SIZE = 20;
+const int SIGNATURE_SIZE = 64;
+//Fields before the signature: nonce, gasPrice, gas, to, value, data
+const int TRANSACTION_SIZE = 64;
+const char MESSAGE_PREFIX[] = "\x19" "Ethereum Signed Message:\n";
+}
+using namespace Signer_NS;
+
+class Signer_Private
+{
+public:
+    Signer_Private():
+        m_context(0),
+        m_hasKey(false)
+    {
+        //Create the context once, the tables of the signature are built here and not for every signature
+        m_context = secp256k1_context_create(SECP256K1_CONTEXT_SIGN);
+
+        //Randomize the context against the side channel attacks
+        unsigned char seed[KEY_SIZE];
+        std::random_device random;
+        for(int i = 0; i < KEY_SIZE; i++)
+            seed[i] = (unsigned char)random();
+        if(!secp256k1_context_randomize(m_context, seed))
+        {
+            secp256k1_context_destroy(m_context);
+            m_context = 0;
+        }
+        memset(seed, 0, KEY_SIZE);
+        memset(m_key, 0, KEY_SIZE);
+    }
+
+    ~Signer_Private()
+    {
+        memset(m_key, 0, KEY_SIZE);
+        if(m_context)
+            secp256k1_context_destroy(m_context);
+    }
+
+    bool sign(const unsigned char* hash, unsigned char* signature, int& recoveryId) const
+    {
+        if(!m_context || !m_hasKey)
+            return false;
+        secp256k1_ecdsa_recoverable_signature recoverable;
+        if(!secp256k1_ecdsa_sign_recoverable(m_context, &recoverable, hash, m_key, NULL, NULL))
+            return false;
+        return secp256k1_ecdsa_recoverable_signature_serialize_compact(m_context, signature, &recoveryId, &recoverable) != 0;
+    }
+
+    secp256k1_context* m_context;
+    unsigned char m_key[KEY_SIZE];
+    QByteArray m_address;
+    bool m_hasKey;
+};
+
+//Encode the fields of the transaction without the closing of the list
+static void encodeFields(const ETransaction& tr, RLPEncoder& encoder)
+{
+    encoder.beginList();
+    encoder.addUInt(uint64_t(int64_t(tr.nonce)));
+    encoder.addUInt(uint64_t(int64_t(tr.gasPrice)));
+    encoder.addUInt(uint64_t(int64_t(tr.gas)));
+    if(tr.to.isNull())
+        encoder.addBytes(0, 0);
+    else
+        encoder.addBytes(reinterpret_cast<const char*>(tr.to.data()), tr.to.size());
+    encoder.addUInt(UInt256(tr.value));
+    encoder.addBytes(tr.data.isNull() ? QByteArray(tr.input) : QByteArray(tr.data));
+}
+
+//RLP of the EIP-155 signing data: the fields then chainId, 0, 0
+static void encodeUnsigned(const ETransaction& transaction, int64_t chainId, RLPEncoder& encoder)
+{
+    encoder.clear();
+    encodeFields(transaction, encoder);
+    encoder.addUInt(uint64_t(chainId));
+    encoder.addUInt(uint64_t(0));
+    encoder.addUInt(uint64_t(0));
+    encoder.endList();
+}
+
+//RLP of the signed transaction: the fields then v, r, s
+static void encodeSigned(const ETransaction& transaction, int64_t chainId, const unsigned char* signature, int recoveryId, RLPEncoder& encoder)
+{
+    encoder.clear();
+    encodeFields(transaction, encoder);
+    encoder.addUInt(uint64_t(recoveryId + chainId * 2 + 35));
+    UInt256 r, s;
+    r.fromBigEndian(signature);
+    s.fromBigEndian(signature + 32);
+    encoder.addUInt(r);
+    encoder.addUInt(s);
+    encoder.endList();
+}
+
+static bool checkTransaction(const ETransaction& tr, int64_t chainId)
+{
+    return chainId > 0 && int64_t(tr.nonce) >= 0 && int64_t(tr.gasPrice) >= 0 && int64_t(tr.gas) >= 0;
+}
+
+EthSigner::EthSigner():
+    m_p(new Signer_Private)
+{}
+
+EthSigner::~EthSigner()
+{
+    delete m_p;
+}
+
+bool EthSigner::setPrivateKey(const QByteArray &privateKey)
+{
+    memset(m_p->m_key, 0, KEY_SIZE);
+    m_p->m_address.clear();
+    m_p->m_hasKey = false;
+
+    const unsigned char* key = reinterpret_cast<const unsigned char*>(privateKey.constData());
+    if(!m_p->m_context || privateKey.size() != KEY_SIZE || !secp256k1_ec_seckey_verify(m_p->m_context, key))
+        return false;
+
+    //The address is the end of the hash of the uncompressed public key without its prefix
+    secp256k1_pubkey publicKey;
+    if(!secp256k1_ec_pubkey_create(m_p->m_context, &publicKey, key))
+        return false;
+    unsigned char serialized[65];
+    size_t serializedSize = sizeof(serialized);
+    secp256k1_ec_pubkey_serialize(m_p->m_context, serialized, &serializedSize, &publicKey, SECP256K1_EC_UNCOMPRESSED);
+    unsigned char hash[Keccak256::HashSize];
+    Keccak256::hash(serialized + 1, serializedSize - 1, hash);
+
+    memcpy(m_p->m_key, key, KEY_SIZE);
+    m_p->m_address = QByteArray(reinterpret_cast<const char*>(hash + Keccak256::HashSize - ADDRESS_SIZE), ADDRESS_SIZE);
+    m_p->m_hasKey = true;
+    return true;
+}
+
+QByteArray EthSigner::address() const
+{
+    return m_p->m_address;
+}
+
+bool EthSigner::signTransaction(const ETransaction &transaction, int64_t chainId, QByteArray &signedData, QByteArray *transactionHash) const
+{
+    if(!checkTransaction(transaction, chainId))
+        return false;
+
+    RLPEncoder encoder;
+    encoder.reserve(TRANSACTION_SIZE + QByteArray(transaction.data).size() + QByteArray(transaction.input).size());
+    encodeUnsigned(transaction, chainId, encoder);
+    unsigned char hash[Keccak256::HashSize];
+    Keccak256::hash(encoder.data().constData(), encoder.data().size(), hash);
+
+    unsigned char signature[SIGNATURE_SIZE];
+    int recoveryId = 0;
+    if(!m_p->sign(hash, signature, recoveryId))
+        return false;
+
+    encodeSigned(transaction, chainId, signature, recoveryId, encoder);
+    signedData = encoder.data();
+    if(transactionHash)
+    {
+        Keccak256::hash(signedData.constData(), signedData.size(), hash);
+        *transactionHash = QByteArray(reinterpret_cast<const char*>(hash), Keccak256::HashSize);
+    }
+    return true;
+}
+
+bool EthSigner::signTransactions(const QVector<ETransaction> &transactions, int64_t chainId, QVector<QByteArray> &signedData) const
+{
+    signedData.clear();
+    int count = transactions.count();
+    QVector<QByteArray> unsignedData(count);
+    QVector<const unsigned char*> buffers(count);
+    QVector<size_t> sizes(count);
+    RLPEncoder encoder;
+    for(int i = 0; i < count; i++)
+    {
+        if(!checkTransaction(transactions[i], chainId))
+            return false;
+        encodeUnsigned(transactions[i], chainId, encoder);
+        unsignedData[i] = encoder.data();
+        buffers[i] = reinterpret_cast<const unsigned char*>(unsignedData[i].constData());
+        sizes[i] = unsignedData[i].size();
+    }
+
+    //Hash every signing data together, then sign them one by one with the same context and key
+    QByteArray hashes(count * Keccak256::HashSize, 0);
+    Keccak256::hashBatch(buffers.constData(), sizes.constData(), count, reinterpret_cast<unsigned char*>(hashes.data()));
+
+    signedData.resize(count);
+    for(int i = 0; i < count; i++)
+    {
+        unsigned char signature[SIGNATURE_SIZE];
+        int recoveryId = 0;
+        const unsigned char* hash = reinterpret_cast<const unsigned char*>(hashes.constData()) + i * Keccak256::HashSize;
+        if(!m_p->sign(hash, signature, recoveryId))
+        {
+            signedData.clear();
+            return false;
+        }
+        encodeSigned(transactions[i], chainId, signature, recoveryId, encoder);
+        signedData[i] = encoder.data();
+    }
+    return true;
+}
+
+bool EthSigner::signMessage(const QByteArray &message, QByteArray &signature) const
+{
+    QByteArray prefixed = QByteArray(MESSAGE_PREFIX) + QByteArray::number(message.size()) + message;
+    unsigned char hash[Keccak256::HashSize];
+    Keccak256::hash(prefixed.constData(), prefixed.size(), hash);
+
+    unsigned char compact[SIGNATURE_SIZE];
+    int recoveryId = 0;
+    if(!m_p->sign(hash, compact, recoveryId))
+        return false;
+    signature = QByteArray(reinterpret_cast<const char*>(compact), SIGNATURE_SIZE);
+    signature.append(char(27 + recoveryId));
+    return true;
+}
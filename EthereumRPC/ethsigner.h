@@ -0,0 +1,75 @@
+#ifndef ETHSIGNER_H
+#define ETHSIGNER_H
+
+#include <QByteArray>
+#include <QVector>
+#include "ethrpc_global.h"
+#include "ethobject.h"
+
+class Signer_Private;
+
+/**
+ * @brief The EthSigner class sign transactions with a local private key,
+ * the signed transactions are sent with EthRPC::eth_sendRawTransaction instead of eth_sendTransaction.
+ * The transactions are legacy transactions with the EIP-155 replay protection.
+ * The secp256k1 context is created once, the signing methods can be called from several threads.
+ */
+class ETHRPCSHARED_EXPORT EthSigner
+{
+public:
+    /**
+     * @brief EthSigner Constructor
+     */
+    EthSigner();
+
+    /**
+     * @brief ~EthSigner Destructor, the private key is erased
+     */
+    virtual ~EthSigner();
+
+    /**
+     * @brief setPrivateKey Set the key used to sign.
+     * @param privateKey Private key, 32 Bytes binary.
+     * @return true if the key is valid.
+     */
+    bool setPrivateKey(const QByteArray& privateKey);
+
+    /**
+     * @brief address Return the address of the private key, the from of the signed transactions.
+     * @return Address, 20 Bytes binary, empty when no valid key is set.
+     */
+    QByteArray address() const;
+
+    /**
+     * @brief signTransaction Sign a transaction.
+     * @param transaction Transaction, the fields nonce, gasPrice, gas, to, value and data (or input) are used.
+     * The field to is null for a contract creation.
+     * @param chainId Chain id of the EIP-155 replay protection, 1 for the main network.
+     * @param signedData Signed transaction encoded with RLP, for eth_sendRawTransaction.
+     * @param transactionHash Optional output of the hash of the signed transaction.
+     * @return true if the transaction is signed.
+     */
+    bool signTransaction(const ETransaction& transaction, int64_t chainId, QByteArray& signedData, QByteArray* transactionHash = 0) const;
+
+    /**
+     * @brief signTransactions Sign several transactions, the hashes to sign are computed together.
+     * @param transactions Transactions to sign.
+     * @param chainId Chain id of the EIP-155 replay protection.
+     * @param signedData Signed transactions in the order of the transactions.
+     * @return true if every transaction is signed.
+     */
+    bool signTransactions(const QVector<ETransaction>& transactions, int64_t chainId, QVector<QByteArray>& signedData) const;
+
+    /**
+     * @brief signMessage Sign a message with the Ethereum prefix, like eth_sign.
+     * @param message Message to sign.
+     * @param signature Signature r, s, v of 65 Bytes binary, v is 27 or 28.
+     * @return true if the message is signed.
+     */
+    bool signMessage(const QByteArray& message, QByteArray& signature) const;
+
+private:
+    Signer_Private* m_p;
+};
+
+#endif // ETHSIGNER_H
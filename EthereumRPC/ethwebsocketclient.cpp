@@ -0,0 +1,673 @@
+#include "ethwebsocketclient.h"
+#include "jsoncoder.h"
+#include <QCryptographicHash>
+#include <QMetaObject>
+#include <random>
+#include <string.h>
+#ifndef QT_NO_SSL
+#include <QSslSocket>
+#endif
+
+namespace EthWebSocketClient_NS
+{
+    const int MSECS = 2000;
+    const int TIMEOUT_MSECS = 30000;
+    const int CHECK_MSECS = 500;
+    const int PING_MSECS = 30000;
+    const int MAX_MESSAGE_SIZE = 128 * 1024 * 1024;
+    const int MAX_HANDSHAKE_SIZE = 16 * 1024;
+    const char* const ACCEPT_GUID = "258EAFA5-E914-47DA-95CA-C5AB0DC85B11";
+}
+using namespace EthWebSocketClient_NS;
+
+static quint32 randomWord()
+{
+    static thread_local std::mt19937 generator(std::random_device{}());
+    return quint32(generator());
+}
+
+//XOR the payload with the masking key, 8 Bytes at a time
+static void maskPayload(const char* data, int size, const uchar* mask, char* out)
+{
+    uchar mask8[8];
+    memcpy(mask8, mask, 4);
+    memcpy(mask8 + 4, mask, 4);
+    quint64 mask64;
+    memcpy(&mask64, mask8, 8);
+
+    int i = 0;
+    for(; i + 8 <= size; i += 8)
+    {
+        quint64 word;
+        memcpy(&word, data + i, 8);
+        word ^= mask64;
+        memcpy(out + i, &word, 8);
+    }
+    for(; i < size; i++)
+    {
+        out[i] = char(data[i] ^ mask[i % 4]);
+    }
+}
+
+EthWebSocketClient::EthWebSocketClient(QString serverUrl, QObject *parent) : QObject(parent),
+    m_socket(0),
+    m_code(QAbstractSocket::UnknownSocketError),
+    m_fragmented(false),
+    m_closing(false),
+    m_waiting(0)
+{
+    m_parameters["serverUrl"] = serverUrl.isEmpty() ? defaultServerUrl() : serverUrl;
+    m_parameters["timeout"] = TIMEOUT_MSECS;
+    m_parameters["pingInterval"] = PING_MSECS;
+
+    m_clock.start();
+    m_timeoutTimer.setInterval(CHECK_MSECS);
+    connect(&m_timeoutTimer, SIGNAL(timeout()), this, SLOT(checkTimeouts()));
+    connect(&m_pingTimer, SIGNAL(timeout()), this, SLOT(sendPing()));
+}
+
+EthWebSocketClient::~EthWebSocketClient()
+{
+    disconnectToServer();
+}
+
+QVariantMap &EthWebSocketClient::clientParameters()
+{
+    return m_parameters;
+}
+
+bool EthWebSocketClient::connectToServer()
+{
+    disconnectToServer();
+
+    QUrl url(m_parameters["serverUrl"].toString());
+    bool ssl = url.scheme().compare("wss", Qt::CaseInsensitive) == 0;
+#ifndef QT_NO_SSL
+    if(ssl)
+        m_socket = new QSslSocket(this);
+#endif
+    if(!m_socket)
+        m_socket = new QTcpSocket(this);
+    m_socket->setSocketOption(QAbstractSocket::LowDelayOption, 1);
+    m_socket->setSocketOption(QAbstractSocket::KeepAliveOption, 1);
+    connect(m_socket, SIGNAL(error(QAbstractSocket::SocketError)),
+            this, SLOT(onSocketError(QAbstractSocket::SocketError)));
+
+    int port = url.port(ssl ? 443 : 80);
+#ifndef QT_NO_SSL
+    if(ssl)
+    {
+        QSslSocket* socket = static_cast<QSslSocket*>(m_socket);
+        socket->connectToHostEncrypted(url.host(), port);
+        if(!socket->waitForEncrypted(MSECS))
+            return false;
+    }
+    else
+#endif
+    {
+        m_socket->connectToHost(url.host(), port);
+        if(!m_socket->waitForConnected(MSECS))
+            return false;
+    }
+
+    if(!handshake(m_parameters["timeout"].toInt()))
+    {
+        m_socket->abort();
+        return false;
+    }
+
+    //The frames are read from the signal once the connection is upgraded
+    connect(m_socket, SIGNAL(readyRead()), this, SLOT(onSocketReadyRead()));
+    connect(m_socket, SIGNAL(disconnected()), this, SLOT(onSocketDisconnected()));
+    int pingInterval = m_parameters["pingInterval"].toInt();
+    if(pingInterval > 0)
+        m_pingTimer.start(pingInterval);
+    //Frames sent right after the handshake response
+    if(!m_buffer.isEmpty())
+        QMetaObject::invokeMethod(this, "onSocketReadyRead", Qt::QueuedConnection);
+    return true;
+}
+
+bool EthWebSocketClient::disconnectToServer()
+{
+    m_pingTimer.stop();
+    if(!m_socket)
+        return true;
+
+    QTcpSocket* socket = m_socket;
+    m_socket = 0;
+    socket->disconnect(this);
+    if(socket->state() == QAbstractSocket::ConnectedState && !m_closing)
+    {
+        //Close code 1000, normal closure
+        const char code[] = { char(0x03), char(0xE8) };
+        m_socket = socket;
+        writeFrame(Close, code, 2);
+        m_socket = 0;
+    }
+    socket->abort();
+    socket->deleteLater();
+
+    m_buffer.clear();
+    m_fragments.clear();
+    m_fragmented = false;
+    m_closing = false;
+    m_pending.clear();
+    m_responses.clear();
+    failAsyncRequests();
+    return true;
+}
+
+bool EthWebSocketClient::requestingResponse(const QByteArray &request, QByteArray &response)
+{
+    int64_t id = 0;
+    if(!peekJsonRPCId(request, id))
+    {
+        m_code = QAbstractSocket::UnknownSocketError;
+        m_error = "Invalid JSON RPC request";
+        return false;
+    }
+    if(!sendRequest(request, id))
+        return false;
+    return waitForResponse(id, response);
+}
+
+bool EthWebSocketClient::postRequest(const QByteArray &request, const ResponseHandler &handler)
+{
+    int64_t id = 0;
+    if(!peekJsonRPCId(request, id))
+    {
+        m_code = QAbstractSocket::UnknownSocketError;
+        m_error = "Invalid JSON RPC request";
+        handler(false, QByteArray());
+        return false;
+    }
+
+    AsyncRequest asyncRequest;
+    asyncRequest.handler = handler;
+    asyncRequest.deadline = m_clock.elapsed() + m_parameters["timeout"].toInt();
+    m_handlers.insert(id, asyncRequest);
+    if(!sendRequest(request, id))
+    {
+        m_handlers.remove(id);
+        handler(false, QByteArray());
+        return false;
+    }
+    //The handler owns the request, it is not waited synchronously
+    m_pending.remove(id);
+
+    if(!m_timeoutTimer.isActive())
+        m_timeoutTimer.start();
+    return true;
+}
+
+bool EthWebSocketClient::setNotificationHandler(const NotificationHandler &handler)
+{
+    m_notificationHandler = handler;
+    return true;
+}
+
+bool EthWebSocketClient::sendRequest(const QByteArray &request, int64_t id)
+{
+    if(!m_socket || m_socket->state() != QAbstractSocket::ConnectedState || m_closing)
+    {
+        m_code = QAbstractSocket::RemoteHostClosedError;
+        m_error = "Not connected to the server";
+        return false;
+    }
+
+    m_pending.insert(id);
+    if(!writeFrame(Text, request.constData(), request.size()))
+    {
+        m_pending.remove(id);
+        return false;
+    }
+    return true;
+}
+
+bool EthWebSocketClient::waitForResponse(int64_t id, QByteArray &response, int msecs)
+{
+    if(!m_pending.contains(id))
+        return false;
+    if(msecs < 0)
+        msecs = m_parameters["timeout"].toInt();
+
+    QElapsedTimer timer;
+    timer.start();
+    bool ret = true;
+    m_waiting++;
+    while(!m_responses.contains(id))
+    {
+        int remaining = msecs - int(timer.elapsed());
+        if(remaining <= 0)
+        {
+            connectionTimeout();
+            ret = false;
+            break;
+        }
+        if(!m_socket || !m_socket->waitForReadyRead(remaining))
+        {
+            if(m_socket && m_socket->error() == QAbstractSocket::SocketTimeoutError)
+                connectionTimeout();
+            ret = false;
+            break;
+        }
+        //readyRead is not emitted recursively, so drain the socket here as well
+        onSocketReadyRead();
+    }
+    m_waiting--;
+
+    if(ret)
+        response = m_responses.take(id);
+    m_pending.remove(id);
+    return ret;
+}
+
+bool EthWebSocketClient::waitForEvents(int msecs)
+{
+    if(!m_socket || m_socket->state() != QAbstractSocket::ConnectedState)
+        return false;
+    m_waiting++;
+    //readyRead is not emitted recursively, so drain the socket here as well
+    if(m_socket->bytesAvailable() > 0 || m_socket->waitForReadyRead(msecs))
+        onSocketReadyRead();
+    m_waiting--;
+    //The deadlines of the posted requests are checked here, the timer does not fire
+    if(!m_handlers.isEmpty())
+        checkTimeouts();
+    return m_socket && m_socket->state() == QAbstractSocket::ConnectedState;
+}
+
+bool EthWebSocketClient::canWaitForEvents() const
+{
+    return m_socket && m_socket->state() == QAbstractSocket::ConnectedState;
+}
+
+int64_t EthWebSocketClient::errorNumber()
+{
+    return m_code;
+}
+
+QString EthWebSocketClient::errorString()
+{
+    return m_error;
+}
+
+QString EthWebSocketClient::defaultServerUrl()
+{
+    return "ws://localhost:8546";
+}
+
+void EthWebSocketClient::onSocketReadyRead()
+{
+    if(!m_socket)
+        return;
+    if(m_socket->bytesAvailable() > 0)
+        m_buffer.append(m_socket->readAll());
+    if(m_buffer.isEmpty())
+        return;
+
+    //The parsed data is kept alive here, the messages point into it without copy
+    QByteArray data;
+    data.swap(m_buffer);
+    QList<QByteArray> messages;
+    int parsed = parseFrames(data, messages);
+    if(parsed < 0)
+    {
+        failConnection("Invalid WebSocket frame");
+        return;
+    }
+    if(parsed < data.size() && !m_closing)
+        m_buffer = data.mid(parsed);
+
+    //Dispatch once the stream state is consistent, the handlers may call back into the client
+    for(int i = 0; i < messages.size(); i++)
+    {
+        dispatchMessage(messages[i]);
+    }
+    if(m_closing)
+        failConnection("Connection closed by the server");
+}
+
+void EthWebSocketClient::onSocketDisconnected()
+{
+    m_pingTimer.stop();
+    m_buffer.clear();
+    m_fragments.clear();
+    m_fragmented = false;
+    m_pending.clear();
+    m_responses.clear();
+    failAsyncRequests();
+}
+
+void EthWebSocketClient::onSocketError(QAbstractSocket::SocketError err)
+{
+    if(m_socket)
+        m_error = m_socket->errorString();
+    m_code = err;
+}
+
+void EthWebSocketClient::checkTimeouts()
+{
+    qint64 now = m_clock.elapsed();
+    QList<ResponseHandler> expired;
+    QMutableHashIterator<int64_t, AsyncRequest> it(m_handlers);
+    while(it.hasNext())
+    {
+        it.next();
+        if(it.value().deadline <= now)
+        {
+            expired.append(it.value().handler);
+            it.remove();
+        }
+    }
+
+    if(m_handlers.isEmpty())
+        m_timeoutTimer.stop();
+    if(!expired.isEmpty())
+        connectionTimeout();
+    for(int i = 0; i < expired.size(); i++)
+    {
+        expired[i](false, QByteArray());
+    }
+}
+
+void EthWebSocketClient::sendPing()
+{
+    if(m_socket && m_socket->state() == QAbstractSocket::ConnectedState && !m_closing)
+        writeFrame(Ping, 0, 0);
+}
+
+void EthWebSocketClient::deliverNotifications()
+{
+    QList<QByteArray> notifications;
+    notifications.swap(m_notifications);
+    for(int i = 0; i < notifications.size(); i++)
+    {
+        if(m_notificationHandler)
+            m_notificationHandler(notifications[i]);
+    }
+}
+
+bool EthWebSocketClient::handshake(int msecs)
+{
+    QUrl url(m_parameters["serverUrl"].toString());
+    QByteArray key(16, 0);
+    for(int i = 0; i < key.size(); i += 4)
+    {
+        quint32 word = randomWord();
+        memcpy(key.data() + i, &word, 4);
+    }
+    key = key.toBase64();
+
+    QByteArray path = url.path(QUrl::FullyEncoded).toLatin1();
+    if(path.isEmpty()) path = "/";
+    if(url.hasQuery()) path += "?" + url.query(QUrl::FullyEncoded).toLatin1();
+    QByteArray request = "GET " + path + " HTTP/1.1\r\n";
+    //The IPv6 addresses keep their brackets in the host header
+    QByteArray host = url.host(QUrl::FullyEncoded).toLatin1();
+    if(host.contains(':')) host = "[" + host + "]";
+    request += "Host: " + host;
+    if(url.port() != -1) request += ":" + QByteArray::number(url.port());
+    request += "\r\n";
+    if(!url.userName().isEmpty())
+    {
+        QByteArray credentials = url.userName().toUtf8() + ":" + url.password().toUtf8();
+        request += "Authorization: Basic " + credentials.toBase64() + "\r\n";
+    }
+    request += "Upgrade: websocket\r\n";
+    request += "Connection: Upgrade\r\n";
+    request += "Sec-WebSocket-Key: " + key + "\r\n";
+    request += "Sec-WebSocket-Version: 13\r\n\r\n";
+    if(m_socket->write(request) != request.size())
+    {
+        m_error = m_socket->errorString();
+        return false;
+    }
+
+    //Read the response headers, the data after them is the beginning of the frames
+    QElapsedTimer timer;
+    timer.start();
+    QByteArray response;
+    int end = -1;
+    while((end = response.indexOf("\r\n\r\n")) < 0)
+    {
+        int remaining = msecs - int(timer.elapsed());
+        if(response.size() > MAX_HANDSHAKE_SIZE || remaining <= 0 || !m_socket->waitForReadyRead(remaining))
+        {
+            m_code = QAbstractSocket::SocketTimeoutError;
+            m_error = "Timeout while waiting for the WebSocket handshake";
+            return false;
+        }
+        response += m_socket->readAll();
+    }
+    m_buffer = response.mid(end + 4);
+
+    QList<QByteArray> lines = response.left(end).split('\n');
+    QList<QByteArray> status = lines.first().trimmed().split(' ');
+    if(status.size() < 2 || status[1] != "101")
+    {
+        m_code = QAbstractSocket::UnknownSocketError;
+        m_error = "WebSocket handshake refused: " + QString::fromLatin1(lines.first().trimmed());
+        return false;
+    }
+
+    QByteArray expected = QCryptographicHash::hash(key + ACCEPT_GUID, QCryptographicHash::Sha1).toBase64();
+    for(int i = 1; i < lines.size(); i++)
+    {
+        int colon = lines[i].indexOf(':');
+        if(colon > 0 && lines[i].left(colon).trimmed().toLower() == "sec-websocket-accept")
+        {
+            if(lines[i].mid(colon + 1).trimmed() == expected)
+                return true;
+            break;
+        }
+    }
+    m_code = QAbstractSocket::UnknownSocketError;
+    m_error = "Invalid WebSocket handshake accept key";
+    return false;
+}
+
+bool EthWebSocketClient::writeFrame(Opcode opcode, const char *data, int size)
+{
+    if(!m_socket)
+        return false;
+
+    //The frames of the client are masked, with a final bit and no fragmentation
+    QByteArray frame;
+    frame.resize(14 + size);
+    uchar* header = reinterpret_cast<uchar*>(frame.data());
+    int headerSize = 2;
+    header[0] = uchar(0x80 | opcode);
+    if(size < 126)
+    {
+        header[1] = uchar(0x80 | size);
+    }
+    else if(size <= 0xFFFF)
+    {
+        header[1] = uchar(0x80 | 126);
+        header[2] = uchar(size >> 8);
+        header[3] = uchar(size & 0xFF);
+        headerSize = 4;
+    }
+    else
+    {
+        header[1] = uchar(0x80 | 127);
+        for(int i = 0; i < 8; i++)
+            header[2 + i] = uchar((quint64(size) >> ((7 - i) * 8)) & 0xFF);
+        headerSize = 10;
+    }
+    quint32 mask = randomWord();
+    memcpy(header + headerSize, &mask, 4);
+    maskPayload(data, size, header + headerSize, frame.data() + headerSize + 4);
+    frame.resize(headerSize + 4 + size);
+
+    if(m_socket->write(frame) != frame.size())
+    {
+        m_error = m_socket->errorString();
+        return false;
+    }
+    m_socket->flush();
+    return true;
+}
+
+int EthWebSocketClient::parseFrames(const QByteArray &data, QList<QByteArray> &messages)
+{
+    const uchar* bytes = reinterpret_cast<const uchar*>(data.constData());
+    int size = data.size();
+    int pos = 0;
+    while(size - pos >= 2)
+    {
+        uchar first = bytes[pos];
+        uchar second = bytes[pos + 1];
+        bool fin = first & 0x80;
+        int opcode = first & 0x0F;
+        bool masked = second & 0x80;
+        //No extension is negotiated, the reserved bits must be zero
+        if(first & 0x70)
+            return -1;
+
+        quint64 length = second & 0x7F;
+        int headerSize = 2;
+        if(length == 126)
+        {
+            if(size - pos < 4) break;
+            length = (quint64(bytes[pos + 2]) << 8) | bytes[pos + 3];
+            headerSize = 4;
+        }
+        else if(length == 127)
+        {
+            if(size - pos < 10) break;
+            length = 0;
+            for(int i = 0; i < 8; i++)
+                length = (length << 8) | bytes[pos + 2 + i];
+            headerSize = 10;
+        }
+        if(length > quint64(MAX_MESSAGE_SIZE))
+            return -1;
+        int maskPos = pos + headerSize;
+        if(masked)
+            headerSize += 4;
+        if(size - pos < headerSize || quint64(size - pos - headerSize) < length)
+            break;
+
+        //The frames of the server are not masked, their payload is used in place
+        int payloadSize = int(length);
+        QByteArray payload = QByteArray::fromRawData(data.constData() + pos + headerSize, payloadSize);
+        if(masked)
+        {
+            QByteArray unmasked(payloadSize, 0);
+            maskPayload(payload.constData(), payloadSize, bytes + maskPos, unmasked.data());
+            payload = unmasked;
+        }
+        pos += headerSize + payloadSize;
+
+        switch(opcode)
+        {
+        case Text:
+        case Binary:
+            if(m_fragmented)
+                return -1;
+            if(fin)
+            {
+                messages.append(payload);
+            }
+            else
+            {
+                m_fragments = QByteArray(payload.constData(), payload.size());
+                m_fragmented = true;
+            }
+            break;
+        case Continuation:
+            if(!m_fragmented || m_fragments.size() + payloadSize > MAX_MESSAGE_SIZE)
+                return -1;
+            m_fragments.append(payload.constData(), payload.size());
+            if(fin)
+            {
+                messages.append(m_fragments);
+                m_fragments.clear();
+                m_fragmented = false;
+            }
+            break;
+        case Ping:
+            if(!fin || payloadSize > 125)
+                return -1;
+            writeFrame(Pong, payload.constData(), payload.size());
+            break;
+        case Pong:
+            break;
+        case Close:
+            //Echo the status code, the connection is dropped once the previous messages are dispatched
+            if(!m_closing)
+                writeFrame(Close, payload.constData(), qMin(payloadSize, 2));
+            m_closing = true;
+            return pos;
+        default:
+            return -1;
+        }
+    }
+    return pos;
+}
+
+void EthWebSocketClient::dispatchMessage(const QByteArray &message)
+{
+    int64_t id = 0;
+    if(!peekJsonRPCId(message, id))
+    {
+        //Messages without id are notifications, they are not delivered inside a blocking call
+        //so the handler can use the connection and the subscription is known before its first notification
+        if(!m_notificationHandler)
+            return;
+        if(m_waiting || !m_notifications.isEmpty())
+        {
+            if(m_notifications.isEmpty())
+                QMetaObject::invokeMethod(this, "deliverNotifications", Qt::QueuedConnection);
+            m_notifications.append(QByteArray(message.constData(), message.size()));
+            return;
+        }
+        m_notificationHandler(message);
+        return;
+    }
+
+    if(m_handlers.contains(id))
+    {
+        ResponseHandler handler = m_handlers.take(id).handler;
+        if(m_handlers.isEmpty())
+            m_timeoutTimer.stop();
+        handler(true, message);
+        return;
+    }
+
+    //Responses nobody waits for anymore (timed out) are dropped
+    if(m_pending.contains(id))
+    {
+        m_responses.insert(id, QByteArray(message.constData(), message.size()));
+        emit responseReceived(id);
+    }
+}
+
+void EthWebSocketClient::failConnection(const QString &error)
+{
+    m_code = QAbstractSocket::RemoteHostClosedError;
+    m_error = error;
+    if(m_socket)
+        m_socket->abort();
+    onSocketDisconnected();
+}
+
+void EthWebSocketClient::failAsyncRequests()
+{
+    QList<AsyncRequest> requests = m_handlers.values();
+    m_handlers.clear();
+    m_timeoutTimer.stop();
+    for(int i = 0; i < requests.size(); i++)
+    {
+        requests[i].handler(false, QByteArray());
+    }
+}
+
+void EthWebSocketClient::connectionTimeout()
+{
+    m_code = QAbstractSocket::SocketTimeoutError;
+    m_error = "Timeout while waiting for the response";
+}
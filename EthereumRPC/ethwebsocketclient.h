@@ -0,0 +1,101 @@
+#ifndef ETHWEBSOCKETCLIENT_H
+#define ETHWEBSOCKETCLIENT_H
+
+#include <QObject>
+#include <QTcpSocket>
+#include <QUrl>
+#include <QHash>
+#include <QSet>
+#include <QTimer>
+#include <QElapsedTimer>
+#include "iethclient.h"
+
+//JSON RPC over one WebSocket connection (RFC 6455), the requests in flight are matched to their responses by id
+class EthWebSocketClient : public QObject, public IEthClient
+{
+    Q_OBJECT
+public:
+    explicit EthWebSocketClient(QString serverUrl = QString(), QObject *parent = 0);
+    ~EthWebSocketClient();
+
+    QVariantMap &clientParameters() override;
+    bool connectToServer() override;
+    bool disconnectToServer() override;
+    bool requestingResponse(const QByteArray& request, QByteArray& response) override;
+    bool postRequest(const QByteArray& request, const ResponseHandler& handler) override;
+    bool setNotificationHandler(const NotificationHandler& handler) override;
+    bool waitForEvents(int msecs) override;
+    bool canWaitForEvents() const override;
+    int64_t errorNumber() override;
+    QString errorString() override;
+
+    //Write the request without waiting, several requests can be in flight on the connection
+    bool sendRequest(const QByteArray& request, int64_t id);
+    //Wait for the response with the given id, msecs < 0 use the "timeout" parameter
+    bool waitForResponse(int64_t id, QByteArray& response, int msecs = -1);
+
+    static QString defaultServerUrl();
+
+signals:
+    void responseReceived(qint64 id);
+
+private slots:
+    void onSocketReadyRead();
+    void onSocketDisconnected();
+    void onSocketError(QAbstractSocket::SocketError err);
+    void checkTimeouts();
+    void sendPing();
+    void deliverNotifications();
+
+private:
+    enum Opcode
+    {
+        Continuation = 0x0,
+        Text = 0x1,
+        Binary = 0x2,
+        Close = 0x8,
+        Ping = 0x9,
+        Pong = 0xA
+    };
+
+    struct AsyncRequest
+    {
+        ResponseHandler handler;
+        qint64 deadline;
+    };
+
+    bool handshake(int msecs);
+    bool writeFrame(Opcode opcode, const char* data, int size);
+    //Parse the complete frames of the data, the messages point into the data
+    //Return the size of the parsed data, -1 on protocol error, the parsing stop at the close frame
+    int parseFrames(const QByteArray& data, QList<QByteArray>& messages);
+    void dispatchMessage(const QByteArray& message);
+    void failConnection(const QString& error);
+    void failAsyncRequests();
+    void connectionTimeout();
+
+    QTcpSocket* m_socket;
+    QVariantMap m_parameters;
+    int m_code;
+    QString m_error;
+
+    //Incomplete frame at the end of the stream and fragments of the current message
+    QByteArray m_buffer;
+    QByteArray m_fragments;
+    bool m_fragmented;
+    bool m_closing;
+
+    QSet<int64_t> m_pending;
+    QHash<int64_t, QByteArray> m_responses;
+    QHash<int64_t, AsyncRequest> m_handlers;
+    QElapsedTimer m_clock;
+    QTimer m_timeoutTimer;
+    QTimer m_pingTimer;
+
+    NotificationHandler m_notificationHandler;
+    //Notifications received while waiting for a response, delivered from the event loop
+    QList<QByteArray> m_notifications;
+    int m_waiting;
+};
+
+#endif // ETHWEBSOCKETCLIENT_H
@@ -0,0 +1,319 @@
+#include "hexcodec.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define HEXCODEC_SSE2
+#endif
+//The AVX2 kernels are built for the CPUs of the build target, or with the target attribute
+//and selected at run time when the CPU supports them
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define HEXCODEC_AVX2
+#define HEXCODEC_AVX2_TARGET
+#elif (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define HEXCODEC_AVX2
+#define HEXCODEC_AVX2_TARGET __attribute__((target("avx2")))
+#define HEXCODEC_AVX2_DETECT
+#endif
+
+#define HEX_ROW(c) \
+    (c >= '0' && c <= '9') ? c - '0' : \
+    (c >= 'a' && c <= 'f') ? c - 'a' + 10 : \
+    (c >= 'A' && c <= 'F') ? c - 'A' + 10 : -1
+#define HEX_ROW4(c) HEX_ROW(c), HEX_ROW(c + 1), HEX_ROW(c + 2), HEX_ROW(c + 3)
+#define HEX_ROW16(c) HEX_ROW4(c), HEX_ROW4(c + 4), HEX_ROW4(c + 8), HEX_ROW4(c + 12)
+
+const signed char HEX_DIGIT_VALUES[256] = {
+    HEX_ROW16(0), HEX_ROW16(16), HEX_ROW16(32), HEX_ROW16(48),
+    HEX_ROW16(64), HEX_ROW16(80), HEX_ROW16(96), HEX_ROW16(112),
+    HEX_ROW16(128), HEX_ROW16(144), HEX_ROW16(160), HEX_ROW16(176),
+    HEX_ROW16(192), HEX_ROW16(208), HEX_ROW16(224), HEX_ROW16(240)
+};
+
+#undef HEX_ROW16
+#undef HEX_ROW4
+#undef HEX_ROW
+
+namespace HexCodec_NS {
+const char HEX_DIGITS[] = "0123456789abcdef";
+}
+using namespace HexCodec_NS;
+
+#ifdef HEXCODEC_SSE2
+//Convert the characters into nibbles, the valid mask has all bits set for the hex digits
+static inline __m128i nibbles128(__m128i chars, __m128i& valid)
+{
+    const __m128i bias = _mm_set1_epi8(char(0x80));
+    __m128i digit = _mm_sub_epi8(chars, _mm_set1_epi8('0'));
+    __m128i letter = _mm_sub_epi8(_mm_or_si128(chars, _mm_set1_epi8(0x20)), _mm_set1_epi8('a'));
+    //Unsigned comparisons through the signed ones
+    __m128i isDigit = _mm_cmplt_epi8(_mm_add_epi8(digit, bias), _mm_set1_epi8(char(0x80 + 10)));
+    __m128i isLetter = _mm_cmplt_epi8(_mm_add_epi8(letter, bias), _mm_set1_epi8(char(0x80 + 6)));
+    valid = _mm_or_si128(isDigit, isLetter);
+    return _mm_or_si128(_mm_and_si128(digit, isDigit),
+                        _mm_and_si128(_mm_add_epi8(letter, _mm_set1_epi8(10)), isLetter));
+}
+
+//Join the pairs of nibbles into 16 bits lanes holding one byte
+static inline __m128i joinNibbles128(__m128i nibbles)
+{
+    __m128i high = _mm_slli_epi16(_mm_and_si128(nibbles, _mm_set1_epi16(0x00FF)), 4);
+    return _mm_or_si128(high, _mm_srli_epi16(nibbles, 8));
+}
+
+static inline __m128i digits128(__m128i nibbles)
+{
+    __m128i letters = _mm_and_si128(_mm_cmpgt_epi8(nibbles, _mm_set1_epi8(9)), _mm_set1_epi8('a' - '0' - 10));
+    return _mm_add_epi8(_mm_add_epi8(nibbles, _mm_set1_epi8('0')), letters);
+}
+#endif
+
+#ifdef HEXCODEC_AVX2
+HEXCODEC_AVX2_TARGET static inline __m256i nibbles256(__m256i chars, __m256i& valid)
+{
+    const __m256i bias = _mm256_set1_epi8(char(0x80));
+    __m256i digit = _mm256_sub_epi8(chars, _mm256_set1_epi8('0'));
+    __m256i letter = _mm256_sub_epi8(_mm256_or_si256(chars, _mm256_set1_epi8(0x20)), _mm256_set1_epi8('a'));
+    __m256i isDigit = _mm256_cmpgt_epi8(_mm256_set1_epi8(char(0x80 + 10)), _mm256_add_epi8(digit, bias));
+    __m256i isLetter = _mm256_cmpgt_epi8(_mm256_set1_epi8(char(0x80 + 6)), _mm256_add_epi8(letter, bias));
+    valid = _mm256_or_si256(isDigit, isLetter);
+    return _mm256_or_si256(_mm256_and_si256(digit, isDigit),
+                           _mm256_and_si256(_mm256_add_epi8(letter, _mm256_set1_epi8(10)), isLetter));
+}
+
+HEXCODEC_AVX2_TARGET static inline __m256i joinNibbles256(__m256i nibbles)
+{
+    __m256i high = _mm256_slli_epi16(_mm256_and_si256(nibbles, _mm256_set1_epi16(0x00FF)), 4);
+    return _mm256_or_si256(high, _mm256_srli_epi16(nibbles, 8));
+}
+
+HEXCODEC_AVX2_TARGET static inline __m256i digits256(__m256i nibbles)
+{
+    __m256i letters = _mm256_and_si256(_mm256_cmpgt_epi8(nibbles, _mm256_set1_epi8(9)), _mm256_set1_epi8('a' - '0' - 10));
+    return _mm256_add_epi8(_mm256_add_epi8(nibbles, _mm256_set1_epi8('0')), letters);
+}
+#endif
+
+static bool decodeScalar(const char* hex, int count, unsigned char* out)
+{
+    for(int i = 0; i < count; i++)
+    {
+        int high = hexDigitValue(hex[i * 2]);
+        int low = hexDigitValue(hex[i * 2 + 1]);
+        if((high | low) < 0)
+            return false;
+        out[i] = (unsigned char)((high << 4) | low);
+    }
+    return true;
+}
+
+static void encodeScalar(const unsigned char* data, int size, char* out)
+{
+    for(int i = 0; i < size; i++)
+    {
+        out[i * 2] = HEX_DIGITS[data[i] >> 4];
+        out[i * 2 + 1] = HEX_DIGITS[data[i] & 0x0F];
+    }
+}
+
+static bool validateScalar(const char* hex, int size)
+{
+    for(int i = 0; i < size; i++)
+    {
+        if(hexDigitValue(hex[i]) < 0)
+            return false;
+    }
+    return true;
+}
+
+#ifdef HEXCODEC_SSE2
+static bool decodeSSE2(const char* hex, int count, unsigned char* out)
+{
+    int i = 0;
+    for(; i + 16 <= count; i += 16)
+    {
+        __m128i valid0, valid1;
+        __m128i nibbles0 = nibbles128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(hex + i * 2)), valid0);
+        __m128i nibbles1 = nibbles128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(hex + i * 2 + 16)), valid1);
+        if(_mm_movemask_epi8(_mm_and_si128(valid0, valid1)) != 0xFFFF)
+            return false;
+        __m128i bytes = _mm_packus_epi16(joinNibbles128(nibbles0), joinNibbles128(nibbles1));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), bytes);
+    }
+    return decodeScalar(hex + i * 2, count - i, out + i);
+}
+
+static void encodeSSE2(const unsigned char* data, int size, char* out)
+{
+    int i = 0;
+    for(; i + 16 <= size; i += 16)
+    {
+        __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        __m128i mask = _mm_set1_epi8(0x0F);
+        __m128i high = digits128(_mm_and_si128(_mm_srli_epi16(bytes, 4), mask));
+        __m128i low = digits128(_mm_and_si128(bytes, mask));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i * 2), _mm_unpacklo_epi8(high, low));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i * 2 + 16), _mm_unpackhi_epi8(high, low));
+    }
+    encodeScalar(data + i, size - i, out + i * 2);
+}
+
+static bool validateSSE2(const char* hex, int size)
+{
+    int i = 0;
+    for(; i + 16 <= size; i += 16)
+    {
+        __m128i valid;
+        nibbles128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(hex + i)), valid);
+        if(_mm_movemask_epi8(valid) != 0xFFFF)
+            return false;
+    }
+    return validateScalar(hex + i, size - i);
+}
+#define HEXCODEC_TAIL(Name) Name##SSE2
+#else
+#define HEXCODEC_TAIL(Name) Name##Scalar
+#endif
+
+#ifdef HEXCODEC_AVX2
+HEXCODEC_AVX2_TARGET static bool decodeAVX2(const char* hex, int count, unsigned char* out)
+{
+    int i = 0;
+    for(; i + 32 <= count; i += 32)
+    {
+        __m256i valid0, valid1;
+        __m256i nibbles0 = nibbles256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(hex + i * 2)), valid0);
+        __m256i nibbles1 = nibbles256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(hex + i * 2 + 32)), valid1);
+        if(_mm256_movemask_epi8(_mm256_and_si256(valid0, valid1)) != -1)
+            return false;
+        //The pack works on 128 bits lanes, the middle quarters are swapped back after
+        __m256i bytes = _mm256_packus_epi16(joinNibbles256(nibbles0), joinNibbles256(nibbles1));
+        bytes = _mm256_permute4x64_epi64(bytes, 0xD8);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), bytes);
+    }
+    return HEXCODEC_TAIL(decode)(hex + i * 2, count - i, out + i);
+}
+
+HEXCODEC_AVX2_TARGET static void encodeAVX2(const unsigned char* data, int size, char* out)
+{
+    int i = 0;
+    for(; i + 32 <= size; i += 32)
+    {
+        __m256i bytes = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+        __m256i mask = _mm256_set1_epi8(0x0F);
+        __m256i high = digits256(_mm256_and_si256(_mm256_srli_epi16(bytes, 4), mask));
+        __m256i low = digits256(_mm256_and_si256(bytes, mask));
+        //The unpack works on 128 bits lanes, the lanes are reordered after
+        __m256i first = _mm256_unpacklo_epi8(high, low);
+        __m256i second = _mm256_unpackhi_epi8(high, low);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i * 2), _mm256_permute2x128_si256(first, second, 0x20));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i * 2 + 32), _mm256_permute2x128_si256(first, second, 0x31));
+    }
+    HEXCODEC_TAIL(encode)(data + i, size - i, out + i * 2);
+}
+
+HEXCODEC_AVX2_TARGET static bool validateAVX2(const char* hex, int size)
+{
+    int i = 0;
+    for(; i + 32 <= size; i += 32)
+    {
+        __m256i valid;
+        nibbles256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(hex + i)), valid);
+        if(_mm256_movemask_epi8(valid) != -1)
+            return false;
+    }
+    return HEXCODEC_TAIL(validate)(hex + i, size - i);
+}
+#endif
+
+//The kernels of the selected implementation
+struct HexKernels
+{
+    HexKernel kernel;
+    bool (*decode)(const char* hex, int count, unsigned char* out);
+    void (*encode)(const unsigned char* data, int size, char* out);
+    bool (*validate)(const char* hex, int size);
+};
+
+static bool isSupported(HexKernel kernel)
+{
+    switch(kernel)
+    {
+    case HexKernelScalar:
+        return true;
+#ifdef HEXCODEC_SSE2
+    case HexKernelSSE2:
+        return true;
+#endif
+#ifdef HEXCODEC_AVX2
+    case HexKernelAVX2:
+#ifdef HEXCODEC_AVX2_DETECT
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx2");
+#else
+        return true;
+#endif
+#endif
+    default:
+        return false;
+    }
+}
+
+static HexKernels kernelsOf(HexKernel kernel)
+{
+    HexKernels kernels = { HexKernelScalar, decodeScalar, encodeScalar, validateScalar };
+#ifdef HEXCODEC_SSE2
+    if(kernel == HexKernelSSE2)
+    {
+        HexKernels sse2 = { HexKernelSSE2, decodeSSE2, encodeSSE2, validateSSE2 };
+        kernels = sse2;
+    }
+#endif
+#ifdef HEXCODEC_AVX2
+    if(kernel == HexKernelAVX2)
+    {
+        HexKernels avx2 = { HexKernelAVX2, decodeAVX2, encodeAVX2, validateAVX2 };
+        kernels = avx2;
+    }
+#endif
+    return kernels;
+}
+
+//The fastest supported kernels, detected on the first conversion
+static HexKernels& currentKernels()
+{
+    static HexKernels kernels = kernelsOf(isSupported(HexKernelAVX2) ? HexKernelAVX2 :
+                                          isSupported(HexKernelSSE2) ? HexKernelSSE2 : HexKernelScalar);
+    return kernels;
+}
+
+bool hexSetKernel(HexKernel kernel)
+{
+    if(!isSupported(kernel))
+        return false;
+    currentKernels() = kernelsOf(kernel);
+    return true;
+}
+
+HexKernel hexKernel()
+{
+    return currentKernels().kernel;
+}
+
+bool hexDecode(const char* hex, int size, unsigned char* out)
+{
+    if(size < 0 || size % 2)
+        return false;
+    return currentKernels().decode(hex, size / 2, out);
+}
+
+void hexEncode(const unsigned char* data, int size, char* out)
+{
+    currentKernels().encode(data, size, out);
+}
+
+bool hexValidate(const char* hex, int size)
+{
+    return currentKernels().validate(hex, size);
+}
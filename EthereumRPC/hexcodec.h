@@ -0,0 +1,36 @@
+#ifndef HEXCODEC_H
+#define HEXCODEC_H
+#include <stdint.h>
+
+//Hex conversions on raw spans without "0x" prefix, vectorized with SSE2, or AVX2 when the CPU supports it
+
+//Value of every character as hex digit, -1 when the character is not a hex digit
+extern const signed char HEX_DIGIT_VALUES[256];
+
+inline int hexDigitValue(char c)
+{
+    return HEX_DIGIT_VALUES[(unsigned char)c];
+}
+
+//Decode size / 2 bytes into the output, false when the size is odd or a digit is invalid
+bool hexDecode(const char* hex, int size, unsigned char* out);
+
+//Encode the data into 2 * size lower case digits
+void hexEncode(const unsigned char* data, int size, char* out);
+
+//true when all the characters are hex digits
+bool hexValidate(const char* hex, int size);
+
+//Implementations of the conversions, the fastest one supported by the build and the CPU is used by default
+enum HexKernel
+{
+    HexKernelScalar,
+    HexKernelSSE2,
+    HexKernelAVX2
+};
+
+//Select the implementation, false when it is not supported, not thread safe, for the tests and the benchmarks
+bool hexSetKernel(HexKernel kernel);
+HexKernel hexKernel();
+
+#endif // HEXCODEC_H
@@ -2,13 +2,47 @@
 #define IETHCLIENT_H
 #include <QByteArray>
 #include <QVariantMap>
+#include <functional>
 class IEthClient
 {
 public:
+    //Called once with the response of an asynchronous request,
+    //the response may point into the buffer of the transport and is only valid during the call
+    typedef std::function<void(bool success, const QByteArray& response)> ResponseHandler;
+    //Called with every message of the server that is not a response, like the eth_subscription notifications,
+    //the notification is only valid during the call
+    typedef std::function<void(const QByteArray& notification)> NotificationHandler;
+
     virtual QVariantMap& clientParameters() = 0;
     virtual bool connectToServer() = 0;
     virtual bool disconnectToServer() = 0;
     virtual bool requestingResponse(const QByteArray& request, QByteArray& response) = 0;
+    //Send the request without waiting for the response, the default implementation is blocking
+    virtual bool postRequest(const QByteArray& request, const ResponseHandler& handler)
+    {
+        QByteArray response;
+        bool ret = requestingResponse(request, response);
+        handler(ret, response);
+        return ret;
+    }
+    //Set the handler of the notifications, false when the transport can not receive them like HTTP
+    virtual bool setNotificationHandler(const NotificationHandler& handler)
+    {
+        Q_UNUSED(handler);
+        return false;
+    }
+    //Wait at most msecs for the data of the posted requests without running the event loop, their handlers are called from it
+    //and the notifications are delivered later from the event loop. false when the transport can not wait like when disconnected
+    virtual bool waitForEvents(int msecs)
+    {
+        Q_UNUSED(msecs);
+        return false;
+    }
+    //true when waitForEvents can wait for the posted requests, without side effect
+    virtual bool canWaitForEvents() const
+    {
+        return false;
+    }
     virtual int64_t errorNumber() = 0;
     virtual QString errorString() = 0;
     virtual ~IEthClient(){}
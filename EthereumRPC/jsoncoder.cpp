@@ -1,15 +1,480 @@
 #include "jsoncoder.h"
 #include "QJsonDocument"
 #include "QJsonObject"
+#include "QJsonArray"
 #include "QVariant"
 #include "QVariantMap"
+#include "QAtomicInteger"
+#include <cstring>
 
-bool decodeJsonRPC(const QByteArray &response, int64_t id, QVariant &result)
+JsonReader::JsonReader(const QByteArray &json) :
+    m_pos(json.constData()),
+    m_end(json.constData() + json.size()),
+    m_error(false)
+{}
+
+JsonReader::JsonReader(const char *begin, const char *end) :
+    m_pos(begin),
+    m_end(end),
+    m_error(false)
+{}
+
+JsonReader::Type JsonReader::peek()
+{
+    skipWhitespace();
+    if(m_pos >= m_end) return Invalid;
+    switch(*m_pos)
+    {
+    case 'n': return Null;
+    case 't':
+    case 'f': return Bool;
+    case '"': return String;
+    case '[': return Array;
+    case '{': return Object;
+    case '-': return Number;
+    default:
+        if(*m_pos >= '0' && *m_pos <= '9') return Number;
+        return Invalid;
+    }
+}
+
+bool JsonReader::hasError() const
+{
+    return m_error;
+}
+
+const char *JsonReader::position() const
+{
+    return m_pos;
+}
+
+const char *JsonReader::end() const
+{
+    return m_end;
+}
+
+bool JsonReader::readNull()
+{
+    skipWhitespace();
+    return readLiteral("null", 4);
+}
+
+bool JsonReader::readBool(bool &value)
+{
+    skipWhitespace();
+    value = m_pos < m_end && *m_pos == 't';
+    return value ? readLiteral("true", 4) : readLiteral("false", 5);
+}
+
+bool JsonReader::readInt(qint64 &value)
+{
+    const char* begin = 0;
+    bool integer = false;
+    if(!scanNumber(begin, integer)) return false;
+
+    const char* digits = *begin == '-' ? begin + 1 : begin;
+    if(!integer || m_pos - digits > 18)
+    {
+        bool ok = false;
+        QByteArray number = QByteArray::fromRawData(begin, int(m_pos - begin));
+        value = integer ? number.toLongLong(&ok) : qint64(number.toDouble(&ok));
+        return ok;
+    }
+
+    qint64 result = 0;
+    for(const char* p = digits; p < m_pos; p++)
+    {
+        result = result * 10 + (*p - '0');
+    }
+    value = digits == begin ? result : -result;
+    return true;
+}
+
+bool JsonReader::readDouble(double &value)
+{
+    const char* begin = 0;
+    bool integer = false;
+    if(!scanNumber(begin, integer)) return false;
+    bool ok = false;
+    value = QByteArray::fromRawData(begin, int(m_pos - begin)).toDouble(&ok);
+    return ok;
+}
+
+bool JsonReader::readRawString(const char *&data, int &size)
+{
+    skipWhitespace();
+    if(m_pos >= m_end || *m_pos != '"') return fail();
+    const char* begin = m_pos + 1;
+
+    //Fast path, the hex strings of the node never contain escape sequences
+    const char* quote = static_cast<const char*>(memchr(begin, '"', m_end - begin));
+    if(!quote) return fail();
+    if(!memchr(begin, '\\', quote - begin))
+    {
+        data = begin;
+        size = int(quote - begin);
+        m_pos = quote + 1;
+        return true;
+    }
+
+    const char* p = begin;
+    while(p < m_end && *p != '"')
+    {
+        if(*p == '\\') p++;
+        p++;
+    }
+    if(p >= m_end) return fail();
+    data = begin;
+    size = int(p - begin);
+    m_pos = p + 1;
+    return false;
+}
+
+static bool readHex4(const char *&p, const char *end, uint &code)
+{
+    if(end - p < 4) return false;
+    code = 0;
+    for(int i = 0; i < 4; i++, p++)
+    {
+        char c = *p;
+        code <<= 4;
+        if(c >= '0' && c <= '9') code |= c - '0';
+        else if(c >= 'a' && c <= 'f') code |= c - 'a' + 10;
+        else if(c >= 'A' && c <= 'F') code |= c - 'A' + 10;
+        else return false;
+    }
+    return true;
+}
+
+static void appendUtf8(QByteArray &utf8, uint code)
+{
+    if(code < 0x80)
+    {
+        utf8.append(char(code));
+    }
+    else if(code < 0x800)
+    {
+        utf8.append(char(0xC0 | (code >> 6)));
+        utf8.append(char(0x80 | (code & 0x3F)));
+    }
+    else if(code < 0x10000)
+    {
+        utf8.append(char(0xE0 | (code >> 12)));
+        utf8.append(char(0x80 | ((code >> 6) & 0x3F)));
+        utf8.append(char(0x80 | (code & 0x3F)));
+    }
+    else
+    {
+        utf8.append(char(0xF0 | (code >> 18)));
+        utf8.append(char(0x80 | ((code >> 12) & 0x3F)));
+        utf8.append(char(0x80 | ((code >> 6) & 0x3F)));
+        utf8.append(char(0x80 | (code & 0x3F)));
+    }
+}
+
+bool JsonReader::readString(QString &value)
+{
+    const char* data = 0;
+    int size = 0;
+    if(readRawString(data, size))
+    {
+        value = QString::fromUtf8(data, size);
+        return true;
+    }
+    if(m_error) return false;
+
+    QByteArray utf8;
+    utf8.reserve(size);
+    const char* p = data;
+    const char* end = data + size;
+    while(p < end)
+    {
+        char c = *p++;
+        if(c != '\\')
+        {
+            utf8.append(c);
+            continue;
+        }
+
+        if(p >= end) return fail();
+        char escape = *p++;
+        switch(escape)
+        {
+        case '"': utf8.append('"'); break;
+        case '\\': utf8.append('\\'); break;
+        case '/': utf8.append('/'); break;
+        case 'b': utf8.append('\b'); break;
+        case 'f': utf8.append('\f'); break;
+        case 'n': utf8.append('\n'); break;
+        case 'r': utf8.append('\r'); break;
+        case 't': utf8.append('\t'); break;
+        case 'u':
+        {
+            uint code = 0;
+            if(!readHex4(p, end, code)) return fail();
+            //Join the surrogate pairs
+            if(code >= 0xD800 && code <= 0xDBFF && end - p >= 6 && p[0] == '\\' && p[1] == 'u')
+            {
+                const char* low = p + 2;
+                uint lowCode = 0;
+                if(readHex4(low, end, lowCode) && lowCode >= 0xDC00 && lowCode <= 0xDFFF)
+                {
+                    code = 0x10000 + ((code - 0xD800) << 10) + (lowCode - 0xDC00);
+                    p = low;
+                }
+            }
+            appendUtf8(utf8, code);
+            break;
+        }
+        default:
+            return fail();
+        }
+    }
+    value = QString::fromUtf8(utf8);
+    return true;
+}
+
+bool JsonReader::readVariant(QVariant &value)
+{
+    switch(peek())
+    {
+    case Null:
+        value = QVariant();
+        return readNull();
+    case Bool:
+    {
+        bool boolean = false;
+        if(!readBool(boolean)) return false;
+        value = boolean;
+        return true;
+    }
+    case Number:
+    {
+        const char* begin = 0;
+        bool integer = false;
+        if(!scanNumber(begin, integer)) return false;
+        bool ok = false;
+        QByteArray number = QByteArray::fromRawData(begin, int(m_pos - begin));
+        if(integer)
+        {
+            qlonglong longValue = number.toLongLong(&ok);
+            if(ok)
+            {
+                value = longValue;
+                return true;
+            }
+        }
+        value = number.toDouble(&ok);
+        return true;
+    }
+    case String:
+    {
+        QString string;
+        if(!readString(string)) return false;
+        value = string;
+        return true;
+    }
+    case Array:
+    {
+        QVariantList list;
+        beginArray();
+        while(nextElement())
+        {
+            QVariant element;
+            if(!readVariant(element)) return false;
+            list.append(element);
+        }
+        if(m_error) return false;
+        value = list;
+        return true;
+    }
+    case Object:
+    {
+        QVariantMap map;
+        const char* key = 0;
+        int size = 0;
+        beginObject();
+        while(nextKey(key, size))
+        {
+            QVariant element;
+            if(!readVariant(element)) return false;
+            map.insert(QString::fromUtf8(key, size), element);
+        }
+        if(m_error) return false;
+        value = map;
+        return true;
+    }
+    default:
+        return fail();
+    }
+}
+
+bool JsonReader::skipValue()
+{
+    switch(peek())
+    {
+    case Null:
+        return readNull();
+    case Bool:
+    {
+        bool boolean = false;
+        return readBool(boolean);
+    }
+    case Number:
+    {
+        const char* begin = 0;
+        bool integer = false;
+        return scanNumber(begin, integer);
+    }
+    case String:
+    {
+        const char* data = 0;
+        int size = 0;
+        readRawString(data, size);
+        return !m_error;
+    }
+    case Array:
+    case Object:
+    {
+        int depth = 0;
+        while(m_pos < m_end)
+        {
+            char c = *m_pos;
+            if(c == '"')
+            {
+                const char* data = 0;
+                int size = 0;
+                readRawString(data, size);
+                if(m_error) return false;
+                continue;
+            }
+            m_pos++;
+            if(c == '{' || c == '[')
+            {
+                depth++;
+            }
+            else if(c == '}' || c == ']')
+            {
+                if(--depth == 0) return true;
+            }
+        }
+        return fail();
+    }
+    default:
+        return fail();
+    }
+}
+
+bool JsonReader::beginObject()
+{
+    skipWhitespace();
+    if(m_pos >= m_end || *m_pos != '{') return fail();
+    m_pos++;
+    return true;
+}
+
+bool JsonReader::nextKey(const char *&key, int &size)
+{
+    skipWhitespace();
+    if(m_pos >= m_end) return fail();
+    if(*m_pos == '}')
+    {
+        m_pos++;
+        return false;
+    }
+    if(*m_pos == ',') m_pos++;
+
+    readRawString(key, size);
+    if(m_error) return false;
+    skipWhitespace();
+    if(m_pos >= m_end || *m_pos != ':') return fail();
+    m_pos++;
+    return true;
+}
+
+bool JsonReader::beginArray()
+{
+    skipWhitespace();
+    if(m_pos >= m_end || *m_pos != '[') return fail();
+    m_pos++;
+    return true;
+}
+
+bool JsonReader::nextElement()
+{
+    skipWhitespace();
+    if(m_pos >= m_end) return fail();
+    if(*m_pos == ']')
+    {
+        m_pos++;
+        return false;
+    }
+    if(*m_pos == ',') m_pos++;
+    return true;
+}
+
+void JsonReader::skipWhitespace()
+{
+    while(m_pos < m_end && (*m_pos == ' ' || *m_pos == '\n' || *m_pos == '\r' || *m_pos == '\t'))
+        m_pos++;
+}
+
+bool JsonReader::scanNumber(const char *&begin, bool &integer)
+{
+    skipWhitespace();
+    begin = m_pos;
+    integer = true;
+    if(m_pos < m_end && *m_pos == '-') m_pos++;
+    const char* digits = m_pos;
+    while(m_pos < m_end)
+    {
+        char c = *m_pos;
+        if(c == '.' || c == 'e' || c == 'E' || c == '+' || (c == '-' && m_pos != digits))
+            integer = false;
+        else if(c < '0' || c > '9')
+            break;
+        m_pos++;
+    }
+    if(m_pos == digits) return fail();
+    return true;
+}
+
+bool JsonReader::readLiteral(const char *literal, int size)
+{
+    if(m_end - m_pos < size || memcmp(m_pos, literal, size) != 0) return fail();
+    m_pos += size;
+    return true;
+}
+
+bool JsonReader::fail()
+{
+    m_error = true;
+    m_pos = m_end;
+    return false;
+}
+
+//The ids wrap below 2^53 so they stay exact through the double of the JSON parser
+static const qint64 JSONRPC_ID_MASK = (Q_INT64_C(1) << 53) - 1;
+
+static int64_t nextJsonRPCId()
+{
+    static QAtomicInteger<qint64> methodId(0);
+    return (methodId.fetchAndAddRelaxed(1) & JSONRPC_ID_MASK) + 1;
+}
+
+static QVariantMap requestJsonRPC(const QString &method, const QVariant &params, int64_t &id)
+{
+    QVariantMap variantMap;
+    variantMap["jsonrpc"] = "2.0";
+    variantMap["method"] = method;
+    variantMap["params"] = params;
+    id = nextJsonRPCId();
+    variantMap["id"] = id;
+    return variantMap;
+}
+
+static bool resultJsonRPC(const QVariantMap &variantMap, int64_t &id, QVariant &result)
 {
-    QJsonDocument document = QJsonDocument::fromJson(response);
-    if(!document.isObject()) return false;
-    QJsonObject jsonObject = document.object();
-    QVariantMap variantMap = jsonObject.toVariantMap();
     if(!variantMap.contains("id") || !variantMap.contains("jsonrpc") || !variantMap.contains("result"))
         return false;
 
@@ -17,25 +482,425 @@ bool decodeJsonRPC(const QByteArray &response, int64_t id, QVariant &result)
     QString j_jsonrpc = variantMap["jsonrpc"].toString();
     QVariant j_result = variantMap["result"];
 
-    if(j_id != id) return false;
     if(j_jsonrpc != "2.0") return false;
 
+    id = j_id;
     result = j_result;
     return true;
 }
 
-QByteArray encodeJsonRPC(const QString &method, const QVariant &params, int64_t &id)
+bool decodeJsonRPC(const QByteArray &response, int64_t id, QVariant &result)
 {
-    static int64_t methodId = 0;
+    QJsonDocument document = QJsonDocument::fromJson(response);
+    if(!document.isObject()) return false;
+    QJsonObject jsonObject = document.object();
+    QVariantMap variantMap = jsonObject.toVariantMap();
 
-    QVariantMap variantMap;
-    variantMap["jsonrpc"] = "2.0";
-    variantMap["method"] = method;
-    variantMap["params"] = params;
-    id = ++methodId;
-    variantMap["id"] = id;
+    int64_t j_id = 0;
+    QVariant j_result;
+    if(!resultJsonRPC(variantMap, j_id, j_result)) return false;
+    if(j_id != id) return false;
+
+    result = j_result;
+    return true;
+}
+
+QByteArray encodeJsonRPC(const QString &method, const QVariant &params, int64_t &id)
+{
+    QVariantMap variantMap = requestJsonRPC(method, params, id);
     QJsonObject jsonObject = QJsonObject::fromVariantMap(variantMap);
     QJsonDocument document(jsonObject);
 
     return document.toJson();
 }
+
+QByteArray encodeJsonRPCBatch(const QList<const JsonRPCMethod*> &methods, const QVariantList &params, QVector<int64_t> &ids)
+{
+    QByteArray out;
+    QByteArray request;
+    ids.resize(methods.size());
+    out.reserve(methods.size() * 128);
+    out += '[';
+    for(int i = 0; i < methods.size(); i++)
+    {
+        if(i > 0) out += ',';
+        encodeJsonRPC(*methods[i], params.value(i), ids[i], request);
+        out += request;
+    }
+    out += ']';
+    return out;
+}
+
+JsonRPCMethod::JsonRPCMethod(const char *name) :
+    m_name(QString::fromLatin1(name))
+{
+    m_prefix = "{\"jsonrpc\":\"2.0\",\"method\":";
+    writeJson(m_name, m_prefix);
+    m_prefix += ",\"params\":";
+}
+
+const QString &JsonRPCMethod::name() const
+{
+    return m_name;
+}
+
+const QByteArray &JsonRPCMethod::prefix() const
+{
+    return m_prefix;
+}
+
+static void writeInteger(qint64 value, QByteArray &out)
+{
+    char digits[24];
+    int pos = sizeof(digits);
+    quint64 absolute = value < 0 ? quint64(0) - quint64(value) : quint64(value);
+    do
+    {
+        digits[--pos] = char('0' + absolute % 10);
+        absolute /= 10;
+    }
+    while(absolute);
+    if(value < 0) digits[--pos] = '-';
+    out.append(digits + pos, int(sizeof(digits)) - pos);
+}
+
+static void writeString(const char *data, int size, QByteArray &out)
+{
+    static const char hexDigits[] = "0123456789abcdef";
+    out += '"';
+    int start = 0;
+    for(int i = 0; i < size; i++)
+    {
+        uchar c = uchar(data[i]);
+        if(c >= 0x20 && c != '"' && c != '\\') continue;
+
+        out.append(data + start, i - start);
+        start = i + 1;
+        switch(c)
+        {
+        case '"': out += "\\\""; break;
+        case '\\': out += "\\\\"; break;
+        case '\n': out += "\\n"; break;
+        case '\r': out += "\\r"; break;
+        case '\t': out += "\\t"; break;
+        default:
+            out += "\\u00";
+            out += hexDigits[c >> 4];
+            out += hexDigits[c & 0xF];
+            break;
+        }
+    }
+    out.append(data + start, size - start);
+    out += '"';
+}
+
+void writeJson(const QVariant &value, QByteArray &out)
+{
+    switch(int(value.type()))
+    {
+    case QVariant::Invalid:
+        out += "null";
+        break;
+    case QVariant::Bool:
+        out += value.toBool() ? "true" : "false";
+        break;
+    case QVariant::Int:
+    case QVariant::LongLong:
+    case QVariant::UInt:
+        writeInteger(value.toLongLong(), out);
+        break;
+    case QVariant::ULongLong:
+        out += QByteArray::number(value.toULongLong());
+        break;
+    case QVariant::Double:
+        out += QByteArray::number(value.toDouble(), 'g', 17);
+        break;
+    case QVariant::ByteArray:
+    {
+        //The hex data of the E values
+        QByteArray data = value.toByteArray();
+        writeString(data.constData(), data.size(), out);
+        break;
+    }
+    case QVariant::List:
+    case QVariant::StringList:
+    {
+        QVariantList list = value.toList();
+        out += '[';
+        for(int i = 0; i < list.size(); i++)
+        {
+            if(i > 0) out += ',';
+            writeJson(list[i], out);
+        }
+        out += ']';
+        break;
+    }
+    case QVariant::Map:
+    {
+        QVariantMap map = value.toMap();
+        out += '{';
+        for(QVariantMap::const_iterator it = map.constBegin(); it != map.constEnd(); ++it)
+        {
+            if(it != map.constBegin()) out += ',';
+            writeJson(it.key(), out);
+            out += ':';
+            writeJson(it.value(), out);
+        }
+        out += '}';
+        break;
+    }
+    default:
+    {
+        QByteArray data = value.toString().toUtf8();
+        writeString(data.constData(), data.size(), out);
+        break;
+    }
+    }
+}
+
+void encodeJsonRPC(const JsonRPCMethod &method, const QVariant &params, int64_t &id, QByteArray &out)
+{
+    //A reserved buffer keep its capacity when resized to zero
+    out.reserve(qMax(out.capacity(), method.prefix().size() + 64));
+    out.resize(0);
+    id = nextJsonRPCId();
+    out += method.prefix();
+    writeJson(params, out);
+    out += ",\"id\":";
+    writeInteger(id, out);
+    out += '}';
+}
+
+//Decode one response object, the result is written into the output returned by lookup for its id
+template<class Lookup>
+static bool decodeResponse(JsonReader &reader, Lookup lookup, int64_t &id)
+{
+    bool hasId = false;
+    bool hasVersion = false;
+    bool decoded = false;
+    EValue* out = 0;
+    const char* resultBegin = 0;
+    const char* key = 0;
+    int size = 0;
+
+    if(!reader.beginObject()) return false;
+    while(reader.nextKey(key, size))
+    {
+        if(jsonKeyEquals(key, size, "id") && reader.peek() == JsonReader::Number)
+        {
+            qint64 j_id = 0;
+            hasId = reader.readInt(j_id);
+            id = j_id;
+            out = hasId ? lookup(id) : 0;
+        }
+        else if(jsonKeyEquals(key, size, "jsonrpc") && reader.peek() == JsonReader::String)
+        {
+            const char* version = 0;
+            int versionSize = 0;
+            hasVersion = reader.readRawString(version, versionSize) &&
+                    jsonKeyEquals(version, versionSize, "2.0");
+        }
+        else if(jsonKeyEquals(key, size, "result") && out)
+        {
+            out->fromJson(reader);
+            decoded = true;
+        }
+        else
+        {
+            //The id may come after the result, decode it once the output is known
+            if(jsonKeyEquals(key, size, "result"))
+                resultBegin = reader.position();
+            reader.skipValue();
+        }
+    }
+
+    if(reader.hasError() || !hasId || !hasVersion || !out)
+        return false;
+    if(!decoded)
+    {
+        if(!resultBegin) return false;
+        JsonReader resultReader(resultBegin, reader.end());
+        out->fromJson(resultReader);
+        if(resultReader.hasError()) return false;
+    }
+    return true;
+}
+
+bool decodeJsonRPC(const QByteArray &response, int64_t id, EValue &result)
+{
+    JsonReader reader(response);
+    int64_t j_id = 0;
+    bool ret = reader.peek() == JsonReader::Object &&
+            decodeResponse(reader, [id, &result](int64_t responseId) { return responseId == id ? &result : (EValue*)0; }, j_id);
+    if(!ret)
+        result.fromRawData(QVariant());
+    return ret;
+}
+
+bool decodeJsonRPCBatch(const QByteArray &response, const QHash<int64_t, EValue*> &outputs, QSet<int64_t> &decoded)
+{
+    JsonReader reader(response);
+    if(!reader.beginArray()) return false;
+
+    //The node may answer the calls in any order
+    while(reader.nextElement())
+    {
+        if(reader.peek() != JsonReader::Object)
+        {
+            reader.skipValue();
+            continue;
+        }
+        int64_t j_id = 0;
+        if(decodeResponse(reader, [&outputs, &decoded](int64_t responseId) {
+                return decoded.contains(responseId) ? (EValue*)0 : outputs.value(responseId); }, j_id))
+            decoded.insert(j_id);
+    }
+    return !reader.hasError();
+}
+
+//Read the id of an object and skip the rest of the object
+static bool readObjectId(JsonReader &reader, int64_t &id)
+{
+    bool ret = false;
+    const char* key = 0;
+    int size = 0;
+    if(!reader.beginObject()) return false;
+    while(reader.nextKey(key, size))
+    {
+        if(!ret && jsonKeyEquals(key, size, "id") && reader.peek() == JsonReader::Number)
+        {
+            qint64 j_id = 0;
+            ret = reader.readInt(j_id);
+            id = j_id;
+        }
+        else
+        {
+            reader.skipValue();
+        }
+    }
+    return ret && !reader.hasError();
+}
+
+bool peekJsonRPCId(const QByteArray &json, int64_t &id)
+{
+    JsonReader reader(json);
+    JsonReader::Type type = reader.peek();
+    if(type == JsonReader::Object)
+        return readObjectId(reader, id);
+
+    if(type == JsonReader::Array)
+    {
+        bool ret = false;
+        reader.beginArray();
+        while(reader.nextElement())
+        {
+            int64_t j_id = 0;
+            if(reader.peek() == JsonReader::Object && readObjectId(reader, j_id))
+            {
+                if(!ret || j_id < id) id = j_id;
+                ret = true;
+            }
+            else if(!reader.hasError())
+            {
+                reader.skipValue();
+            }
+        }
+        return ret && !reader.hasError();
+    }
+    return false;
+}
+
+bool peekJsonRPCError(const QByteArray &json)
+{
+    JsonReader reader(json);
+    if(reader.peek() != JsonReader::Object || !reader.beginObject())
+        return false;
+    const char* key = 0;
+    int size = 0;
+    while(reader.nextKey(key, size))
+    {
+        if(jsonKeyEquals(key, size, "error"))
+            return reader.peek() != JsonReader::Null;
+        reader.skipValue();
+    }
+    return false;
+}
+
+//Read the params of a notification, the result is decoded into the output of the subscription
+static bool decodeNotificationParams(JsonReader &reader, const std::function<EValue*(const QByteArray&)> &lookup,
+                                     QByteArray &subscription, EValue*& out, const char*& resultBegin)
+{
+    bool decoded = false;
+    const char* key = 0;
+    int size = 0;
+    if(!reader.beginObject()) return false;
+    while(reader.nextKey(key, size))
+    {
+        if(jsonKeyEquals(key, size, "subscription") && reader.peek() == JsonReader::String)
+        {
+            const char* id = 0;
+            int idSize = 0;
+            if(reader.readRawString(id, idSize))
+            {
+                subscription = QByteArray(id, idSize);
+                out = lookup(subscription);
+            }
+        }
+        else if(jsonKeyEquals(key, size, "result") && out)
+        {
+            out->fromJson(reader);
+            decoded = true;
+        }
+        else
+        {
+            //The subscription may come after the result
+            if(jsonKeyEquals(key, size, "result"))
+                resultBegin = reader.position();
+            reader.skipValue();
+        }
+    }
+    return decoded;
+}
+
+bool decodeJsonRPCNotification(const QByteArray &notification, const std::function<EValue*(const QByteArray&)> &lookup,
+                               QByteArray &subscription)
+{
+    JsonReader reader(notification);
+    bool isNotification = false;
+    bool decoded = false;
+    EValue* out = 0;
+    const char* resultBegin = 0;
+    const char* key = 0;
+    int size = 0;
+
+    if(!reader.beginObject()) return false;
+    while(reader.nextKey(key, size))
+    {
+        if(jsonKeyEquals(key, size, "method") && reader.peek() == JsonReader::String)
+        {
+            const char* method = 0;
+            int methodSize = 0;
+            isNotification = reader.readRawString(method, methodSize) &&
+                    jsonKeyEquals(method, methodSize, "eth_subscription");
+        }
+        else if(jsonKeyEquals(key, size, "params") && reader.peek() == JsonReader::Object)
+        {
+            decoded = decodeNotificationParams(reader, lookup, subscription, out, resultBegin);
+        }
+        else
+        {
+            reader.skipValue();
+        }
+    }
+
+    if(reader.hasError() || !isNotification || !out)
+        return false;
+    if(!decoded)
+    {
+        if(!resultBegin) return false;
+        JsonReader resultReader(resultBegin, reader.end());
+        out->fromJson(resultReader);
+        if(resultReader.hasError()) return false;
+    }
+    return true;
+}
@@ -1,10 +1,110 @@
 #ifndef JSONCODER_H
 #define JSONCODER_H
 #include "QByteArray"
+#include "QHash"
+#include "QSet"
+#include "QStringList"
 #include "ethobject.h"
+#include <functional>
+
+//Pull reader that decode a JSON document in one pass without building an intermediate tree
+class JsonReader
+{
+public:
+    enum Type
+    {
+        Invalid,
+        Null,
+        Bool,
+        Number,
+        String,
+        Array,
+        Object
+    };
+
+    //The data must stay alive while the reader is used
+    explicit JsonReader(const QByteArray& json);
+    JsonReader(const char* begin, const char* end);
+
+    Type peek();
+    bool hasError() const;
+    const char* position() const;
+    const char* end() const;
+
+    bool readNull();
+    bool readBool(bool& value);
+    bool readInt(qint64& value);
+    bool readDouble(double& value);
+    //Point to the content of the string without copy, false when it contains escape sequences
+    bool readRawString(const char*& data, int& size);
+    bool readString(QString& value);
+    bool readVariant(QVariant& value);
+    bool skipValue();
+
+    bool beginObject();
+    //Read the next key of the object, false at the end of the object
+    bool nextKey(const char*& key, int& size);
+    bool beginArray();
+    //Move to the next element of the array, false at the end of the array
+    bool nextElement();
+
+private:
+    void skipWhitespace();
+    bool scanNumber(const char*& begin, bool& integer);
+    bool readLiteral(const char* literal, int size);
+    bool fail();
+
+    const char* m_pos;
+    const char* m_end;
+    bool m_error;
+};
+
+//Method of the JSON RPC, the beginning of its requests is built once
+class JsonRPCMethod
+{
+public:
+    explicit JsonRPCMethod(const char* name);
+    const QString& name() const;
+    //{"jsonrpc":"2.0","method":"<name>","params":
+    const QByteArray& prefix() const;
+
+private:
+    QString m_name;
+    QByteArray m_prefix;
+};
+
+//The method of a string literal, created once for every place it is used
+#define JSONRPC_METHOD(Name) \
+    ([]() -> const JsonRPCMethod& { static const JsonRPCMethod method(Name); return method; }())
 
 QByteArray encodeJsonRPC(const QString& method, const QVariant& params, int64_t& id);
 
+//Write the compact request into the output buffer, the capacity of the buffer is reused
+void encodeJsonRPC(const JsonRPCMethod& method, const QVariant& params, int64_t& id, QByteArray& out);
+
+//Append the value as compact JSON
+void writeJson(const QVariant& value, QByteArray& out);
+
 bool decodeJsonRPC(const QByteArray& response, int64_t id, QVariant& result);
 
+//Decode the response straight into the result object, without intermediate QVariant
+bool decodeJsonRPC(const QByteArray& response, int64_t id, EValue& result);
+
+//Encode the calls into one batch request, the ids are returned in the order of the calls
+QByteArray encodeJsonRPCBatch(const QList<const JsonRPCMethod*>& methods, const QVariantList& params, QVector<int64_t>& ids);
+
+//Decode the results of a batch response into the outputs of their ids, the decoded ids are returned
+bool decodeJsonRPCBatch(const QByteArray& response, const QHash<int64_t, EValue*>& outputs, QSet<int64_t>& decoded);
+
+//Read the id of a request or response, for a batch the lowest id of the array
+bool peekJsonRPCId(const QByteArray& json, int64_t& id);
+
+//true when the response is an object with a non null error, the result is not decoded
+bool peekJsonRPCError(const QByteArray& json);
+
+//Decode an eth_subscription notification, the result is written into the output returned by lookup
+//for the subscription id, the notifications of unknown subscriptions return false
+bool decodeJsonRPCNotification(const QByteArray& notification, const std::function<EValue*(const QByteArray& subscription)>& lookup,
+                               QByteArray& subscription);
+
 #endif // JSONCODER_H
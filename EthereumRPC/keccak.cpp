@@ -0,0 +1,225 @@
+#include "keccak.h"
+#include <string.h>
+
+namespace Keccak_NS {
+const uint64_t ROUND_CONSTANTS[24] = {
+    0x0000000000000001ULL, 0x0000000000008082ULL, 0x800000000000808aULL, 0x8000000080008000ULL,
+    0x000000000000808bULL, 0x0000000080000001ULL, 0x8000000080008081ULL, 0x8000000000008009ULL,
+    0x000000000000008aULL, 0x0000000000000088ULL, 0x0000000080008009ULL, 0x000000008000000aULL,
+    0x000000008000808bULL, 0x800000000000008bULL, 0x8000000000008089ULL, 0x8000000000008003ULL,
+    0x8000000000008002ULL, 0x8000000000000080ULL, 0x000000000000800aULL, 0x800000008000000aULL,
+    0x8000000080008081ULL, 0x8000000000008080ULL, 0x0000000080000001ULL, 0x8000000080008008ULL
+};
+const int LANES = 25;
+}
+using namespace Keccak_NS;
+
+static inline uint64_t rotateLeft(uint64_t value, int shift)
+{
+    return (value << shift) | (value >> (64 - shift));
+}
+
+static inline uint64_t load64(const unsigned char* data)
+{
+    uint64_t value = 0;
+    for(int i = 7; i >= 0; i--)
+        value = (value << 8) | data[i];
+    return value;
+}
+
+static inline void store64(uint64_t value, unsigned char* data)
+{
+    for(int i = 0; i < 8; i++)
+        data[i] = (unsigned char)(value >> (i * 8));
+}
+
+//Keccak-f[1600] on N interleaved states, the inner loops on the states are vectorized by the compiler
+//The lanes are stored as state[lane][index of the state]
+template<int N>
+static void keccakf(uint64_t (*state)[N])
+{
+    for(int round = 0; round < 24; round++)
+    {
+        uint64_t c[5][N];
+        uint64_t t[N];
+        uint64_t b[N];
+
+        //Theta
+        for(int x = 0; x < 5; x++)
+            for(int n = 0; n < N; n++)
+                c[x][n] = state[x][n] ^ state[x + 5][n] ^ state[x + 10][n] ^ state[x + 15][n] ^ state[x + 20][n];
+        for(int x = 0; x < 5; x++)
+        {
+            for(int n = 0; n < N; n++)
+            {
+                uint64_t d = c[(x + 4) % 5][n] ^ rotateLeft(c[(x + 1) % 5][n], 1);
+                state[x][n] ^= d;
+                state[x + 5][n] ^= d;
+                state[x + 10][n] ^= d;
+                state[x + 15][n] ^= d;
+                state[x + 20][n] ^= d;
+            }
+        }
+
+        //Rho and Pi, unrolled along the cycle of the lanes
+        for(int n = 0; n < N; n++)
+            t[n] = state[1][n];
+#define KECCAK_RHO_PI(Lane, Rotation) \
+        for(int n = 0; n < N; n++) \
+        { \
+            b[n] = state[Lane][n]; \
+            state[Lane][n] = rotateLeft(t[n], Rotation); \
+            t[n] = b[n]; \
+        }
+        KECCAK_RHO_PI(10, 1)  KECCAK_RHO_PI(7, 3)   KECCAK_RHO_PI(11, 6)  KECCAK_RHO_PI(17, 10)
+        KECCAK_RHO_PI(18, 15) KECCAK_RHO_PI(3, 21)  KECCAK_RHO_PI(5, 28)  KECCAK_RHO_PI(16, 36)
+        KECCAK_RHO_PI(8, 45)  KECCAK_RHO_PI(21, 55) KECCAK_RHO_PI(24, 2)  KECCAK_RHO_PI(4, 14)
+        KECCAK_RHO_PI(15, 27) KECCAK_RHO_PI(23, 41) KECCAK_RHO_PI(19, 56) KECCAK_RHO_PI(13, 8)
+        KECCAK_RHO_PI(12, 25) KECCAK_RHO_PI(2, 43)  KECCAK_RHO_PI(20, 62) KECCAK_RHO_PI(14, 18)
+        KECCAK_RHO_PI(22, 39) KECCAK_RHO_PI(9, 61)  KECCAK_RHO_PI(6, 20)  KECCAK_RHO_PI(1, 44)
+#undef KECCAK_RHO_PI
+
+        //Chi
+        for(int y = 0; y < 25; y += 5)
+        {
+            for(int n = 0; n < N; n++)
+            {
+                uint64_t a0 = state[y][n], a1 = state[y + 1][n], a2 = state[y + 2][n];
+                uint64_t a3 = state[y + 3][n], a4 = state[y + 4][n];
+                state[y][n] = a0 ^ (~a1 & a2);
+                state[y + 1][n] = a1 ^ (~a2 & a3);
+                state[y + 2][n] = a2 ^ (~a3 & a4);
+                state[y + 3][n] = a3 ^ (~a4 & a0);
+                state[y + 4][n] = a4 ^ (~a0 & a1);
+            }
+        }
+
+        //Iota
+        for(int n = 0; n < N; n++)
+            state[0][n] ^= ROUND_CONSTANTS[round];
+    }
+}
+
+//Xor one block of Rate bytes into the state N
+template<int N>
+static inline void absorb(uint64_t (*state)[N], int n, const unsigned char* block)
+{
+    for(int i = 0; i < Keccak256::Rate / 8; i++)
+        state[i][n] ^= load64(block + i * 8);
+}
+
+//Build the last block with the Keccak padding, data hold the remaining bytes
+static inline void padBlock(const unsigned char* data, size_t size, unsigned char* block)
+{
+    memset(block, 0, Keccak256::Rate);
+    if(size)
+        memcpy(block, data, size);
+    block[size] ^= 0x01;
+    block[Keccak256::Rate - 1] ^= 0x80;
+}
+
+Keccak256::Keccak256()
+{
+    reset();
+}
+
+void Keccak256::reset()
+{
+    memset(m_state, 0, sizeof(m_state));
+    m_bufferSize = 0;
+}
+
+void Keccak256::update(const void *data, size_t size)
+{
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    uint64_t (*state)[1] = reinterpret_cast<uint64_t (*)[1]>(m_state);
+    if(m_bufferSize)
+    {
+        size_t count = Rate - m_bufferSize < size ? Rate - m_bufferSize : size;
+        memcpy(m_buffer + m_bufferSize, bytes, count);
+        m_bufferSize += count;
+        bytes += count;
+        size -= count;
+        if(m_bufferSize < Rate)
+            return;
+        absorb<1>(state, 0, m_buffer);
+        keccakf<1>(state);
+        m_bufferSize = 0;
+    }
+    while(size >= Rate)
+    {
+        absorb<1>(state, 0, bytes);
+        keccakf<1>(state);
+        bytes += Rate;
+        size -= Rate;
+    }
+    if(size)
+    {
+        memcpy(m_buffer, bytes, size);
+        m_bufferSize = size;
+    }
+}
+
+void Keccak256::finalize(unsigned char *hash)
+{
+    uint64_t (*state)[1] = reinterpret_cast<uint64_t (*)[1]>(m_state);
+    unsigned char block[Rate];
+    padBlock(m_buffer, m_bufferSize, block);
+    absorb<1>(state, 0, block);
+    keccakf<1>(state);
+    for(int i = 0; i < HashSize / 8; i++)
+        store64(m_state[i], hash + i * 8);
+}
+
+void Keccak256::hash(const void *data, size_t size, unsigned char *hash)
+{
+    Keccak256 keccak;
+    keccak.update(data, size);
+    keccak.finalize(hash);
+}
+
+void Keccak256::hashBatch(const unsigned char * const *data, const size_t *sizes, int count, unsigned char *hashes)
+{
+    for(int first = 0; first < count; first += Lanes)
+    {
+        int lanes = count - first < Lanes ? count - first : int(Lanes);
+        uint64_t state[LANES][Lanes];
+        memset(state, 0, sizeof(state));
+
+        //Every buffer has its full blocks and one padded block, the shorter buffers are done first
+        size_t blocks[Lanes];
+        size_t maxBlocks = 0;
+        for(int n = 0; n < lanes; n++)
+        {
+            blocks[n] = sizes[first + n] / Rate + 1;
+            if(blocks[n] > maxBlocks)
+                maxBlocks = blocks[n];
+        }
+
+        unsigned char block[Rate];
+        for(size_t i = 0; i < maxBlocks; i++)
+        {
+            for(int n = 0; n < lanes; n++)
+            {
+                if(i + 1 < blocks[n])
+                {
+                    absorb<Lanes>(state, n, data[first + n] + i * Rate);
+                }
+                else if(i + 1 == blocks[n])
+                {
+                    padBlock(data[first + n] + i * Rate, sizes[first + n] - i * Rate, block);
+                    absorb<Lanes>(state, n, block);
+                }
+            }
+            keccakf<Lanes>(state);
+            for(int n = 0; n < lanes; n++)
+            {
+                if(i + 1 == blocks[n])
+                {
+                    for(int j = 0; j < HashSize / 8; j++)
+                        store64(state[j][n], hashes + (first + n) * HashSize + j * 8);
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,37 @@
+#ifndef KECCAK_H
+#define KECCAK_H
+#include <stdint.h>
+#include <stddef.h>
+
+//Keccak-256 as used by Ethereum, with the original padding and not the one of the standardized SHA3-256
+class Keccak256
+{
+public:
+    enum
+    {
+        HashSize = 32,
+        //Bytes absorbed by every permutation
+        Rate = 136,
+        //Buffers hashed together by hashBatch
+        Lanes = 4
+    };
+
+    Keccak256();
+    void reset();
+    void update(const void* data, size_t size);
+    //Write the 32 Bytes hash, the object must be reset before being used again
+    void finalize(unsigned char* hash);
+
+    static void hash(const void* data, size_t size, unsigned char* hash);
+
+    //Hash independent buffers, the permutations of every group of Lanes buffers are interleaved
+    //The hashes are written one after the other in the output
+    static void hashBatch(const unsigned char* const* data, const size_t* sizes, int count, unsigned char* hashes);
+
+private:
+    uint64_t m_state[25];
+    unsigned char m_buffer[Rate];
+    size_t m_bufferSize;
+};
+
+#endif // KECCAK_H
@@ -0,0 +1,246 @@
+#include "rlp.h"
+#include <string.h>
+
+namespace RLP_NS {
+const unsigned char STRING_OFFSET = 0x80;
+const unsigned char LIST_OFFSET = 0xc0;
+//Lengths up to 55 are in the prefix byte
+const int SHORT_LENGTH = 55;
+}
+using namespace RLP_NS;
+
+static int bigEndianSize(uint64_t value)
+{
+    int size = 0;
+    while(value)
+    {
+        size++;
+        value >>= 8;
+    }
+    return size;
+}
+
+static void writeBigEndian(uint64_t value, int size, char* out)
+{
+    for(int i = size - 1; i >= 0; i--)
+    {
+        out[i] = char(value & 0xFF);
+        value >>= 8;
+    }
+}
+
+RLPEncoder::RLPEncoder()
+{}
+
+void RLPEncoder::reserve(int size)
+{
+    m_data.reserve(size);
+}
+
+void RLPEncoder::clear()
+{
+    m_data.resize(0);
+    m_lists.resize(0);
+}
+
+void RLPEncoder::addBytes(const char *data, int size)
+{
+    if(size == 1 && (unsigned char)data[0] < STRING_OFFSET)
+    {
+        m_data.append(data[0]);
+        return;
+    }
+    addLength(size, STRING_OFFSET);
+    m_data.append(data, size);
+}
+
+void RLPEncoder::addBytes(const QByteArray &data)
+{
+    addBytes(data.constData(), data.size());
+}
+
+void RLPEncoder::addUInt(uint64_t value)
+{
+    char bytes[8];
+    int size = bigEndianSize(value);
+    writeBigEndian(value, size, bytes);
+    addBytes(bytes, size);
+}
+
+void RLPEncoder::addUInt(const UInt256 &value)
+{
+    unsigned char bytes[32];
+    value.toBigEndian(bytes);
+    int skip = 0;
+    while(skip < 32 && !bytes[skip])
+        skip++;
+    addBytes(reinterpret_cast<const char*>(bytes + skip), 32 - skip);
+}
+
+void RLPEncoder::beginList()
+{
+    m_lists.append(m_data.size());
+}
+
+void RLPEncoder::endList()
+{
+    if(m_lists.isEmpty())
+        return;
+    int begin = m_lists.takeLast();
+    int length = m_data.size() - begin;
+
+    //Build the prefix at the end, then move it before the content of the list
+    int end = m_data.size();
+    addLength(length, LIST_OFFSET);
+    QByteArray prefix = m_data.mid(end);
+    m_data.resize(end);
+    m_data.insert(begin, prefix);
+}
+
+const QByteArray &RLPEncoder::data() const
+{
+    return m_data;
+}
+
+void RLPEncoder::addLength(int length, unsigned char offset)
+{
+    if(length <= SHORT_LENGTH)
+    {
+        m_data.append(char(offset + length));
+        return;
+    }
+    char bytes[8];
+    int size = bigEndianSize(uint64_t(length));
+    writeBigEndian(uint64_t(length), size, bytes);
+    m_data.append(char(offset + SHORT_LENGTH + size));
+    m_data.append(bytes, size);
+}
+
+RLPItem::RLPItem():
+    m_data(0),
+    m_payload(0),
+    m_payloadSize(0),
+    m_encodedSize(0),
+    m_list(false)
+{}
+
+RLPItem::RLPItem(const char *data, int size):
+    RLPItem()
+{
+    if(!data || size <= 0)
+        return;
+
+    unsigned char prefix = (unsigned char)data[0];
+    int headerSize = 1;
+    int payloadSize = 0;
+    bool list = prefix >= LIST_OFFSET;
+    unsigned char offset = list ? LIST_OFFSET : STRING_OFFSET;
+
+    if(prefix < STRING_OFFSET)
+    {
+        //Single byte
+        headerSize = 0;
+        payloadSize = 1;
+    }
+    else if(prefix <= offset + SHORT_LENGTH)
+    {
+        payloadSize = prefix - offset;
+    }
+    else
+    {
+        int lengthSize = prefix - offset - SHORT_LENGTH;
+        if(lengthSize > 4 || 1 + lengthSize > size || data[1] == 0)
+            return;
+        uint64_t length = 0;
+        for(int i = 0; i < lengthSize; i++)
+            length = (length << 8) | (unsigned char)data[1 + i];
+        if(length <= uint64_t(SHORT_LENGTH) || length > uint64_t(size))
+            return;
+        headerSize = 1 + lengthSize;
+        payloadSize = int(length);
+    }
+
+    if(headerSize + payloadSize > size)
+        return;
+    //A single byte below 0x80 must not be encoded as a string
+    if(!list && headerSize == 1 && payloadSize == 1 && (unsigned char)data[1] < STRING_OFFSET)
+        return;
+
+    m_data = data;
+    m_payload = data + headerSize;
+    m_payloadSize = payloadSize;
+    m_encodedSize = headerSize + payloadSize;
+    m_list = list;
+}
+
+RLPItem::RLPItem(const QByteArray &data):
+    RLPItem(data.constData(), data.size())
+{}
+
+bool RLPItem::isValid() const
+{
+    return m_data != 0;
+}
+
+bool RLPItem::isList() const
+{
+    return m_list;
+}
+
+const char *RLPItem::payload() const
+{
+    return m_payload;
+}
+
+int RLPItem::payloadSize() const
+{
+    return m_payloadSize;
+}
+
+int RLPItem::encodedSize() const
+{
+    return m_encodedSize;
+}
+
+QByteArray RLPItem::toByteArray() const
+{
+    return QByteArray(m_payload, m_payloadSize);
+}
+
+bool RLPItem::toUInt(uint64_t &value) const
+{
+    if(!isValid() || m_list || m_payloadSize > 8 || (m_payloadSize && !m_payload[0]))
+        return false;
+    value = 0;
+    for(int i = 0; i < m_payloadSize; i++)
+        value = (value << 8) | (unsigned char)m_payload[i];
+    return true;
+}
+
+bool RLPItem::toUInt256(UInt256 &value) const
+{
+    if(!isValid() || m_list || m_payloadSize > 32 || (m_payloadSize && !m_payload[0]))
+        return false;
+    unsigned char bytes[32] = {0};
+    memcpy(bytes + 32 - m_payloadSize, m_payload, m_payloadSize);
+    value.fromBigEndian(bytes);
+    return true;
+}
+
+bool RLPItem::items(QVector<RLPItem> &items) const
+{
+    items.clear();
+    if(!isValid() || !m_list)
+        return false;
+    const char* position = m_payload;
+    const char* end = m_payload + m_payloadSize;
+    while(position < end)
+    {
+        RLPItem item(position, int(end - position));
+        if(!item.isValid())
+            return false;
+        items.append(item);
+        position += item.encodedSize();
+    }
+    return true;
+}
@@ -0,0 +1,69 @@
+#ifndef RLP_H
+#define RLP_H
+#include <QByteArray>
+#include <QVector>
+#include "ethrpc_global.h"
+#include "uint256.h"
+
+//Recursive Length Prefix encoder, the items are appended to one buffer
+class ETHRPCSHARED_EXPORT RLPEncoder
+{
+public:
+    RLPEncoder();
+
+    void reserve(int size);
+    //Clear the data, the capacity of the buffer is kept
+    void clear();
+
+    void addBytes(const char* data, int size);
+    void addBytes(const QByteArray& data);
+    //Integers are encoded big endian without leading zeros, zero is the empty string
+    void addUInt(uint64_t value);
+    void addUInt(const UInt256& value);
+
+    //The items added until endList are the content of the list
+    void beginList();
+    void endList();
+
+    const QByteArray& data() const;
+
+private:
+    void addLength(int length, unsigned char offset);
+
+    QByteArray m_data;
+    QVector<int> m_lists;
+};
+
+//Item of RLP encoded data, the item point into the data without copy
+class ETHRPCSHARED_EXPORT RLPItem
+{
+public:
+    RLPItem();
+    //Parse the first item of the data, the data must stay alive while the item is used
+    RLPItem(const char* data, int size);
+    explicit RLPItem(const QByteArray& data);
+
+    bool isValid() const;
+    bool isList() const;
+    //Content of the item, the encoded items for a list
+    const char* payload() const;
+    int payloadSize() const;
+    //Size of the item with its prefix
+    int encodedSize() const;
+
+    QByteArray toByteArray() const;
+    bool toUInt(uint64_t& value) const;
+    bool toUInt256(UInt256& value) const;
+
+    //Items of a list, false when the item is not a valid list
+    bool items(QVector<RLPItem>& items) const;
+
+private:
+    const char* m_data;
+    const char* m_payload;
+    int m_payloadSize;
+    int m_encodedSize;
+    bool m_list;
+};
+
+#endif // RLP_H
@@ -0,0 +1,114 @@
+#include "mockhttpserver.h"
+#include <QMutexLocker>
+#include <QTimer>
+
+MockHttpServer::MockHttpServer():
+    m_mode(ContentLength),
+    m_drop(0)
+{}
+
+void MockHttpServer::setBodyMode(BodyMode mode)
+{
+    QMutexLocker locker(&m_mutex);
+    m_mode = mode;
+}
+
+void MockHttpServer::dropRequests(int count)
+{
+    QMutexLocker locker(&m_mutex);
+    m_drop = count;
+}
+
+QByteArray MockHttpServer::lastHost() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_host;
+}
+
+void MockHttpServer::handleData(QTcpSocket *socket, QByteArray &buffer)
+{
+    forever
+    {
+        int end = buffer.indexOf("\r\n\r\n");
+        if(end < 0)
+            return;
+        QByteArray host;
+        int length = 0;
+        QList<QByteArray> lines = buffer.left(end).split('\n');
+        for(int i = 1; i < lines.size(); i++)
+        {
+            int colon = lines[i].indexOf(':');
+            if(colon < 0) continue;
+            QByteArray name = lines[i].left(colon).trimmed().toLower();
+            QByteArray value = lines[i].mid(colon + 1).trimmed();
+            if(name == "content-length")
+                length = value.toInt();
+            else if(name == "host")
+                host = value;
+        }
+        if(buffer.size() < end + 4 + length)
+            return;
+        QByteArray body = buffer.mid(end + 4, length);
+        buffer.remove(0, end + 4 + length);
+
+        BodyMode mode = ContentLength;
+        bool drop = false;
+        {
+            QMutexLocker locker(&m_mutex);
+            m_host = host;
+            mode = m_mode;
+            drop = m_drop > 0;
+            if(drop)
+                m_drop--;
+        }
+        if(drop)
+        {
+            socket->abort();
+            return;
+        }
+        sendResponse(socket, answer(body), mode);
+        if(mode == UntilClose)
+            return;
+    }
+}
+
+void MockHttpServer::sendResponse(QTcpSocket *socket, const QByteArray &body, BodyMode mode)
+{
+    QList<QByteArray> parts;
+    if(mode == Chunked)
+    {
+        parts << "HTTP/1.1 200 OK\r\nContent-Type: application/json\r\nTransfer-Encoding: chunked\r\n\r\n";
+        int step = qMax(1, body.size() / 3);
+        for(int i = 0; i < body.size(); i += step)
+        {
+            QByteArray chunk = body.mid(i, step);
+            //The first chunk has an extension, the client must ignore it
+            parts << QByteArray::number(chunk.size(), 16) + (i == 0 ? ";mock=1" : "") + "\r\n" + chunk + "\r\n";
+        }
+        parts << "0\r\n\r\n";
+    }
+    else if(mode == UntilClose)
+    {
+        parts << "HTTP/1.1 200 OK\r\nContent-Type: application/json\r\nConnection: close\r\n\r\n" + body;
+    }
+    else
+    {
+        parts << "HTTP/1.1 200 OK\r\nContent-Type: application/json\r\nContent-Length: " +
+                 QByteArray::number(body.size()) + "\r\n\r\n" + body;
+    }
+
+    auto write = [socket, parts, mode]() {
+        for(int i = 0; i < parts.size(); i++)
+        {
+            socket->write(parts[i]);
+            socket->flush();
+        }
+        if(mode == UntilClose)
+            socket->disconnectFromHost();
+    };
+    int msecs = delay();
+    if(msecs > 0)
+        QTimer::singleShot(msecs, socket, write);
+    else
+        write();
+}
@@ -0,0 +1,39 @@
+#ifndef MOCKHTTPSERVER_H
+#define MOCKHTTPSERVER_H
+
+#include "mockserver.h"
+
+//HTTP/1.1 node stand-in, the connections are kept alive unless the body end with the connection
+class MockHttpServer : public MockServer
+{
+    Q_OBJECT
+public:
+    enum BodyMode
+    {
+        ContentLength,
+        //The body is sent in several chunks written apart
+        Chunked,
+        //The body end when the server close the connection
+        UntilClose
+    };
+
+    MockHttpServer();
+
+    void setBodyMode(BodyMode mode);
+    //The next requests are dropped by closing their connection without response, like a stale keep-alive connection
+    void dropRequests(int count);
+    //Host header of the last request
+    QByteArray lastHost() const;
+
+protected:
+    void handleData(QTcpSocket* socket, QByteArray& buffer) override;
+
+private:
+    void sendResponse(QTcpSocket* socket, const QByteArray& body, BodyMode mode);
+
+    BodyMode m_mode;
+    int m_drop;
+    QByteArray m_host;
+};
+
+#endif // MOCKHTTPSERVER_H
@@ -0,0 +1,216 @@
+#include "mockserver.h"
+#include <QJsonDocument>
+#include <QMetaObject>
+#include <QMutexLocker>
+
+static QString toQuantity(qint64 value)
+{
+    return "0x" + QString::number(value, 16);
+}
+
+MockServer::MockServer():
+    m_owner(QThread::currentThread()),
+    m_port(0),
+    m_connections(0),
+    m_requests(0),
+    m_head(0),
+    m_syncing(false),
+    m_delay(0)
+{}
+
+MockServer::~MockServer()
+{
+    stop();
+}
+
+bool MockServer::start(const QHostAddress &address)
+{
+    m_address = address;
+    moveToThread(&m_thread);
+    m_thread.start();
+    bool ok = false;
+    QMetaObject::invokeMethod(this, "listenOnAddress", Qt::BlockingQueuedConnection, Q_RETURN_ARG(bool, ok));
+    if(!ok)
+        stop();
+    return ok;
+}
+
+void MockServer::stop()
+{
+    if(!m_thread.isRunning())
+        return;
+    QMetaObject::invokeMethod(this, "shutdown", Qt::BlockingQueuedConnection);
+    m_thread.quit();
+    m_thread.wait();
+}
+
+quint16 MockServer::port() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_port;
+}
+
+int MockServer::connectionCount() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_connections;
+}
+
+int MockServer::requestCount() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_requests;
+}
+
+int MockServer::methodCount(const QString &method) const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_methods.value(method);
+}
+
+void MockServer::setHead(qint64 head)
+{
+    QMutexLocker locker(&m_mutex);
+    m_head = head;
+}
+
+void MockServer::setSyncing(bool syncing)
+{
+    QMutexLocker locker(&m_mutex);
+    m_syncing = syncing;
+}
+
+void MockServer::setDelay(int msecs)
+{
+    QMutexLocker locker(&m_mutex);
+    m_delay = msecs;
+}
+
+int MockServer::delay() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_delay;
+}
+
+QByteArray MockServer::request(const QString &method, qint64 id)
+{
+    QJsonObject call;
+    call["jsonrpc"] = QString("2.0");
+    call["method"] = method;
+    call["params"] = QJsonArray();
+    call["id"] = double(id);
+    return QJsonDocument(call).toJson(QJsonDocument::Compact);
+}
+
+QByteArray MockServer::response(qint64 id)
+{
+    return QJsonDocument(responseObject(double(id), toQuantity(id))).toJson(QJsonDocument::Compact);
+}
+
+void MockServer::incomingConnection(qintptr handle)
+{
+    QTcpSocket* socket = new QTcpSocket(this);
+    if(!socket->setSocketDescriptor(handle))
+    {
+        delete socket;
+        return;
+    }
+    socket->setSocketOption(QAbstractSocket::LowDelayOption, 1);
+    {
+        QMutexLocker locker(&m_mutex);
+        m_connections++;
+    }
+
+    connect(socket, &QTcpSocket::readyRead, this, [this, socket]() {
+        QByteArray& buffer = m_buffers[socket];
+        buffer += socket->readAll();
+        handleData(socket, buffer);
+    });
+    //The handler may close the socket while it parses the buffer, the buffer live until the socket is destroyed
+    connect(socket, &QTcpSocket::disconnected, socket, &QObject::deleteLater);
+    connect(socket, &QObject::destroyed, this, [this, socket]() { m_buffers.remove(socket); });
+}
+
+QByteArray MockServer::answer(const QByteArray &request)
+{
+    QJsonDocument document = QJsonDocument::fromJson(request);
+    if(document.isArray())
+    {
+        QJsonArray calls = document.array();
+        QJsonArray responses;
+        for(int i = 0; i < calls.size(); i++)
+        {
+            responses.append(answerCall(calls[i].toObject()));
+        }
+        return QJsonDocument(responses).toJson(QJsonDocument::Compact);
+    }
+    return QJsonDocument(answerCall(document.object())).toJson(QJsonDocument::Compact);
+}
+
+bool MockServer::listenOnAddress()
+{
+    bool ok = listen(m_address);
+    QMutexLocker locker(&m_mutex);
+    m_port = serverPort();
+    return ok;
+}
+
+void MockServer::shutdown()
+{
+    close();
+    QList<QTcpSocket*> sockets = findChildren<QTcpSocket*>();
+    for(int i = 0; i < sockets.size(); i++)
+    {
+        sockets[i]->disconnect(this);
+        sockets[i]->abort();
+        delete sockets[i];
+    }
+    m_buffers.clear();
+    //The server is destroyed in the thread of the test
+    moveToThread(m_owner);
+}
+
+QJsonObject MockServer::answerCall(const QJsonObject &call)
+{
+    QString method = call.value("method").toString();
+    QJsonArray params = call.value("params").toArray();
+    QJsonValue id = call.value("id");
+
+    QMutexLocker locker(&m_mutex);
+    m_requests++;
+    m_methods[method]++;
+    if(method == "eth_blockNumber")
+        return responseObject(id, toQuantity(m_head));
+    if(method == "eth_syncing")
+    {
+        if(!m_syncing)
+            return responseObject(id, false);
+        QJsonObject syncing;
+        syncing["startingBlock"] = toQuantity(0);
+        syncing["currentBlock"] = toQuantity(m_head);
+        syncing["highestBlock"] = toQuantity(m_head + 1000);
+        return responseObject(id, syncing);
+    }
+    if(method == "eth_getBlockByNumber")
+    {
+        //Block with the hash and the parent hash derived from its number
+        qint64 number = params.at(0).toString().mid(2).toLongLong(0, 16);
+        QJsonObject block;
+        block["number"] = toQuantity(number);
+        block["hash"] = QString("0x%1").arg(number, 64, 16, QChar('0'));
+        block["parentHash"] = QString("0x%1").arg(qMax<qint64>(number - 1, 0), 64, 16, QChar('0'));
+        block["timestamp"] = toQuantity(1500000000 + number);
+        block["transactions"] = QJsonArray();
+        return responseObject(id, block);
+    }
+    return responseObject(id, toQuantity(qint64(id.toDouble())));
+}
+
+QJsonObject MockServer::responseObject(const QJsonValue &id, const QJsonValue &result)
+{
+    QJsonObject response;
+    response["jsonrpc"] = QString("2.0");
+    response["id"] = id;
+    response["result"] = result;
+    return response;
+}
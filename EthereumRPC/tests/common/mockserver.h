@@ -0,0 +1,77 @@
+#ifndef MOCKSERVER_H
+#define MOCKSERVER_H
+
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QHostAddress>
+#include <QThread>
+#include <QMutex>
+#include <QHash>
+#include <QJsonObject>
+#include <QJsonArray>
+
+//Stand-in of an Ethereum node that serve its connections in its own thread,
+//so the clients of the tests can block on their sockets in the thread of the test
+class MockServer : public QTcpServer
+{
+    Q_OBJECT
+public:
+    MockServer();
+    ~MockServer();
+
+    bool start(const QHostAddress& address = QHostAddress(QHostAddress::LocalHost));
+    void stop();
+    quint16 port() const;
+
+    //Connections accepted since the start
+    int connectionCount() const;
+    //Calls answered, every call of a batch is counted
+    int requestCount() const;
+    int methodCount(const QString& method) const;
+
+    //Block number returned by eth_blockNumber
+    void setHead(qint64 head);
+    //eth_syncing return a sync state instead of false
+    void setSyncing(bool syncing);
+    //Delay of the responses in milliseconds
+    void setDelay(int msecs);
+    int delay() const;
+
+    //Request of the method without params
+    static QByteArray request(const QString& method, qint64 id);
+    //Response of the server to a call without specific result, the result is the id in hex
+    static QByteArray response(qint64 id);
+
+protected:
+    //Called in the thread of the server with the data of the connection, the handled data is removed from the buffer
+    virtual void handleData(QTcpSocket* socket, QByteArray& buffer) = 0;
+    void incomingConnection(qintptr handle) override;
+
+    //Response to a call or a batch of calls
+    QByteArray answer(const QByteArray& request);
+
+    mutable QMutex m_mutex;
+
+private slots:
+    bool listenOnAddress();
+    void shutdown();
+
+private:
+    QJsonObject answerCall(const QJsonObject& call);
+    static QJsonObject responseObject(const QJsonValue& id, const QJsonValue& result);
+
+    QThread m_thread;
+    QThread* m_owner;
+    QHostAddress m_address;
+    quint16 m_port;
+    int m_connections;
+    int m_requests;
+    QHash<QString, int> m_methods;
+    qint64 m_head;
+    bool m_syncing;
+    int m_delay;
+    //Used only in the thread of the server
+    QHash<QTcpSocket*, QByteArray> m_buffers;
+};
+
+#endif // MOCKSERVER_H
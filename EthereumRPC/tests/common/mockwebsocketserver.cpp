@@ -0,0 +1,209 @@
+#include "mockwebsocketserver.h"
+#include <QCryptographicHash>
+#include <QMutexLocker>
+
+MockWebSocketServer::MockWebSocketServer():
+    m_holdCount(0),
+    m_fragmented(false),
+    m_notifying(false),
+    m_close(false),
+    m_pongs(0)
+{}
+
+void MockWebSocketServer::holdResponses(int count)
+{
+    QMutexLocker locker(&m_mutex);
+    m_holdCount = count;
+}
+
+void MockWebSocketServer::setFragmented(bool fragmented)
+{
+    QMutexLocker locker(&m_mutex);
+    m_fragmented = fragmented;
+}
+
+void MockWebSocketServer::setNotifying(bool notifying)
+{
+    QMutexLocker locker(&m_mutex);
+    m_notifying = notifying;
+}
+
+void MockWebSocketServer::closeOnRequest()
+{
+    QMutexLocker locker(&m_mutex);
+    m_close = true;
+}
+
+int MockWebSocketServer::pongCount() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_pongs;
+}
+
+QByteArray MockWebSocketServer::notification()
+{
+    return "{\"jsonrpc\":\"2.0\",\"method\":\"eth_subscription\",\"params\":{\"subscription\":\"0x1\",\"result\":\"0x1\"}}";
+}
+
+void MockWebSocketServer::handleData(QTcpSocket *socket, QByteArray &buffer)
+{
+    if(!socket->property("upgraded").toBool())
+    {
+        int end = buffer.indexOf("\r\n\r\n");
+        if(end < 0)
+            return;
+        QByteArray key;
+        QList<QByteArray> lines = buffer.left(end).split('\n');
+        for(int i = 1; i < lines.size(); i++)
+        {
+            int colon = lines[i].indexOf(':');
+            if(colon > 0 && lines[i].left(colon).trimmed().toLower() == "sec-websocket-key")
+                key = lines[i].mid(colon + 1).trimmed();
+        }
+        buffer.remove(0, end + 4);
+        QByteArray accept = QCryptographicHash::hash(key + "258EAFA5-E914-47DA-95CA-C5AB0DC85B11",
+                                                     QCryptographicHash::Sha1).toBase64();
+        socket->write("HTTP/1.1 101 Switching Protocols\r\nUpgrade: websocket\r\nConnection: Upgrade\r\n"
+                      "Sec-WebSocket-Accept: " + accept + "\r\n\r\n");
+        socket->flush();
+        socket->setProperty("upgraded", true);
+    }
+
+    //The frames of the client are masked and not fragmented
+    forever
+    {
+        if(buffer.size() < 2)
+            return;
+        const uchar* bytes = reinterpret_cast<const uchar*>(buffer.constData());
+        int opcode = bytes[0] & 0x0F;
+        qint64 length = bytes[1] & 0x7F;
+        int headerSize = 2;
+        if(length == 126)
+        {
+            if(buffer.size() < 4) return;
+            length = (qint64(bytes[2]) << 8) | bytes[3];
+            headerSize = 4;
+        }
+        else if(length == 127)
+        {
+            if(buffer.size() < 10) return;
+            length = 0;
+            for(int i = 0; i < 8; i++)
+                length = (length << 8) | bytes[2 + i];
+            headerSize = 10;
+        }
+        if(buffer.size() < headerSize + 4 + length)
+            return;
+        QByteArray payload = buffer.mid(headerSize + 4, int(length));
+        for(int i = 0; i < payload.size(); i++)
+            payload[i] = char(payload[i] ^ bytes[headerSize + i % 4]);
+        buffer.remove(0, headerSize + 4 + int(length));
+
+        switch(opcode)
+        {
+        case Text:
+            if(!handleMessage(socket, payload))
+                return;
+            break;
+        case Ping:
+            writeFrame(socket, Pong, payload);
+            break;
+        case Pong:
+        {
+            QMutexLocker locker(&m_mutex);
+            m_pongs++;
+            break;
+        }
+        case Close:
+            writeFrame(socket, Close, payload.left(2));
+            socket->disconnectFromHost();
+            return;
+        default:
+            break;
+        }
+    }
+}
+
+bool MockWebSocketServer::handleMessage(QTcpSocket *socket, const QByteArray &message)
+{
+    int holdCount = 0;
+    bool notifying = false;
+    bool close = false;
+    {
+        QMutexLocker locker(&m_mutex);
+        holdCount = m_holdCount;
+        notifying = m_notifying;
+        close = m_close;
+        m_close = false;
+    }
+    if(close)
+    {
+        //Close code 1001, going away
+        writeFrame(socket, Close, QByteArray("\x03\xE9", 2));
+        socket->disconnectFromHost();
+        return false;
+    }
+
+    if(notifying)
+        sendMessage(socket, notification());
+    QByteArray response = answer(message);
+    if(holdCount > 1)
+    {
+        m_held.append(response);
+        if(m_held.size() < holdCount)
+            return true;
+        for(int i = m_held.size() - 1; i >= 0; i--)
+            sendMessage(socket, m_held[i]);
+        m_held.clear();
+        return true;
+    }
+    sendMessage(socket, response);
+    return true;
+}
+
+void MockWebSocketServer::sendMessage(QTcpSocket *socket, const QByteArray &message)
+{
+    bool fragmented = false;
+    {
+        QMutexLocker locker(&m_mutex);
+        fragmented = m_fragmented;
+    }
+    if(!fragmented || message.size() < 3)
+    {
+        writeFrame(socket, Text, message);
+        return;
+    }
+
+    //The control frames can be interleaved between the fragments of a message
+    int step = message.size() / 3;
+    writeFrame(socket, Text, message.left(step), false);
+    writeFrame(socket, Ping, "mock");
+    writeFrame(socket, Continuation, message.mid(step, step), false);
+    writeFrame(socket, Pong, QByteArray());
+    writeFrame(socket, Continuation, message.mid(2 * step), true);
+}
+
+void MockWebSocketServer::writeFrame(QTcpSocket *socket, Opcode opcode, const QByteArray &payload, bool fin)
+{
+    QByteArray frame;
+    frame.append(char((fin ? 0x80 : 0) | opcode));
+    if(payload.size() < 126)
+    {
+        frame.append(char(payload.size()));
+    }
+    else if(payload.size() <= 0xFFFF)
+    {
+        frame.append(char(126));
+        frame.append(char(payload.size() >> 8));
+        frame.append(char(payload.size() & 0xFF));
+    }
+    else
+    {
+        frame.append(char(127));
+        for(int i = 7; i >= 0; i--)
+            frame.append(char((quint64(payload.size()) >> (i * 8)) & 0xFF));
+    }
+    frame.append(payload);
+    socket->write(frame);
+    socket->flush();
+}
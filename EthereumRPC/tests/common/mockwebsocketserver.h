@@ -0,0 +1,55 @@
+#ifndef MOCKWEBSOCKETSERVER_H
+#define MOCKWEBSOCKETSERVER_H
+
+#include "mockserver.h"
+#include <QList>
+
+//WebSocket node stand-in, every text message is a JSON RPC request
+class MockWebSocketServer : public MockServer
+{
+    Q_OBJECT
+public:
+    MockWebSocketServer();
+
+    //The responses are held until count requests are received, then sent in the reverse order
+    void holdResponses(int count);
+    //Every message is sent in three fragments with a ping and a pong between them
+    void setFragmented(bool fragmented);
+    //An eth_subscription notification is sent before every response
+    void setNotifying(bool notifying);
+    //The next request is answered by a close frame
+    void closeOnRequest();
+    //Pongs received from the clients
+    int pongCount() const;
+
+    static QByteArray notification();
+
+protected:
+    void handleData(QTcpSocket* socket, QByteArray& buffer) override;
+
+private:
+    enum Opcode
+    {
+        Continuation = 0x0,
+        Text = 0x1,
+        Close = 0x8,
+        Ping = 0x9,
+        Pong = 0xA
+    };
+
+    //Return false when the connection is closed
+    bool handleMessage(QTcpSocket* socket, const QByteArray& message);
+    void sendMessage(QTcpSocket* socket, const QByteArray& message);
+    //The frames of the server are not masked
+    static void writeFrame(QTcpSocket* socket, Opcode opcode, const QByteArray& payload, bool fin = true);
+
+    int m_holdCount;
+    bool m_fragmented;
+    bool m_notifying;
+    bool m_close;
+    int m_pongs;
+    //Used only in the thread of the server
+    QList<QByteArray> m_held;
+};
+
+#endif // MOCKWEBSOCKETSERVER_H
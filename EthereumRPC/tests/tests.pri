@@ -0,0 +1,51 @@
+QT       -= gui
+QT       += network testlib
+
+CONFIG   += c++11 console testcase
+CONFIG   -= app_bundle
+
+#The tests build the sources of the library, they do not depend on an installed library
+DEFINES += ETHRPC_LIBRARY
+ETHRPC_DIR = $$PWD/..
+INCLUDEPATH += $$ETHRPC_DIR $$PWD/common
+
+SOURCES += \
+    $$ETHRPC_DIR/ethobject.cpp \
+    $$ETHRPC_DIR/ethrpc.cpp \
+    $$ETHRPC_DIR/ethlocalclient.cpp \
+    $$ETHRPC_DIR/ethhttpclient.cpp \
+    $$ETHRPC_DIR/jsoncoder.cpp \
+    $$ETHRPC_DIR/hexcodec.cpp \
+    $$ETHRPC_DIR/ethblockfetcher.cpp \
+    $$ETHRPC_DIR/ethrpccache.cpp \
+    $$ETHRPC_DIR/ethheadercache.cpp \
+    $$ETHRPC_DIR/ethblockstore.cpp \
+    $$ETHRPC_DIR/keccak.cpp \
+    $$ETHRPC_DIR/ethbloom.cpp \
+    $$ETHRPC_DIR/rlp.cpp \
+    $$ETHRPC_DIR/ethabi.cpp \
+    $$ETHRPC_DIR/ethwebsocketclient.cpp \
+    $$ETHRPC_DIR/ethfiltermanager.cpp \
+    $$ETHRPC_DIR/ethbalancedclient.cpp \
+    $$PWD/common/mockserver.cpp \
+    $$PWD/common/mockhttpserver.cpp \
+    $$PWD/common/mockwebsocketserver.cpp
+
+#The headers of the QObject classes, for moc
+HEADERS += \
+    $$ETHRPC_DIR/ethlocalclient.h \
+    $$ETHRPC_DIR/ethhttpclient.h \
+    $$ETHRPC_DIR/ethheadercache.h \
+    $$ETHRPC_DIR/ethwebsocketclient.h \
+    $$ETHRPC_DIR/ethfiltermanager.h \
+    $$ETHRPC_DIR/ethbalancedclient.h \
+    $$PWD/common/mockserver.h \
+    $$PWD/common/mockhttpserver.h \
+    $$PWD/common/mockwebsocketserver.h
+
+#The signer of the library, with the same switch: qmake CONFIG+=ethrpc_signer
+ethrpc_signer {
+    DEFINES += ETHRPC_SIGNER
+    SOURCES += $$ETHRPC_DIR/ethsigner.cpp
+    LIBS += -lsecp256k1
+}
@@ -0,0 +1,16 @@
+#Unit tests and benchmarks of the library, the transports run against local stand-ins of the nodes: qmake && make check
+
+TEMPLATE = subdirs
+
+SUBDIRS += \
+    tst_ethhttpclient \
+    tst_ethwebsocketclient \
+    tst_ethbalancedclient \
+    tst_ethblockfetcher \
+    tst_jsoncoder \
+    tst_hexcodec \
+    tst_rlp \
+    tst_ethabi \
+    tst_uint256
+
+ethrpc_signer: SUBDIRS += tst_ethsigner
@@ -0,0 +1,166 @@
+#include <QtTest>
+#include <climits>
+#include "ethabi.h"
+
+namespace TestEthAbi_NS
+{
+    //sam("dave", true, [1, 2, 3]), the dynamic types example of the Solidity ABI specification
+    const char SAM_CALL[] =
+            "a5643bf2"
+            "0000000000000000000000000000000000000000000000000000000000000060"
+            "0000000000000000000000000000000000000000000000000000000000000001"
+            "00000000000000000000000000000000000000000000000000000000000000a0"
+            "0000000000000000000000000000000000000000000000000000000000000004"
+            "6461766500000000000000000000000000000000000000000000000000000000"
+            "0000000000000000000000000000000000000000000000000000000000000003"
+            "0000000000000000000000000000000000000000000000000000000000000001"
+            "0000000000000000000000000000000000000000000000000000000000000002"
+            "0000000000000000000000000000000000000000000000000000000000000003";
+}
+using namespace TestEthAbi_NS;
+
+class TestEthAbi : public QObject
+{
+    Q_OBJECT
+private slots:
+    void transferSelector();
+    void dynamicLayout();
+    void decodeDynamicLayout();
+    void readWord_data();
+    void readWord();
+    void rejectOutOfRange_data();
+    void rejectOutOfRange();
+
+private:
+    static QByteArray word(uint64_t value);
+    //The parameters of the sam example, without the selector
+    static QByteArray samParameters();
+};
+
+void TestEthAbi::transferSelector()
+{
+    const EthAbiFunction<EAddress20, UInt256>& transfer = ETH_ABI_FUNCTION("transfer", EAddress20, UInt256);
+    QCOMPARE(transfer.signature(), QByteArray("transfer(address,uint256)"));
+    QCOMPARE(transfer.selector().toHex(), QByteArray("a9059cbb"));
+
+    //The address is aligned to the right of its word
+    QByteArray to = QByteArray::fromHex("3535353535353535353535353535353535353535");
+    QByteArray data = transfer.encode(EAddress20(to), UInt256(1000));
+    QCOMPARE(data.size(), EthAbiSelectorSize + 2 * EthAbiWordSize);
+    QCOMPARE(data.mid(EthAbiSelectorSize, EthAbiWordSize), QByteArray(12, '\0') + to);
+    QCOMPARE(data.mid(EthAbiSelectorSize + EthAbiWordSize), word(1000));
+}
+
+void TestEthAbi::dynamicLayout()
+{
+    QVector<UInt256> values;
+    values << UInt256(1) << UInt256(2) << UInt256(3);
+    const EthAbiFunction<QByteArray, bool, QVector<UInt256> >& sam =
+            ETH_ABI_FUNCTION("sam", QByteArray, bool, QVector<UInt256>);
+    QCOMPARE(sam.signature(), QByteArray("sam(bytes,bool,uint256[])"));
+    QCOMPARE(sam.encode(QByteArray("dave"), true, values).toHex(), QByteArray(SAM_CALL));
+}
+
+void TestEthAbi::decodeDynamicLayout()
+{
+    QByteArray data = samParameters();
+    QByteArray name;
+    bool flag = false;
+    QVector<UInt256> values;
+    QVERIFY(ethAbiDecode(data, name, flag, values));
+    QCOMPARE(name, QByteArray("dave"));
+    QVERIFY(flag);
+    QCOMPARE(values.count(), 3);
+    for(int i = 0; i < values.count(); i++)
+    {
+        QVERIFY(values[i] == UInt256(i + 1));
+    }
+
+    //The view point into the data
+    EthAbiView view;
+    QVERIFY(ethAbiDecode(data, view, flag, values));
+    QCOMPARE(view.toByteArray(), QByteArray("dave"));
+    QVERIFY(view.data >= data.constData() && view.data + view.size <= data.constData() + data.size());
+}
+
+void TestEthAbi::readWord_data()
+{
+    QTest::addColumn<QByteArray>("data");
+    QTest::addColumn<int>("maximum");
+    QTest::addColumn<bool>("valid");
+    QTest::addColumn<int>("expected");
+
+    QByteArray high = word(1);
+    high[0] = 1;
+    QByteArray int32 = word(0);
+    int32[27] = 1;
+    QTest::newRow("zero") << word(0) << 0 << true << 0;
+    QTest::newRow("at the maximum") << word(64) << 64 << true << 64;
+    QTest::newRow("above the maximum") << word(65) << 64 << false << 0;
+    QTest::newRow("negative maximum") << word(0) << -1 << false << 0;
+    QTest::newRow("above an int") << word(0x80000000ULL) << INT_MAX << false << 0;
+    QTest::newRow("above 32 bits") << int32 << INT_MAX << false << 0;
+    QTest::newRow("high Byte") << high << INT_MAX << false << 0;
+}
+
+void TestEthAbi::readWord()
+{
+    QFETCH(QByteArray, data);
+    QFETCH(int, maximum);
+    QFETCH(bool, valid);
+    QFETCH(int, expected);
+    int value = -1;
+    QCOMPARE(ethAbiReadWord(reinterpret_cast<const uchar*>(data.constData()), maximum, value), valid);
+    if(valid)
+        QCOMPARE(value, expected);
+}
+
+void TestEthAbi::rejectOutOfRange_data()
+{
+    QTest::addColumn<QByteArray>("data");
+
+    QByteArray parameters = samParameters();
+    QByteArray offsetPastEnd = parameters;
+    offsetPastEnd.replace(0, EthAbiWordSize, word(parameters.size()));
+    QByteArray offsetInLastWord = parameters;
+    offsetInLastWord.replace(0, EthAbiWordSize, word(parameters.size() - EthAbiWordSize + 1));
+    QByteArray longBytes = parameters;
+    longBytes.replace(3 * EthAbiWordSize, EthAbiWordSize, word(parameters.size()));
+    QByteArray longArray = parameters;
+    longArray.replace(5 * EthAbiWordSize, EthAbiWordSize, word(4));
+    QByteArray hugeOffset = parameters;
+    hugeOffset.replace(2 * EthAbiWordSize, EthAbiWordSize, QByteArray(EthAbiWordSize, '\xff'));
+
+    QTest::newRow("truncated head") << parameters.left(2 * EthAbiWordSize);
+    QTest::newRow("truncated tail") << parameters.left(parameters.size() - 1);
+    QTest::newRow("offset past the end") << offsetPastEnd;
+    QTest::newRow("offset in the last word") << offsetInLastWord;
+    QTest::newRow("length past the end") << longBytes;
+    QTest::newRow("count past the end") << longArray;
+    QTest::newRow("offset of 256 bits") << hugeOffset;
+}
+
+void TestEthAbi::rejectOutOfRange()
+{
+    QFETCH(QByteArray, data);
+    QByteArray name;
+    bool flag = false;
+    QVector<UInt256> values;
+    QVERIFY(!ethAbiDecode(data, name, flag, values));
+}
+
+QByteArray TestEthAbi::word(uint64_t value)
+{
+    QByteArray data(EthAbiWordSize, '\0');
+    ethAbiWriteWord(value, reinterpret_cast<uchar*>(data.data()));
+    return data;
+}
+
+QByteArray TestEthAbi::samParameters()
+{
+    return QByteArray::fromHex(QByteArray(SAM_CALL).mid(2 * EthAbiSelectorSize));
+}
+
+QTEST_GUILESS_MAIN(TestEthAbi)
+
+#include "tst_ethabi.moc"
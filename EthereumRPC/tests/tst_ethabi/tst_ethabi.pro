@@ -0,0 +1,5 @@
+include(../tests.pri)
+
+TARGET = tst_ethabi
+
+SOURCES += tst_ethabi.cpp
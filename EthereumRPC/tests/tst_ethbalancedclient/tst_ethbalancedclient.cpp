@@ -0,0 +1,298 @@
+#include <QtTest>
+#include "ethbalancedclient.h"
+#include "ethhttpclient.h"
+#include "mockhttpserver.h"
+
+namespace TestEthBalancedClient_NS
+{
+    const int TIMEOUT_MSECS = 2000;
+    const int WAIT_MSECS = 3 * TIMEOUT_MSECS;
+    const int BACKEND_COUNT = 2;
+    const int HEAD = 100;
+    const int PROBE_MSECS = 100;
+    //Only the probes sent by connectToServer
+    const int NO_PROBE_MSECS = 600000;
+    //Hedged requests answered before the hedge delay is known
+    const int HEDGE_SAMPLES = 32;
+    const int SLOW_MSECS = 50;
+}
+using namespace TestEthBalancedClient_NS;
+
+class TestEthBalancedClient : public QObject
+{
+    Q_OBJECT
+private slots:
+    void init();
+    void cleanup();
+
+    void lowestLatency();
+    void leastInFlight();
+    void ejectLaggingBackend();
+    void ejectSyncingBackend();
+    void pinStatefulMethods();
+    void hedgeSlowBackend();
+
+private:
+    //Balanced client with one HTTP backend per server
+    EthBalancedClient* newClient(int probeMsecs);
+    //Wait until every backend has answered a probe
+    bool waitForProbes(EthBalancedClient* client);
+    //Post the reads and wait for their responses from the event loop
+    bool postReads(EthBalancedClient* client, int firstId, int count);
+    //Count the signals of the backend
+    static int signalCount(const QSignalSpy& spy, int index);
+
+    QList<MockHttpServer*> m_servers;
+};
+
+void TestEthBalancedClient::init()
+{
+    for(int i = 0; i < BACKEND_COUNT; i++)
+    {
+        MockHttpServer* server = new MockHttpServer();
+        server->setHead(HEAD);
+        m_servers.append(server);
+        QVERIFY(server->start());
+    }
+}
+
+void TestEthBalancedClient::cleanup()
+{
+    qDeleteAll(m_servers);
+    m_servers.clear();
+}
+
+void TestEthBalancedClient::lowestLatency()
+{
+    m_servers[0]->setDelay(50);
+    QScopedPointer<EthBalancedClient> client(newClient(NO_PROBE_MSECS));
+    QVERIFY(client->connectToServer());
+    //The first probes measure the latency of the backends
+    QVERIFY(waitForProbes(client.data()));
+    QVERIFY(client->latency(0) > client->latency(1));
+
+    for(int id = 1; id <= 20; id++)
+    {
+        QByteArray response;
+        QVERIFY(client->requestingResponse(MockServer::request("eth_gasPrice", id), response));
+        QCOMPARE(response, MockServer::response(id));
+    }
+    QCOMPARE(m_servers[0]->methodCount("eth_gasPrice"), 0);
+    QCOMPARE(m_servers[1]->methodCount("eth_gasPrice"), 20);
+}
+
+void TestEthBalancedClient::leastInFlight()
+{
+    int answered = 0;
+    m_servers[0]->setDelay(100);
+    m_servers[1]->setDelay(100);
+    QScopedPointer<EthBalancedClient> client(newClient(NO_PROBE_MSECS));
+    QVERIFY(client->connectToServer());
+    QVERIFY(waitForProbes(client.data()));
+
+    for(int id = 1; id <= 4; id++)
+    {
+        client->postRequest(MockServer::request("eth_gasPrice", id), [&answered](bool success, const QByteArray&) {
+            if(success)
+                answered++;
+        });
+    }
+    //The backends of equal latency share the requests in flight
+    QCOMPARE(client->inFlight(0), 2);
+    QCOMPARE(client->inFlight(1), 2);
+    QTRY_COMPARE_WITH_TIMEOUT(answered, 4, WAIT_MSECS);
+    QCOMPARE(client->inFlight(0), 0);
+    QCOMPARE(client->inFlight(1), 0);
+    QCOMPARE(m_servers[0]->methodCount("eth_gasPrice"), 2);
+    QCOMPARE(m_servers[1]->methodCount("eth_gasPrice"), 2);
+}
+
+void TestEthBalancedClient::ejectLaggingBackend()
+{
+    QScopedPointer<EthBalancedClient> client(newClient(PROBE_MSECS));
+    QSignalSpy ejected(client.data(), SIGNAL(backendEjected(int)));
+    QSignalSpy restored(client.data(), SIGNAL(backendRestored(int)));
+    QVERIFY(client->connectToServer());
+    QVERIFY(waitForProbes(client.data()));
+    QVERIFY(client->isHealthy(0));
+    QVERIFY(client->isHealthy(1));
+
+    //The head is behind the head of the pool by more than "maxLag" blocks
+    m_servers[1]->setHead(HEAD - 10);
+    QTRY_VERIFY_WITH_TIMEOUT(!client->isHealthy(1), WAIT_MSECS);
+    QCOMPARE(signalCount(ejected, 1), 1);
+    QCOMPARE(qint64(client->headBlock(1)), qint64(HEAD - 10));
+    QVERIFY(postReads(client.data(), 1, 5));
+    QCOMPARE(m_servers[0]->methodCount("eth_gasPrice"), 5);
+    QCOMPARE(m_servers[1]->methodCount("eth_gasPrice"), 0);
+
+    //Restored by the first probe that find it in sync
+    m_servers[1]->setHead(HEAD);
+    QTRY_VERIFY_WITH_TIMEOUT(client->isHealthy(1), WAIT_MSECS);
+    QCOMPARE(signalCount(restored, 1), 1);
+}
+
+void TestEthBalancedClient::ejectSyncingBackend()
+{
+    QScopedPointer<EthBalancedClient> client(newClient(PROBE_MSECS));
+    QSignalSpy ejected(client.data(), SIGNAL(backendEjected(int)));
+    QSignalSpy restored(client.data(), SIGNAL(backendRestored(int)));
+    QVERIFY(client->connectToServer());
+    QVERIFY(waitForProbes(client.data()));
+    QVERIFY(client->isHealthy(0));
+    QVERIFY(client->isHealthy(1));
+
+    //A syncing node is ejected whatever its head
+    m_servers[0]->setSyncing(true);
+    QTRY_VERIFY_WITH_TIMEOUT(!client->isHealthy(0), WAIT_MSECS);
+    QCOMPARE(signalCount(ejected, 0), 1);
+    QVERIFY(postReads(client.data(), 1, 5));
+    QCOMPARE(m_servers[0]->methodCount("eth_gasPrice"), 0);
+    QCOMPARE(m_servers[1]->methodCount("eth_gasPrice"), 5);
+
+    m_servers[0]->setSyncing(false);
+    QTRY_VERIFY_WITH_TIMEOUT(client->isHealthy(0), WAIT_MSECS);
+    QCOMPARE(signalCount(restored, 0), 1);
+}
+
+void TestEthBalancedClient::pinStatefulMethods()
+{
+    QScopedPointer<EthBalancedClient> client(newClient(NO_PROBE_MSECS));
+    QVERIFY(client->connectToServer());
+    QVERIFY(waitForProbes(client.data()));
+
+    QByteArray response;
+    QVERIFY(client->requestingResponse(MockServer::request("eth_newFilter", 1), response));
+    int pinned = m_servers[0]->methodCount("eth_newFilter") == 1 ? 0 : 1;
+    QCOMPARE(m_servers[pinned]->methodCount("eth_newFilter"), 1);
+
+    //The filter exist only in its node, its calls stay there even when the node become the slowest
+    m_servers[pinned]->setDelay(30);
+    for(int id = 2; id <= 11; id++)
+    {
+        QVERIFY(client->requestingResponse(MockServer::request("eth_getFilterChanges", id), response));
+        QCOMPARE(response, MockServer::response(id));
+    }
+    QCOMPARE(m_servers[pinned]->methodCount("eth_getFilterChanges"), 10);
+    QCOMPARE(m_servers[1 - pinned]->methodCount("eth_getFilterChanges"), 0);
+
+    //The reads are not pinned
+    for(int id = 12; id <= 16; id++)
+    {
+        QVERIFY(client->requestingResponse(MockServer::request("eth_gasPrice", id), response));
+    }
+    QCOMPARE(m_servers[1 - pinned]->methodCount("eth_gasPrice"), 5);
+}
+
+void TestEthBalancedClient::hedgeSlowBackend()
+{
+    //The first probes make the backend 1 slower, the hedged requests go first to the backend 0
+    m_servers[1]->setDelay(20);
+    QScopedPointer<EthBalancedClient> client(newClient(NO_PROBE_MSECS));
+    QVERIFY(client->connectToServer());
+    QVERIFY(waitForProbes(client.data()));
+    m_servers[1]->setDelay(0);
+
+    QByteArray response;
+    int id = 1;
+    for(; id <= HEDGE_SAMPLES; id++)
+    {
+        QCOMPARE(client->hedgeDelay(), -1);
+        QVERIFY(client->requestingHedgedResponse(MockServer::request("eth_gasPrice", id), response));
+        QCOMPARE(response, MockServer::response(id));
+    }
+    int delay = client->hedgeDelay();
+    QVERIFY(delay >= 0 && delay < SLOW_MSECS);
+    QCOMPARE(client->hedgeCount(), qint64(0));
+    QCOMPARE(m_servers[1]->methodCount("eth_gasPrice"), 0);
+
+    //The hedge is sent to the backend 1 after the hedge delay and answer before the backend 0
+    m_servers[0]->setDelay(SLOW_MSECS);
+    QElapsedTimer timer;
+    timer.start();
+    QVERIFY(client->requestingHedgedResponse(MockServer::request("eth_gasPrice", id), response));
+    qint64 elapsed = timer.elapsed();
+    QCOMPARE(response, MockServer::response(id));
+    QVERIFY(elapsed >= delay);
+    QVERIFY(elapsed < SLOW_MSECS);
+    QCOMPARE(client->hedgeCount(), qint64(1));
+    QCOMPARE(m_servers[1]->methodCount("eth_gasPrice"), 1);
+    id++;
+
+    //Every request is slow enough to be hedged, the hedges are limited by the budget
+    m_servers[1]->setDelay(SLOW_MSECS);
+    for(int last = id + 40; id < last; id++)
+    {
+        QVERIFY(client->requestingHedgedResponse(MockServer::request("eth_gasPrice", id), response));
+        QCOMPARE(response, MockServer::response(id));
+    }
+    double budget = client->clientParameters()["hedgeBudget"].toDouble();
+    QVERIFY(client->hedgeCount() > 1);
+    QVERIFY(client->hedgeCount() <= qint64(budget * (id - 1)));
+}
+
+EthBalancedClient *TestEthBalancedClient::newClient(int probeMsecs)
+{
+    QList<IEthClient*> backends;
+    for(int i = 0; i < m_servers.size(); i++)
+    {
+        EthHttpClient* backend = new EthHttpClient(QString("http://127.0.0.1:%1").arg(m_servers[i]->port()));
+        backend->clientParameters()["timeout"] = TIMEOUT_MSECS;
+        backends.append(backend);
+    }
+    EthBalancedClient* client = new EthBalancedClient(backends);
+    client->clientParameters()["probeInterval"] = probeMsecs;
+    return client;
+}
+
+bool TestEthBalancedClient::waitForProbes(EthBalancedClient *client)
+{
+    QElapsedTimer timer;
+    timer.start();
+    forever
+    {
+        bool probed = true;
+        for(int i = 0; i < client->backendCount(); i++)
+        {
+            if(client->headBlock(i) < 0)
+                probed = false;
+        }
+        if(probed)
+            return true;
+        if(timer.elapsed() > WAIT_MSECS)
+            return false;
+        QTest::qWait(1);
+    }
+}
+
+bool TestEthBalancedClient::postReads(EthBalancedClient *client, int firstId, int count)
+{
+    int answered = 0;
+    for(int id = firstId; id < firstId + count; id++)
+    {
+        client->postRequest(MockServer::request("eth_gasPrice", id), [&answered](bool success, const QByteArray&) {
+            if(success)
+                answered++;
+        });
+    }
+    QElapsedTimer timer;
+    timer.start();
+    while(answered < count && timer.elapsed() < WAIT_MSECS)
+        QTest::qWait(1);
+    return answered == count;
+}
+
+int TestEthBalancedClient::signalCount(const QSignalSpy &spy, int index)
+{
+    int count = 0;
+    for(int i = 0; i < spy.count(); i++)
+    {
+        if(spy.at(i).at(0).toInt() == index)
+            count++;
+    }
+    return count;
+}
+
+QTEST_GUILESS_MAIN(TestEthBalancedClient)
+
+#include "tst_ethbalancedclient.moc"
@@ -0,0 +1,5 @@
+include(../tests.pri)
+
+TARGET = tst_ethbalancedclient
+
+SOURCES += tst_ethbalancedclient.cpp
@@ -0,0 +1,94 @@
+#include <QtTest>
+#include "ethblockfetcher.h"
+#include "mockhttpserver.h"
+
+namespace TestEthBlockFetcher_NS
+{
+    const int BLOCK_COUNT = 512;
+    //Round trip of the node, the workers overlap their round trips
+    const int NODE_DELAY_MSECS = 2;
+}
+using namespace TestEthBlockFetcher_NS;
+
+class TestEthBlockFetcher : public QObject
+{
+    Q_OBJECT
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+
+    void fetchInOrder();
+    void fetchThroughput_data();
+    void fetchThroughput();
+
+private:
+    QString serverUri() const;
+
+    MockHttpServer* m_server;
+};
+
+void TestEthBlockFetcher::initTestCase()
+{
+    m_server = new MockHttpServer();
+    m_server->setDelay(NODE_DELAY_MSECS);
+    QVERIFY(m_server->start());
+}
+
+void TestEthBlockFetcher::cleanupTestCase()
+{
+    delete m_server;
+    m_server = 0;
+}
+
+void TestEthBlockFetcher::fetchInOrder()
+{
+    EthBlockFetcher fetcher;
+    fetcher.setServerUris(QStringList() << serverUri());
+    //Batches that do not divide the range and a small reorder window
+    fetcher.setBatchSize(7);
+    fetcher.setWindowSize(32);
+    int64_t next = 10;
+    QVERIFY(fetcher.fetch(10, 209, [&next](const EBlock& block) {
+        if(int64_t(block.number) != next)
+            return false;
+        next++;
+        return true;
+    }));
+    QCOMPARE(qint64(next), qint64(210));
+}
+
+void TestEthBlockFetcher::fetchThroughput_data()
+{
+    QTest::addColumn<int>("workers");
+    QTest::newRow("1 worker") << 1;
+    QTest::newRow("2 workers") << 2;
+    QTest::newRow("4 workers") << 4;
+    QTest::newRow("8 workers") << 8;
+}
+
+void TestEthBlockFetcher::fetchThroughput()
+{
+    QFETCH(int, workers);
+    EthBlockFetcher fetcher;
+    fetcher.setServerUris(QStringList() << serverUri());
+    fetcher.setWorkerCount(workers);
+    qint64 count = 0;
+    QBENCHMARK
+    {
+        count = 0;
+        QVERIFY(fetcher.fetch(0, BLOCK_COUNT - 1, [&count](const EBlock&) {
+            count++;
+            return true;
+        }));
+    }
+    QCOMPARE(count, qint64(BLOCK_COUNT));
+}
+
+QString TestEthBlockFetcher::serverUri() const
+{
+    return QString("http://127.0.0.1:%1").arg(m_server->port());
+}
+
+QTEST_GUILESS_MAIN(TestEthBlockFetcher)
+
+#include "tst_ethblockfetcher.moc"
@@ -0,0 +1,5 @@
+include(../tests.pri)
+
+TARGET = tst_ethblockfetcher
+
+SOURCES += tst_ethblockfetcher.cpp
@@ -0,0 +1,164 @@
+#include <QtTest>
+#include "ethhttpclient.h"
+#include "mockhttpserver.h"
+
+namespace TestEthHttpClient_NS
+{
+    const int TIMEOUT_MSECS = 2000;
+    //The posted requests are always answered or failed within the timeout of the client
+    const int WAIT_MSECS = 3 * TIMEOUT_MSECS;
+}
+using namespace TestEthHttpClient_NS;
+
+class TestEthHttpClient : public QObject
+{
+    Q_OBJECT
+private slots:
+    void init();
+    void cleanup();
+
+    void keepAliveReuse_data();
+    void keepAliveReuse();
+    void bodies_data();
+    void bodies();
+    void staleConnectionRetry_data();
+    void staleConnectionRetry();
+    void ipv6HostHeader();
+
+private:
+    EthHttpClient* newClient(quint16 port, const QString& host = "127.0.0.1");
+    //Send the request blocking, or post it and wait for its handler from the event loop
+    bool exchange(EthHttpClient* client, const QByteArray& request, QByteArray& response, bool async);
+
+    MockHttpServer* m_server;
+};
+
+void TestEthHttpClient::init()
+{
+    m_server = new MockHttpServer();
+    QVERIFY(m_server->start());
+}
+
+void TestEthHttpClient::cleanup()
+{
+    delete m_server;
+    m_server = 0;
+}
+
+void TestEthHttpClient::keepAliveReuse_data()
+{
+    QTest::addColumn<bool>("async");
+    QTest::newRow("blocking") << false;
+    QTest::newRow("posted") << true;
+}
+
+void TestEthHttpClient::keepAliveReuse()
+{
+    QFETCH(bool, async);
+    QScopedPointer<EthHttpClient> client(newClient(m_server->port()));
+    QVERIFY(client->connectToServer());
+    for(int id = 1; id <= 3; id++)
+    {
+        QByteArray response;
+        QVERIFY(exchange(client.data(), MockServer::request("eth_gasPrice", id), response, async));
+        QCOMPARE(response, MockServer::response(id));
+    }
+    //The connection opened by connectToServer serve every request
+    QCOMPARE(m_server->connectionCount(), 1);
+}
+
+void TestEthHttpClient::bodies_data()
+{
+    QTest::addColumn<int>("mode");
+    QTest::addColumn<bool>("async");
+    QTest::newRow("content-length blocking") << int(MockHttpServer::ContentLength) << false;
+    QTest::newRow("content-length posted") << int(MockHttpServer::ContentLength) << true;
+    QTest::newRow("chunked blocking") << int(MockHttpServer::Chunked) << false;
+    QTest::newRow("chunked posted") << int(MockHttpServer::Chunked) << true;
+    QTest::newRow("until-close blocking") << int(MockHttpServer::UntilClose) << false;
+    QTest::newRow("until-close posted") << int(MockHttpServer::UntilClose) << true;
+}
+
+void TestEthHttpClient::bodies()
+{
+    QFETCH(int, mode);
+    QFETCH(bool, async);
+    m_server->setBodyMode(MockHttpServer::BodyMode(mode));
+    QScopedPointer<EthHttpClient> client(newClient(m_server->port()));
+    QVERIFY(client->connectToServer());
+    for(int id = 1; id <= 3; id++)
+    {
+        QByteArray response;
+        QVERIFY(exchange(client.data(), MockServer::request("eth_gasPrice", id), response, async));
+        QCOMPARE(response, MockServer::response(id));
+    }
+    //A body that end with the connection need a new connection for the next request
+    QCOMPARE(m_server->connectionCount(), mode == MockHttpServer::UntilClose ? 3 : 1);
+}
+
+void TestEthHttpClient::staleConnectionRetry_data()
+{
+    keepAliveReuse_data();
+}
+
+void TestEthHttpClient::staleConnectionRetry()
+{
+    QFETCH(bool, async);
+    QScopedPointer<EthHttpClient> client(newClient(m_server->port()));
+    QVERIFY(client->connectToServer());
+    QByteArray response;
+    QVERIFY(exchange(client.data(), MockServer::request("eth_gasPrice", 1), response, async));
+
+    //The kept alive connection is closed when the next request arrive, the client retry once on a new connection
+    m_server->dropRequests(1);
+    QVERIFY(exchange(client.data(), MockServer::request("eth_gasPrice", 2), response, async));
+    QCOMPARE(response, MockServer::response(2));
+    QCOMPARE(m_server->connectionCount(), 2);
+    QCOMPARE(m_server->methodCount("eth_gasPrice"), 2);
+
+    //A request that fail on a new connection is not retried
+    m_server->dropRequests(2);
+    QVERIFY(!exchange(client.data(), MockServer::request("eth_gasPrice", 3), response, async));
+}
+
+void TestEthHttpClient::ipv6HostHeader()
+{
+    MockHttpServer server;
+    if(!server.start(QHostAddress(QHostAddress::LocalHostIPv6)))
+        QSKIP("IPv6 is not available");
+    QScopedPointer<EthHttpClient> client(newClient(server.port(), "[::1]"));
+    QVERIFY(client->connectToServer());
+    QByteArray response;
+    QVERIFY(client->requestingResponse(MockServer::request("eth_gasPrice", 1), response));
+    QCOMPARE(server.lastHost(), "[::1]:" + QByteArray::number(server.port()));
+}
+
+EthHttpClient *TestEthHttpClient::newClient(quint16 port, const QString &host)
+{
+    EthHttpClient* client = new EthHttpClient(QString("http://%1:%2").arg(host).arg(port));
+    client->clientParameters()["timeout"] = TIMEOUT_MSECS;
+    return client;
+}
+
+bool TestEthHttpClient::exchange(EthHttpClient *client, const QByteArray &request, QByteArray &response, bool async)
+{
+    if(!async)
+        return client->requestingResponse(request, response);
+
+    bool finished = false;
+    bool ret = false;
+    client->postRequest(request, [&finished, &ret, &response](bool success, const QByteArray& data) {
+        ret = success;
+        response = QByteArray(data.constData(), data.size());
+        finished = true;
+    });
+    QElapsedTimer timer;
+    timer.start();
+    while(!finished && timer.elapsed() < WAIT_MSECS)
+        QTest::qWait(1);
+    return finished && ret;
+}
+
+QTEST_GUILESS_MAIN(TestEthHttpClient)
+
+#include "tst_ethhttpclient.moc"
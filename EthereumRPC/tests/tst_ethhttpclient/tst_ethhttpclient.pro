@@ -0,0 +1,5 @@
+include(../tests.pri)
+
+TARGET = tst_ethhttpclient
+
+SOURCES += tst_ethhttpclient.cpp
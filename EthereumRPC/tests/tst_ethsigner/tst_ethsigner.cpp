@@ -0,0 +1,94 @@
+#include <QtTest>
+#include "ethsigner.h"
+
+namespace TestEthSigner_NS
+{
+    //The example of EIP-155
+    const char PRIVATE_KEY[] = "4646464646464646464646464646464646464646464646464646464646464646";
+    const char ADDRESS[] = "9d8a62f656a8d1615c1294fd71e9cfb3e4855a4f";
+    const char SIGNED_TRANSACTION[] =
+            "f86c098504a817c800825208943535353535353535353535353535353535353535880de0b6b3a76400008025"
+            "a028ef61340bd939bc2195fe537567866003e1a15d3c71ff63e1590620aa636276"
+            "a067cbe9d8997f761aecb703304b3800ccf555c9f3dc64214b297fb1966a3b6d83";
+    const char TRANSACTION_HASH[] = "33469b22e9f636356c4160a87eb19df52b7412e8eac32a4a55ffe88ea8350788";
+    const int64_t CHAIN_ID = 1;
+}
+using namespace TestEthSigner_NS;
+
+class TestEthSigner : public QObject
+{
+    Q_OBJECT
+private slots:
+    void initTestCase();
+
+    void address();
+    void eip155Example();
+    void signBatch();
+    void rejectInvalid();
+
+private:
+    //nonce 9, gas price 20 gwei, gas 21000, to 0x3535...35, 1 ether, no data
+    static ETransaction exampleTransaction();
+
+    EthSigner m_signer;
+};
+
+void TestEthSigner::initTestCase()
+{
+    QVERIFY(m_signer.setPrivateKey(QByteArray::fromHex(PRIVATE_KEY)));
+}
+
+void TestEthSigner::address()
+{
+    QCOMPARE(m_signer.address().toHex(), QByteArray(ADDRESS));
+}
+
+void TestEthSigner::eip155Example()
+{
+    QByteArray signedData;
+    QByteArray hash;
+    QVERIFY(m_signer.signTransaction(exampleTransaction(), CHAIN_ID, signedData, &hash));
+    QCOMPARE(signedData.toHex(), QByteArray(SIGNED_TRANSACTION));
+    QCOMPARE(hash.toHex(), QByteArray(TRANSACTION_HASH));
+}
+
+void TestEthSigner::signBatch()
+{
+    //The hashes computed together give the same signatures
+    QVector<ETransaction> transactions(5, exampleTransaction());
+    QVector<QByteArray> signedData;
+    QVERIFY(m_signer.signTransactions(transactions, CHAIN_ID, signedData));
+    QCOMPARE(signedData.count(), transactions.count());
+    for(int i = 0; i < signedData.count(); i++)
+    {
+        QCOMPARE(signedData[i].toHex(), QByteArray(SIGNED_TRANSACTION));
+    }
+}
+
+void TestEthSigner::rejectInvalid()
+{
+    EthSigner signer;
+    QByteArray signedData;
+    //No key, the zero key and a key larger than the order of the curve
+    QVERIFY(!signer.signTransaction(exampleTransaction(), CHAIN_ID, signedData));
+    QVERIFY(!signer.setPrivateKey(QByteArray(32, '\0')));
+    QVERIFY(!signer.setPrivateKey(QByteArray(32, '\xff')));
+    QVERIFY(!signer.setPrivateKey(QByteArray(31, '\x46')));
+    QVERIFY(signer.address().isEmpty());
+    QVERIFY(!m_signer.signTransaction(exampleTransaction(), 0, signedData));
+}
+
+ETransaction TestEthSigner::exampleTransaction()
+{
+    ETransaction transaction;
+    transaction.nonce = EInt(9);
+    transaction.gasPrice = EInt(20000000000LL);
+    transaction.gas = EInt(21000);
+    transaction.to = EAddress20(QByteArray(20, '\x35'));
+    transaction.value = EUInt256(uint64_t(1000000000000000000ULL));
+    return transaction;
+}
+
+QTEST_GUILESS_MAIN(TestEthSigner)
+
+#include "tst_ethsigner.moc"
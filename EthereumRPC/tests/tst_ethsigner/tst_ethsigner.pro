@@ -0,0 +1,5 @@
+include(../tests.pri)
+
+TARGET = tst_ethsigner
+
+SOURCES += tst_ethsigner.cpp
@@ -0,0 +1,187 @@
+#include <QtTest>
+#include "ethwebsocketclient.h"
+#include "mockwebsocketserver.h"
+
+namespace TestEthWebSocketClient_NS
+{
+    const int TIMEOUT_MSECS = 2000;
+    //The posted requests are always answered or failed within the timeout of the client
+    const int WAIT_MSECS = 3 * TIMEOUT_MSECS;
+}
+using namespace TestEthWebSocketClient_NS;
+
+class TestEthWebSocketClient : public QObject
+{
+    Q_OBJECT
+private slots:
+    void init();
+    void cleanup();
+
+    void outOfOrderResponses();
+    void outOfOrderBlockingWaits();
+    void fragmentedMessages_data();
+    void fragmentedMessages();
+    void notificationsDuringBlockingWait();
+    void serverClose_data();
+    void serverClose();
+
+private:
+    EthWebSocketClient* newClient();
+    //Send the request blocking, or post it and wait for its handler from the event loop
+    bool exchange(IEthClient* client, const QByteArray& request, QByteArray& response, bool async);
+
+    MockWebSocketServer* m_server;
+};
+
+void TestEthWebSocketClient::init()
+{
+    m_server = new MockWebSocketServer();
+    QVERIFY(m_server->start());
+}
+
+void TestEthWebSocketClient::cleanup()
+{
+    delete m_server;
+    m_server = 0;
+}
+
+void TestEthWebSocketClient::outOfOrderResponses()
+{
+    const int count = 16;
+    QVector<QByteArray> responses(count);
+    int answered = 0;
+    m_server->holdResponses(count);
+    QScopedPointer<EthWebSocketClient> client(newClient());
+    QVERIFY(client->connectToServer());
+
+    for(int i = 0; i < count; i++)
+    {
+        QVERIFY(client->postRequest(MockServer::request("eth_gasPrice", i + 1),
+                                    [&responses, &answered, i](bool success, const QByteArray& response) {
+            if(success)
+                responses[i] = QByteArray(response.constData(), response.size());
+            answered++;
+        }));
+    }
+    //The server answer once every request is in flight, in the reverse order
+    QTRY_COMPARE_WITH_TIMEOUT(answered, count, WAIT_MSECS);
+    for(int i = 0; i < count; i++)
+    {
+        QCOMPARE(responses[i], MockServer::response(i + 1));
+    }
+}
+
+void TestEthWebSocketClient::outOfOrderBlockingWaits()
+{
+    const int count = 4;
+    m_server->holdResponses(count);
+    QScopedPointer<EthWebSocketClient> client(newClient());
+    QVERIFY(client->connectToServer());
+
+    for(int id = 1; id <= count; id++)
+    {
+        QVERIFY(client->sendRequest(MockServer::request("eth_gasPrice", id), id));
+    }
+    //The first wait receive every response, the next waits find theirs already received
+    for(int id = 1; id <= count; id++)
+    {
+        QByteArray response;
+        QVERIFY(client->waitForResponse(id, response));
+        QCOMPARE(response, MockServer::response(id));
+    }
+}
+
+void TestEthWebSocketClient::fragmentedMessages_data()
+{
+    QTest::addColumn<bool>("async");
+    QTest::newRow("blocking") << false;
+    QTest::newRow("posted") << true;
+}
+
+void TestEthWebSocketClient::fragmentedMessages()
+{
+    QFETCH(bool, async);
+    m_server->setFragmented(true);
+    QScopedPointer<EthWebSocketClient> client(newClient());
+    QVERIFY(client->connectToServer());
+
+    for(int id = 1; id <= 3; id++)
+    {
+        QByteArray response;
+        QVERIFY(exchange(client.data(), MockServer::request("eth_gasPrice", id), response, async));
+        QCOMPARE(response, MockServer::response(id));
+    }
+    //The ping between the fragments of every response is answered, the unsolicited pong is ignored
+    QTRY_COMPARE(m_server->pongCount(), 3);
+}
+
+void TestEthWebSocketClient::notificationsDuringBlockingWait()
+{
+    QList<QByteArray> notifications;
+    m_server->setNotifying(true);
+    QScopedPointer<EthWebSocketClient> client(newClient());
+    QVERIFY(client->connectToServer());
+    client->setNotificationHandler([&notifications](const QByteArray& notification) {
+        notifications.append(QByteArray(notification.constData(), notification.size()));
+    });
+
+    QByteArray response;
+    QVERIFY(client->requestingResponse(MockServer::request("eth_gasPrice", 1), response));
+    QCOMPARE(response, MockServer::response(1));
+    //The notification received during the blocking call is delivered later from the event loop
+    QCOMPARE(notifications.size(), 0);
+    QTRY_COMPARE(notifications.size(), 1);
+    QCOMPARE(notifications[0], MockWebSocketServer::notification());
+}
+
+void TestEthWebSocketClient::serverClose_data()
+{
+    fragmentedMessages_data();
+}
+
+void TestEthWebSocketClient::serverClose()
+{
+    QFETCH(bool, async);
+    QScopedPointer<EthWebSocketClient> client(newClient());
+    QVERIFY(client->connectToServer());
+
+    //The request in flight fail when the server close the connection
+    m_server->closeOnRequest();
+    QByteArray response;
+    QVERIFY(!exchange(client.data(), MockServer::request("eth_gasPrice", 1), response, async));
+    QVERIFY(!client->sendRequest(MockServer::request("eth_gasPrice", 2), 2));
+
+    QVERIFY(client->connectToServer());
+    QVERIFY(exchange(client.data(), MockServer::request("eth_gasPrice", 3), response, async));
+    QCOMPARE(response, MockServer::response(3));
+}
+
+EthWebSocketClient *TestEthWebSocketClient::newClient()
+{
+    EthWebSocketClient* client = new EthWebSocketClient(QString("ws://127.0.0.1:%1").arg(m_server->port()));
+    client->clientParameters()["timeout"] = TIMEOUT_MSECS;
+    return client;
+}
+
+bool TestEthWebSocketClient::exchange(IEthClient *client, const QByteArray &request, QByteArray &response, bool async)
+{
+    if(!async)
+        return client->requestingResponse(request, response);
+
+    bool finished = false;
+    bool ret = false;
+    client->postRequest(request, [&finished, &ret, &response](bool success, const QByteArray& data) {
+        ret = success;
+        response = QByteArray(data.constData(), data.size());
+        finished = true;
+    });
+    QElapsedTimer timer;
+    timer.start();
+    while(!finished && timer.elapsed() < WAIT_MSECS)
+        QTest::qWait(1);
+    return finished && ret;
+}
+
+QTEST_GUILESS_MAIN(TestEthWebSocketClient)
+
+#include "tst_ethwebsocketclient.moc"
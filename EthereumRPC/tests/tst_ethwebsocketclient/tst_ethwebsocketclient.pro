@@ -0,0 +1,5 @@
+include(../tests.pri)
+
+TARGET = tst_ethwebsocketclient
+
+SOURCES += tst_ethwebsocketclient.cpp
@@ -0,0 +1,182 @@
+#include <QtTest>
+#include "hexcodec.h"
+
+namespace TestHexCodec_NS
+{
+    //Every tail length after the vector blocks of the kernels
+    const int MAX_SIZE = 100;
+    //Bytes of the benchmarks, the size of a contract bytecode
+    const int SPEED_SIZE = 24576;
+    const char UNSUPPORTED[] = "The kernel is not supported by the build or the CPU";
+}
+using namespace TestHexCodec_NS;
+
+Q_DECLARE_METATYPE(HexKernel)
+
+class TestHexCodec : public QObject
+{
+    Q_OBJECT
+private slots:
+    void initTestCase();
+    void cleanup();
+
+    void encode_data();
+    void encode();
+    void decode_data();
+    void decode();
+    void rejectInvalid_data();
+    void rejectInvalid();
+    void encodeSpeed_data();
+    void encodeSpeed();
+    void decodeSpeed_data();
+    void decodeSpeed();
+
+private:
+    //One row per kernel, the kernels not supported by the build or the CPU are skipped
+    static void addKernelRows();
+    static QByteArray randomData(int size);
+
+    HexKernel m_default;
+};
+
+void TestHexCodec::initTestCase()
+{
+    m_default = hexKernel();
+}
+
+void TestHexCodec::cleanup()
+{
+    hexSetKernel(m_default);
+}
+
+void TestHexCodec::encode_data()
+{
+    addKernelRows();
+}
+
+void TestHexCodec::encode()
+{
+    QFETCH(HexKernel, kernel);
+    if(!hexSetKernel(kernel))
+        QSKIP(UNSUPPORTED);
+    for(int size = 0; size <= MAX_SIZE; size++)
+    {
+        QByteArray data = randomData(size);
+        QByteArray hex(2 * size, '\0');
+        hexEncode(reinterpret_cast<const unsigned char*>(data.constData()), size, hex.data());
+        QCOMPARE(hex, data.toHex());
+    }
+}
+
+void TestHexCodec::decode_data()
+{
+    addKernelRows();
+}
+
+void TestHexCodec::decode()
+{
+    QFETCH(HexKernel, kernel);
+    if(!hexSetKernel(kernel))
+        QSKIP(UNSUPPORTED);
+    for(int size = 0; size <= MAX_SIZE; size++)
+    {
+        QByteArray data = randomData(size);
+        //Both cases of the letters
+        QByteArray hex = data.toHex();
+        for(int i = 0; i < hex.size(); i += 3)
+            hex[i] = QChar(hex[i]).toUpper().toLatin1();
+        QByteArray out(size, '\0');
+        QVERIFY(hexValidate(hex.constData(), hex.size()));
+        QVERIFY(hexDecode(hex.constData(), hex.size(), reinterpret_cast<unsigned char*>(out.data())));
+        QCOMPARE(out, QByteArray::fromHex(hex));
+    }
+    QVERIFY(!hexDecode("abc", 3, 0));
+}
+
+void TestHexCodec::rejectInvalid_data()
+{
+    addKernelRows();
+}
+
+void TestHexCodec::rejectInvalid()
+{
+    QFETCH(HexKernel, kernel);
+    if(!hexSetKernel(kernel))
+        QSKIP(UNSUPPORTED);
+    //The characters around the ranges of the digits and the letters, at every position of the blocks and the tail
+    const char invalid[] = { '/', ':', '@', 'G', '`', 'g', ' ', '\0', char(0x80), char(0xB0), char(0xE1) };
+    QByteArray hex = randomData(MAX_SIZE).toHex();
+    QByteArray out(MAX_SIZE, '\0');
+    for(int i = 0; i < hex.size(); i++)
+    {
+        for(uint j = 0; j < sizeof(invalid); j++)
+        {
+            QByteArray wrong = hex;
+            wrong[i] = invalid[j];
+            QVERIFY2(!hexValidate(wrong.constData(), wrong.size()), qPrintable(QString("position %1").arg(i)));
+            QVERIFY2(!hexDecode(wrong.constData(), wrong.size(), reinterpret_cast<unsigned char*>(out.data())),
+                     qPrintable(QString("position %1").arg(i)));
+        }
+    }
+}
+
+void TestHexCodec::encodeSpeed_data()
+{
+    addKernelRows();
+}
+
+void TestHexCodec::encodeSpeed()
+{
+    QFETCH(HexKernel, kernel);
+    if(!hexSetKernel(kernel))
+        QSKIP(UNSUPPORTED);
+    QByteArray data = randomData(SPEED_SIZE);
+    QByteArray hex(2 * SPEED_SIZE, '\0');
+    QBENCHMARK
+    {
+        hexEncode(reinterpret_cast<const unsigned char*>(data.constData()), data.size(), hex.data());
+    }
+    QCOMPARE(hex, data.toHex());
+}
+
+void TestHexCodec::decodeSpeed_data()
+{
+    addKernelRows();
+}
+
+void TestHexCodec::decodeSpeed()
+{
+    QFETCH(HexKernel, kernel);
+    if(!hexSetKernel(kernel))
+        QSKIP(UNSUPPORTED);
+    QByteArray data = randomData(SPEED_SIZE);
+    QByteArray hex = data.toHex();
+    QByteArray out(SPEED_SIZE, '\0');
+    bool ret = false;
+    QBENCHMARK
+    {
+        ret = hexDecode(hex.constData(), hex.size(), reinterpret_cast<unsigned char*>(out.data()));
+    }
+    QVERIFY(ret);
+    QCOMPARE(out, data);
+}
+
+void TestHexCodec::addKernelRows()
+{
+    QTest::addColumn<HexKernel>("kernel");
+    QTest::newRow("scalar") << HexKernelScalar;
+    QTest::newRow("SSE2") << HexKernelSSE2;
+    QTest::newRow("AVX2") << HexKernelAVX2;
+}
+
+QByteArray TestHexCodec::randomData(int size)
+{
+    QByteArray data(size, '\0');
+    for(int i = 0; i < size; i++)
+        data[i] = char(qrand() & 0xFF);
+    return data;
+}
+
+QTEST_GUILESS_MAIN(TestHexCodec)
+
+#include "tst_hexcodec.moc"
@@ -0,0 +1,5 @@
+include(../tests.pri)
+
+TARGET = tst_hexcodec
+
+SOURCES += tst_hexcodec.cpp
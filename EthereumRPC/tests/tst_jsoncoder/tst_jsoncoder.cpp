@@ -0,0 +1,238 @@
+#include <QtTest>
+#include "jsoncoder.h"
+
+namespace TestJsonCoder_NS
+{
+    //Transactions of the block fixture, the size of a busy mainnet block
+    const int TRANSACTION_COUNT = 200;
+    const int64_t RESPONSE_ID = 7;
+}
+using namespace TestJsonCoder_NS;
+
+class TestJsonCoder : public QObject
+{
+    Q_OBJECT
+private slots:
+    void initTestCase();
+
+    void decodeBlock();
+    void decodeBlockSpeed_data();
+    void decodeBlockSpeed();
+    void encodeRequest_data();
+    void encodeRequest();
+    void encodeRequestSpeed_data();
+    void encodeRequestSpeed();
+
+private:
+    //Response of eth_getBlockByNumber with the full transaction objects
+    static QByteArray blockResponse(int transactions);
+    //Calls of the encoding cases, from no parameter to a filter object
+    static QList<QPair<QString, QVariant> > requests();
+    static QString hexData(int size, int seed);
+    //The path of the decoder before the pull reader, through QJsonDocument and QVariantMap
+    static bool decodeThroughVariant(const QByteArray& response, int64_t id, EValue& result);
+
+    QByteArray m_response;
+};
+
+void TestJsonCoder::initTestCase()
+{
+    m_response = blockResponse(TRANSACTION_COUNT);
+}
+
+void TestJsonCoder::decodeBlock()
+{
+    EBlock block;
+    EBlock expected;
+    QVERIFY(decodeJsonRPC(m_response, RESPONSE_ID, block));
+    QVERIFY(decodeThroughVariant(m_response, RESPONSE_ID, expected));
+    QCOMPARE(qint64(block.number), qint64(0x10d4f));
+    QVERIFY(block.transactions.isFull());
+    QCOMPARE(block.transactions.count(), TRANSACTION_COUNT);
+    QCOMPARE(block.toRawData(), expected.toRawData());
+
+    //The response of another call is not decoded
+    QVERIFY(!decodeJsonRPC(m_response, RESPONSE_ID + 1, block));
+    QVERIFY(block.isNull());
+}
+
+void TestJsonCoder::decodeBlockSpeed_data()
+{
+    QTest::addColumn<bool>("variant");
+    QTest::newRow("QJsonDocument") << true;
+    QTest::newRow("JsonReader") << false;
+}
+
+void TestJsonCoder::decodeBlockSpeed()
+{
+    QFETCH(bool, variant);
+    bool ret = false;
+    QBENCHMARK
+    {
+        EBlock block;
+        ret = variant ? decodeThroughVariant(m_response, RESPONSE_ID, block) : decodeJsonRPC(m_response, RESPONSE_ID, block);
+    }
+    QVERIFY(ret);
+}
+
+void TestJsonCoder::encodeRequest_data()
+{
+    QTest::addColumn<QString>("method");
+    QTest::addColumn<QVariant>("params");
+    QList<QPair<QString, QVariant> > calls = requests();
+    for(int i = 0; i < calls.count(); i++)
+    {
+        QTest::newRow(calls[i].first.toLatin1().constData()) << calls[i].first << calls[i].second;
+    }
+}
+
+void TestJsonCoder::encodeRequest()
+{
+    QFETCH(QString, method);
+    QFETCH(QVariant, params);
+    JsonRPCMethod rpcMethod(method.toLatin1().constData());
+    int64_t id = 0;
+    int64_t expectedId = 0;
+    QByteArray request;
+    encodeJsonRPC(rpcMethod, params, id, request);
+    QByteArray expected = encodeJsonRPC(method, params, expectedId);
+
+    //The same request but for the id
+    QJsonObject object = QJsonDocument::fromJson(request).object();
+    QJsonObject expectedObject = QJsonDocument::fromJson(expected).object();
+    QCOMPARE(qint64(object.take("id").toDouble()), qint64(id));
+    QCOMPARE(qint64(expectedObject.take("id").toDouble()), qint64(expectedId));
+    QCOMPARE(object, expectedObject);
+}
+
+void TestJsonCoder::encodeRequestSpeed_data()
+{
+    QTest::addColumn<QString>("method");
+    QTest::addColumn<QVariant>("params");
+    QTest::addColumn<bool>("variant");
+    QList<QPair<QString, QVariant> > calls = requests();
+    for(int i = 0; i < calls.count(); i++)
+    {
+        QTest::newRow(QString("%1 QJsonDocument").arg(calls[i].first).toLatin1().constData())
+                << calls[i].first << calls[i].second << true;
+        QTest::newRow(QString("%1 JsonRPCMethod").arg(calls[i].first).toLatin1().constData())
+                << calls[i].first << calls[i].second << false;
+    }
+}
+
+void TestJsonCoder::encodeRequestSpeed()
+{
+    QFETCH(QString, method);
+    QFETCH(QVariant, params);
+    QFETCH(bool, variant);
+    JsonRPCMethod rpcMethod(method.toLatin1().constData());
+    int64_t id = 0;
+    //The buffer is reused like the request buffer of EthRPC
+    QByteArray request;
+    QBENCHMARK
+    {
+        if(variant)
+            request = encodeJsonRPC(method, params, id);
+        else
+            encodeJsonRPC(rpcMethod, params, id, request);
+    }
+    QVERIFY(!request.isEmpty());
+}
+
+QList<QPair<QString, QVariant> > TestJsonCoder::requests()
+{
+    QVariantList balance;
+    balance << hexData(20, 1) << "latest";
+    QVariantMap call;
+    call["from"] = hexData(20, 2);
+    call["to"] = hexData(20, 3);
+    call["data"] = hexData(68, 4);
+    QVariantList callParams;
+    callParams << call << "0x10d4f";
+    QVariantMap filter;
+    filter["fromBlock"] = "0x10d00";
+    filter["toBlock"] = "0x10d4f";
+    filter["address"] = QVariantList() << hexData(20, 5) << hexData(20, 6);
+    filter["topics"] = QVariantList() << hexData(32, 7) << QVariant() << hexData(32, 8);
+
+    QList<QPair<QString, QVariant> > calls;
+    calls << qMakePair(QString("eth_blockNumber"), QVariant(QVariantList()));
+    calls << qMakePair(QString("eth_getBalance"), QVariant(balance));
+    calls << qMakePair(QString("eth_call"), QVariant(callParams));
+    calls << qMakePair(QString("eth_getLogs"), QVariant(QVariantList() << filter));
+    return calls;
+}
+
+QByteArray TestJsonCoder::blockResponse(int transactions)
+{
+    const QString blockHash = hexData(32, 1);
+    QVariantList list;
+    for(int i = 0; i < transactions; i++)
+    {
+        QVariantMap transaction;
+        transaction["blockHash"] = blockHash;
+        transaction["blockNumber"] = "0x10d4f";
+        transaction["from"] = hexData(20, 100 + i);
+        transaction["gas"] = "0x5208";
+        transaction["gasPrice"] = "0x4a817c800";
+        transaction["hash"] = hexData(32, 1000 + i);
+        //Contract calls with a selector and two words
+        transaction["input"] = hexData(68, 2000 + i);
+        transaction["nonce"] = QString("0x%1").arg(i, 0, 16);
+        transaction["to"] = hexData(20, 3000 + i);
+        transaction["transactionIndex"] = QString("0x%1").arg(i, 0, 16);
+        transaction["value"] = "0xde0b6b3a7640000";
+        transaction["v"] = "0x25";
+        transaction["r"] = hexData(32, 4000 + i);
+        transaction["s"] = hexData(32, 5000 + i);
+        list.append(transaction);
+    }
+
+    QVariantMap block;
+    block["number"] = "0x10d4f";
+    block["hash"] = blockHash;
+    block["parentHash"] = hexData(32, 2);
+    block["nonce"] = hexData(8, 3);
+    block["sha3Uncles"] = hexData(32, 4);
+    block["logsBloom"] = hexData(256, 5);
+    block["transactionsRoot"] = hexData(32, 6);
+    block["stateRoot"] = hexData(32, 7);
+    block["receiptsRoot"] = hexData(32, 8);
+    block["miner"] = hexData(20, 9);
+    block["difficulty"] = "0x4ea3f27bc";
+    block["totalDifficulty"] = "0x78ed983323d";
+    block["extraData"] = hexData(32, 10);
+    block["size"] = "0x2a5b4";
+    block["gasLimit"] = "0x1c9c380";
+    block["gasUsed"] = "0x1c8e2a1";
+    block["timestamp"] = "0x55ba467c";
+    block["transactions"] = list;
+    block["uncles"] = QVariantList();
+
+    QVariantMap response;
+    response["jsonrpc"] = "2.0";
+    response["id"] = qint64(RESPONSE_ID);
+    response["result"] = block;
+    return QJsonDocument(QJsonObject::fromVariantMap(response)).toJson(QJsonDocument::Compact);
+}
+
+QString TestJsonCoder::hexData(int size, int seed)
+{
+    QByteArray data(size, '\0');
+    for(int i = 0; i < size; i++)
+        data[i] = char((seed * 31 + i * 17) & 0xFF);
+    return "0x" + QString::fromLatin1(data.toHex());
+}
+
+bool TestJsonCoder::decodeThroughVariant(const QByteArray &response, int64_t id, EValue &result)
+{
+    QVariant variant;
+    if(!decodeJsonRPC(response, id, variant))
+        return false;
+    result.fromRawData(variant);
+    return true;
+}
+
+QTEST_GUILESS_MAIN(TestJsonCoder)
+
+#include "tst_jsoncoder.moc"
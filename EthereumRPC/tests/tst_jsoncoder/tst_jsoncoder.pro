@@ -0,0 +1,5 @@
+include(../tests.pri)
+
+TARGET = tst_jsoncoder
+
+SOURCES += tst_jsoncoder.cpp
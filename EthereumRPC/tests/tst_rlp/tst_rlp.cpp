@@ -0,0 +1,272 @@
+#include <QtTest>
+#include "rlp.h"
+#include "keccak.h"
+
+namespace TestRLP_NS
+{
+    //Longest payload encoded in the prefix byte
+    const int SHORT_LENGTH = 55;
+}
+using namespace TestRLP_NS;
+
+class TestRLP : public QObject
+{
+    Q_OBJECT
+private slots:
+    void encodeVectors_data();
+    void encodeVectors();
+    void roundTrip();
+    void longListPrefix_data();
+    void longListPrefix();
+    void rejectNonCanonical_data();
+    void rejectNonCanonical();
+    void rejectNonCanonicalIntegers();
+    void eip155SigningData();
+
+private:
+    //List of strings of the byte 0x80, every item is encoded in 2 bytes
+    static QByteArray listOfPayload(int payloadSize);
+};
+
+void TestRLP::encodeVectors_data()
+{
+    QTest::addColumn<int>("item");
+    QTest::addColumn<QByteArray>("expected");
+
+    //The examples of the RLP specification, the item is built by the switch of the test
+    QTest::newRow("dog") << 0 << QByteArray::fromHex("83646f67");
+    QTest::newRow("cat dog") << 1 << QByteArray::fromHex("c88363617483646f67");
+    QTest::newRow("empty string") << 2 << QByteArray::fromHex("80");
+    QTest::newRow("empty list") << 3 << QByteArray::fromHex("c0");
+    QTest::newRow("zero") << 4 << QByteArray::fromHex("80");
+    QTest::newRow("byte 0x00") << 5 << QByteArray::fromHex("00");
+    QTest::newRow("fifteen") << 6 << QByteArray::fromHex("0f");
+    QTest::newRow("1024") << 7 << QByteArray::fromHex("820400");
+    QTest::newRow("set theoretic three") << 8 << QByteArray::fromHex("c7c0c1c0c3c0c1c0");
+    QTest::newRow("56 bytes string") << 9 << QByteArray("\xb8\x38Lorem ipsum dolor sit amet, consectetur adipisicing elit");
+    QTest::newRow("2^256-1") << 10 << QByteArray::fromHex("a0" + QByteArray(64, 'f'));
+}
+
+void TestRLP::encodeVectors()
+{
+    QFETCH(int, item);
+    QFETCH(QByteArray, expected);
+    RLPEncoder encoder;
+    switch(item)
+    {
+    case 0:
+        encoder.addBytes("dog");
+        break;
+    case 1:
+        encoder.beginList();
+        encoder.addBytes("cat");
+        encoder.addBytes("dog");
+        encoder.endList();
+        break;
+    case 2:
+        encoder.addBytes(QByteArray());
+        break;
+    case 3:
+        encoder.beginList();
+        encoder.endList();
+        break;
+    case 4:
+        encoder.addUInt(uint64_t(0));
+        break;
+    case 5:
+        encoder.addBytes(QByteArray(1, '\0'));
+        break;
+    case 6:
+        encoder.addUInt(uint64_t(15));
+        break;
+    case 7:
+        encoder.addUInt(uint64_t(1024));
+        break;
+    case 8:
+        //[ [], [[]], [ [], [[]] ] ]
+        encoder.beginList();
+        encoder.beginList();
+        encoder.endList();
+        encoder.beginList();
+        encoder.beginList();
+        encoder.endList();
+        encoder.endList();
+        encoder.beginList();
+        encoder.beginList();
+        encoder.endList();
+        encoder.beginList();
+        encoder.beginList();
+        encoder.endList();
+        encoder.endList();
+        encoder.endList();
+        encoder.endList();
+        break;
+    case 9:
+        encoder.addBytes("Lorem ipsum dolor sit amet, consectetur adipisicing elit");
+        break;
+    case 10:
+        encoder.addUInt(UInt256() - UInt256(1));
+        break;
+    }
+    QCOMPARE(encoder.data().toHex(), expected.toHex());
+    RLPItem decoded(encoder.data());
+    QVERIFY(decoded.isValid());
+    QCOMPARE(decoded.encodedSize(), expected.size());
+}
+
+void TestRLP::roundTrip()
+{
+    //Strings of every size around the short and long forms, and integers of every byte size
+    RLPEncoder encoder;
+    encoder.beginList();
+    for(int size = 0; size <= 70; size++)
+    {
+        QByteArray data(size, char(0x80 + size));
+        encoder.addBytes(data);
+    }
+    for(int shift = 0; shift < 64; shift += 7)
+    {
+        encoder.addUInt(uint64_t(1) << shift);
+    }
+    UInt256 large;
+    large.setLimb(3, 0x0123456789abcdefULL);
+    encoder.addUInt(large);
+    encoder.endList();
+
+    RLPItem list(encoder.data());
+    QVERIFY(list.isValid());
+    QVERIFY(list.isList());
+    QCOMPARE(list.encodedSize(), encoder.data().size());
+    QVector<RLPItem> items;
+    QVERIFY(list.items(items));
+    QCOMPARE(items.count(), 71 + 10 + 1);
+    for(int size = 0; size <= 70; size++)
+    {
+        QVERIFY(!items[size].isList());
+        QCOMPARE(items[size].toByteArray(), QByteArray(size, char(0x80 + size)));
+    }
+    for(int i = 0; i < 10; i++)
+    {
+        uint64_t value = 0;
+        QVERIFY(items[71 + i].toUInt(value));
+        QCOMPARE(quint64(value), quint64(uint64_t(1) << (i * 7)));
+    }
+    UInt256 value;
+    QVERIFY(items[81].toUInt256(value));
+    QVERIFY(value == large);
+}
+
+void TestRLP::longListPrefix_data()
+{
+    QTest::addColumn<int>("payloadSize");
+    QTest::addColumn<QByteArray>("prefix");
+    QTest::newRow("54 bytes") << 54 << QByteArray::fromHex("f6");
+    QTest::newRow("56 bytes") << 56 << QByteArray::fromHex("f838");
+    QTest::newRow("254 bytes") << 254 << QByteArray::fromHex("f8fe");
+    QTest::newRow("256 bytes") << 256 << QByteArray::fromHex("f90100");
+    QTest::newRow("65536 bytes") << 65536 << QByteArray::fromHex("fa010000");
+}
+
+void TestRLP::longListPrefix()
+{
+    QFETCH(int, payloadSize);
+    QFETCH(QByteArray, prefix);
+    QByteArray data = listOfPayload(payloadSize);
+    QCOMPARE(data.left(prefix.size()).toHex(), prefix.toHex());
+    QCOMPARE(data.size(), prefix.size() + payloadSize);
+
+    RLPItem list(data);
+    QVERIFY(list.isValid());
+    QVERIFY(list.isList());
+    QCOMPARE(list.payloadSize(), payloadSize);
+    QCOMPARE(list.encodedSize(), data.size());
+    QVector<RLPItem> items;
+    QVERIFY(list.items(items));
+    QCOMPARE(items.count(), payloadSize / 2);
+
+    //A truncated list is not valid
+    QVERIFY(!RLPItem(data.left(data.size() - 1)).isValid());
+}
+
+void TestRLP::rejectNonCanonical_data()
+{
+    QTest::addColumn<QByteArray>("data");
+    QByteArray short55(SHORT_LENGTH, 'a');
+    QTest::newRow("single byte as string") << QByteArray::fromHex("8100");
+    QTest::newRow("single byte 0x7f as string") << QByteArray::fromHex("817f");
+    QTest::newRow("long string of 55 bytes") << QByteArray::fromHex("b837") + short55;
+    QTest::newRow("long list of 55 bytes") << QByteArray::fromHex("f837") + short55;
+    QTest::newRow("leading zero in the length") << QByteArray::fromHex("b90038") + QByteArray(56, 'a');
+    QTest::newRow("length of 5 bytes") << QByteArray::fromHex("bc0000000038") + QByteArray(56, 'a');
+    QTest::newRow("truncated string") << QByteArray::fromHex("83646f");
+    QTest::newRow("truncated length") << QByteArray::fromHex("b9");
+    QTest::newRow("empty") << QByteArray();
+}
+
+void TestRLP::rejectNonCanonical()
+{
+    QFETCH(QByteArray, data);
+    QVERIFY(!RLPItem(data).isValid());
+
+    //The invalid item is rejected inside a list too
+    QByteArray list = QByteArray(1, char(0xc0 + data.size())) + data;
+    if(!data.isEmpty() && data.size() <= SHORT_LENGTH)
+    {
+        QVector<RLPItem> items;
+        QVERIFY(RLPItem(list).isValid());
+        QVERIFY(!RLPItem(list).items(items));
+    }
+}
+
+void TestRLP::rejectNonCanonicalIntegers()
+{
+    uint64_t value = 0;
+    UInt256 large;
+    //Leading zero
+    QVERIFY(!RLPItem(QByteArray::fromHex("820001")).toUInt(value));
+    QVERIFY(!RLPItem(QByteArray::fromHex("820001")).toUInt256(large));
+    //Larger than the output
+    QVERIFY(!RLPItem(QByteArray::fromHex("89010000000000000000")).toUInt(value));
+    QVERIFY(!RLPItem(QByteArray::fromHex("a101" + QByteArray(64, '0'))).toUInt256(large));
+    //A list is not an integer
+    QVERIFY(!RLPItem(QByteArray::fromHex("c0")).toUInt(value));
+    QVERIFY(RLPItem(QByteArray::fromHex("80")).toUInt(value));
+    QCOMPARE(quint64(value), quint64(0));
+}
+
+void TestRLP::eip155SigningData()
+{
+    //The example of EIP-155: nonce 9, gas price 20 gwei, gas 21000, 1 ether, chain id 1
+    RLPEncoder encoder;
+    encoder.beginList();
+    encoder.addUInt(uint64_t(9));
+    encoder.addUInt(uint64_t(20000000000ULL));
+    encoder.addUInt(uint64_t(21000));
+    encoder.addBytes(QByteArray(20, '\x35'));
+    encoder.addUInt(UInt256(1000000000000000000ULL));
+    encoder.addBytes(QByteArray());
+    encoder.addUInt(uint64_t(1));
+    encoder.addUInt(uint64_t(0));
+    encoder.addUInt(uint64_t(0));
+    encoder.endList();
+    QCOMPARE(encoder.data().toHex(),
+             QByteArray("ec098504a817c800825208943535353535353535353535353535353535353535880de0b6b3a764000080018080"));
+
+    QByteArray hash(Keccak256::HashSize, '\0');
+    Keccak256::hash(encoder.data().constData(), encoder.data().size(), reinterpret_cast<unsigned char*>(hash.data()));
+    QCOMPARE(hash.toHex(), QByteArray("daf5a779ae972f972197303d7b574746c7ef83eadac0f2791ad23db92e4c8e53"));
+}
+
+QByteArray TestRLP::listOfPayload(int payloadSize)
+{
+    RLPEncoder encoder;
+    encoder.beginList();
+    for(int i = 0; i < payloadSize / 2; i++)
+        encoder.addBytes(QByteArray(1, char(0x80)));
+    encoder.endList();
+    return encoder.data();
+}
+
+QTEST_GUILESS_MAIN(TestRLP)
+
+#include "tst_rlp.moc"
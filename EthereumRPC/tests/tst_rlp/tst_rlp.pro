@@ -0,0 +1,5 @@
+include(../tests.pri)
+
+TARGET = tst_rlp
+
+SOURCES += tst_rlp.cpp
@@ -0,0 +1,195 @@
+#include <QtTest>
+#include "uint256.h"
+
+namespace TestUInt256_NS
+{
+    const char MAX_HEX[] = "ffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffff";
+}
+using namespace TestUInt256_NS;
+
+class TestUInt256 : public QObject
+{
+    Q_OBJECT
+private slots:
+    void carry();
+    void borrow();
+    void wrap();
+    void multiply();
+    void divideLargeDivisor();
+    void divideRoundTrip();
+    void hexRoundTrip_data();
+    void hexRoundTrip();
+    void rejectHex_data();
+    void rejectHex();
+
+private:
+    static UInt256 fromHex(const QByteArray& hex);
+    //Hex with the 0x prefix, like the JSON quantities
+    static QByteArray toHex(const UInt256& value);
+    static UInt256 maximum();
+};
+
+void TestUInt256::carry()
+{
+    //The carry crosses every limb
+    UInt256 value = fromHex("0xffffffffffffffffffffffffffffffffffffffffffffffff");
+    value += UInt256(1);
+    QCOMPARE(toHex(value), QByteArray("0x1000000000000000000000000000000000000000000000000"));
+    QCOMPARE(quint64(value.limb(3)), quint64(1));
+
+    //Carry into a limb that is all ones
+    UInt256 halves = fromHex("0xffffffffffffffff0000000000000000ffffffffffffffff");
+    halves += fromHex("0x1");
+    QCOMPARE(toHex(halves), QByteArray("0xffffffffffffffff00000000000000010000000000000000"));
+    halves = fromHex("0xffffffffffffffff");
+    halves += fromHex("0xffffffffffffffff");
+    QCOMPARE(toHex(halves), QByteArray("0x1fffffffffffffffe"));
+}
+
+void TestUInt256::borrow()
+{
+    UInt256 value = fromHex("0x1000000000000000000000000000000000000000000000000");
+    value -= UInt256(1);
+    QCOMPARE(toHex(value), QByteArray("0xffffffffffffffffffffffffffffffffffffffffffffffff"));
+
+    //Borrow with a subtrahend limb equal to the minuend limb
+    UInt256 equal = fromHex("0x10000000000000000ffffffffffffffff");
+    equal -= fromHex("0xffffffffffffffff") + UInt256(1);
+    QCOMPARE(toHex(equal), QByteArray("0xffffffffffffffffffffffffffffffff"));
+}
+
+void TestUInt256::wrap()
+{
+    //The arithmetic is modulo 2^256
+    QCOMPARE(toHex(maximum()), QByteArray("0x") + MAX_HEX);
+    QVERIFY((maximum() + UInt256(1)).isZero());
+    QVERIFY(UInt256() - UInt256(1) == maximum());
+    QVERIFY(maximum() + maximum() == maximum() - UInt256(1));
+    QVERIFY((UInt256(1) << 256).isZero());
+    QVERIFY((maximum() << 255) == (UInt256(1) << 255));
+    QCOMPARE(maximum().bits(), 256);
+}
+
+void TestUInt256::multiply()
+{
+    QVERIFY(maximum() * maximum() == UInt256(1));
+    QVERIFY(((UInt256(1) << 128) * (UInt256(1) << 128)).isZero());
+    QVERIFY((UInt256(1) << 127) * (UInt256(1) << 128) == (UInt256(1) << 255));
+    //The partial products carry into the next limbs
+    UInt256 value = fromHex("0xffffffffffffffff");
+    QCOMPARE(toHex(value * value), QByteArray("0xfffffffffffffffe0000000000000001"));
+}
+
+void TestUInt256::divideLargeDivisor()
+{
+    //Divisor of 256 bits
+    UInt256 divisor = (UInt256(1) << 255) + UInt256(1);
+    UInt256 quotient;
+    UInt256 remainder;
+    UInt256::divide(maximum(), divisor, quotient, remainder);
+    QVERIFY(quotient == UInt256(1));
+    QVERIFY(remainder == (UInt256(1) << 255) - UInt256(2));
+
+    //Divisor larger than the dividend
+    UInt256::divide(divisor - UInt256(1), divisor, quotient, remainder);
+    QVERIFY(quotient.isZero());
+    QVERIFY(remainder == divisor - UInt256(1));
+
+    //Divisor of 196 bits
+    UInt256 large = fromHex("0x8000000000000000000000000000000000000000000000001");
+    UInt256::divide(maximum(), large, quotient, remainder);
+    QVERIFY(quotient * large + remainder == maximum());
+    QVERIFY(remainder < large);
+    QCOMPARE(toHex(quotient), QByteArray("0x1fffffffffffffff"));
+
+    //The division by zero give zero
+    UInt256::divide(maximum(), UInt256(), quotient, remainder);
+    QVERIFY(quotient.isZero());
+    QVERIFY(remainder.isZero());
+}
+
+void TestUInt256::divideRoundTrip()
+{
+    UInt256 a = fromHex("0x1234567890abcdef1234567890abcdef");
+    UInt256 b = fromHex("0xfedcba0987654321fedcba09");
+    UInt256 c = fromHex("0x123456789");
+    UInt256 product = a * b + c;
+    QVERIFY(product / b == a);
+    QVERIFY(product % b == c);
+    QVERIFY(product / a == b);
+}
+
+void TestUInt256::hexRoundTrip_data()
+{
+    QTest::addColumn<QByteArray>("hex");
+    QTest::addColumn<QByteArray>("expected");
+    QTest::newRow("zero") << QByteArray("0x0") << QByteArray("0x0");
+    QTest::newRow("one") << QByteArray("0x1") << QByteArray("0x1");
+    QTest::newRow("one limb") << QByteArray("0xffffffffffffffff") << QByteArray("0xffffffffffffffff");
+    QTest::newRow("limb boundary") << QByteArray("0x10000000000000000") << QByteArray("0x10000000000000000");
+    QTest::newRow("maximum") << QByteArray("0x") + MAX_HEX << QByteArray("0x") + MAX_HEX;
+    QTest::newRow("upper case") << QByteArray("0XDE0B6B3A7640000") << QByteArray("0xde0b6b3a7640000");
+    QTest::newRow("without prefix") << QByteArray("de0b6b3a7640000") << QByteArray("0xde0b6b3a7640000");
+    QTest::newRow("leading zeros") << QByteArray("0x00000001") << QByteArray("0x1");
+    QTest::newRow("leading zeros beyond 64 digits") << QByteArray("0x0000") + MAX_HEX << QByteArray("0x") + MAX_HEX;
+}
+
+void TestUInt256::hexRoundTrip()
+{
+    QFETCH(QByteArray, hex);
+    QFETCH(QByteArray, expected);
+    UInt256 value;
+    QVERIFY(value.fromHex(hex.constData(), hex.size()));
+    QCOMPARE(toHex(value), expected);
+    UInt256 back;
+    QVERIFY(back.fromHex(expected.constData(), expected.size()));
+    QVERIFY(back == value);
+
+    //The big endian bytes give the same value
+    unsigned char bytes[32];
+    value.toBigEndian(bytes);
+    back.fromBigEndian(bytes);
+    QVERIFY(back == value);
+}
+
+void TestUInt256::rejectHex_data()
+{
+    QTest::addColumn<QByteArray>("hex");
+    QTest::newRow("empty") << QByteArray();
+    QTest::newRow("prefix only") << QByteArray("0x");
+    QTest::newRow("invalid digit") << QByteArray("0x12g4");
+    QTest::newRow("sign") << QByteArray("-0x1");
+    QTest::newRow("257 bits") << QByteArray("0x1") + MAX_HEX;
+}
+
+void TestUInt256::rejectHex()
+{
+    QFETCH(QByteArray, hex);
+    UInt256 value(42);
+    QVERIFY(!value.fromHex(hex.constData(), hex.size()));
+    QVERIFY(value == UInt256(42));
+}
+
+UInt256 TestUInt256::fromHex(const QByteArray &hex)
+{
+    UInt256 value;
+    if(!value.fromHex(hex.constData(), hex.size()))
+        qWarning("Invalid hex %s", hex.constData());
+    return value;
+}
+
+QByteArray TestUInt256::toHex(const UInt256 &value)
+{
+    char buffer[UInt256::HEX_DIGITS];
+    int size = value.toHex(buffer);
+    return QByteArray("0x") + QByteArray(buffer, size);
+}
+
+UInt256 TestUInt256::maximum()
+{
+    return UInt256() - UInt256(1);
+}
+
+QTEST_GUILESS_MAIN(TestUInt256)
+
+#include "tst_uint256.moc"
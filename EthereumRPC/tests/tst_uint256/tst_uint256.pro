@@ -0,0 +1,5 @@
+include(../tests.pri)
+
+TARGET = tst_uint256
+
+SOURCES += tst_uint256.cpp
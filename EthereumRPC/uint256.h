@@ -0,0 +1,340 @@
+#ifndef UINT256_H
+#define UINT256_H
+#include <stdint.h>
+#include <string.h>
+#include "hexcodec.h"
+
+//Unsigned 256 bits integer with inline storage, the arithmetic wraps modulo 2^256
+class UInt256
+{
+public:
+    //Size of the hex string without prefix of the largest value
+    static const int HEX_DIGITS = 64;
+
+    inline UInt256()
+    {
+        m_limbs[0] = m_limbs[1] = m_limbs[2] = m_limbs[3] = 0;
+    }
+
+    inline UInt256(uint64_t value)
+    {
+        m_limbs[0] = value;
+        m_limbs[1] = m_limbs[2] = m_limbs[3] = 0;
+    }
+
+    //The limbs are little endian, limb 0 hold the lowest 64 bits
+    inline uint64_t limb(int index) const { return m_limbs[index]; }
+    inline void setLimb(int index, uint64_t value) { m_limbs[index] = value; }
+
+    inline bool isZero() const
+    {
+        return (m_limbs[0] | m_limbs[1] | m_limbs[2] | m_limbs[3]) == 0;
+    }
+
+    //true when the value fit in 64 bits
+    inline bool fitsUInt64() const
+    {
+        return (m_limbs[1] | m_limbs[2] | m_limbs[3]) == 0;
+    }
+
+    inline uint64_t toUInt64() const { return m_limbs[0]; }
+
+    inline double toDouble() const
+    {
+        const double limbScale = 18446744073709551616.0;
+        return ((double(m_limbs[3]) * limbScale + double(m_limbs[2])) * limbScale +
+                double(m_limbs[1])) * limbScale + double(m_limbs[0]);
+    }
+
+    //Number of significant bits
+    inline int bits() const
+    {
+        for(int i = 3; i >= 0; i--)
+        {
+            if(m_limbs[i])
+            {
+                int bits = 64;
+                uint64_t limb = m_limbs[i];
+                while(!(limb & (uint64_t(1) << 63)))
+                {
+                    limb <<= 1;
+                    bits--;
+                }
+                return i * 64 + bits;
+            }
+        }
+        return 0;
+    }
+
+    //Parse hex digits with optional 0x prefix, false when invalid or larger than 256 bits
+    inline bool fromHex(const char* data, int size)
+    {
+        if(size >= 2 && data[0] == '0' && (data[1] == 'x' || data[1] == 'X'))
+        {
+            data += 2;
+            size -= 2;
+        }
+        if(size <= 0)
+            return false;
+        while(size > HEX_DIGITS && *data == '0')
+        {
+            data++;
+            size--;
+        }
+        if(size > HEX_DIGITS)
+            return false;
+
+        uint64_t limbs[4] = {0, 0, 0, 0};
+        //Fill the limbs from the lowest digits, 16 digits for each limb
+        const char* end = data + size;
+        for(int i = 0; i < 4 && end > data; i++)
+        {
+            const char* begin = end - 16 > data ? end - 16 : data;
+            uint64_t limb = 0;
+            for(const char* p = begin; p < end; p++)
+            {
+                int digit = hexDigitValue(*p);
+                if(digit < 0)
+                    return false;
+                limb = (limb << 4) | uint64_t(digit);
+            }
+            limbs[i] = limb;
+            end = begin;
+        }
+        memcpy(m_limbs, limbs, sizeof(m_limbs));
+        return true;
+    }
+
+    //Write the hex digits without prefix and leading zeros, return the number of digits written
+    //The buffer must have HEX_DIGITS bytes
+    inline int toHex(char* buffer) const
+    {
+        static const char hexDigits[] = "0123456789abcdef";
+        int top = 3;
+        while(top > 0 && !m_limbs[top])
+            top--;
+
+        int size = 0;
+        uint64_t limb = m_limbs[top];
+        int shift = 60;
+        while(shift > 0 && !((limb >> shift) & 0xF))
+            shift -= 4;
+        for(; shift >= 0; shift -= 4)
+            buffer[size++] = hexDigits[(limb >> shift) & 0xF];
+        for(int i = top - 1; i >= 0; i--)
+        {
+            limb = m_limbs[i];
+            for(shift = 60; shift >= 0; shift -= 4)
+                buffer[size++] = hexDigits[(limb >> shift) & 0xF];
+        }
+        return size;
+    }
+
+    //Write the 32 bytes big endian representation
+    inline void toBigEndian(unsigned char* buffer) const
+    {
+        for(int i = 0; i < 4; i++)
+        {
+            uint64_t limb = m_limbs[3 - i];
+            for(int j = 0; j < 8; j++)
+                buffer[i * 8 + j] = (unsigned char)(limb >> (56 - j * 8));
+        }
+    }
+
+    inline void fromBigEndian(const unsigned char* buffer)
+    {
+        for(int i = 0; i < 4; i++)
+        {
+            uint64_t limb = 0;
+            for(int j = 0; j < 8; j++)
+                limb = (limb << 8) | buffer[i * 8 + j];
+            m_limbs[3 - i] = limb;
+        }
+    }
+
+    inline bool operator==(const UInt256& other) const
+    {
+        return m_limbs[0] == other.m_limbs[0] && m_limbs[1] == other.m_limbs[1] &&
+                m_limbs[2] == other.m_limbs[2] && m_limbs[3] == other.m_limbs[3];
+    }
+    inline bool operator!=(const UInt256& other) const { return !(*this == other); }
+
+    inline bool operator<(const UInt256& other) const
+    {
+        for(int i = 3; i >= 0; i--)
+        {
+            if(m_limbs[i] != other.m_limbs[i])
+                return m_limbs[i] < other.m_limbs[i];
+        }
+        return false;
+    }
+    inline bool operator>(const UInt256& other) const { return other < *this; }
+    inline bool operator<=(const UInt256& other) const { return !(other < *this); }
+    inline bool operator>=(const UInt256& other) const { return !(*this < other); }
+
+    inline UInt256& operator+=(const UInt256& other)
+    {
+        uint64_t carry = 0;
+        for(int i = 0; i < 4; i++)
+        {
+            uint64_t sum = m_limbs[i] + carry;
+            carry = sum < carry;
+            m_limbs[i] = sum + other.m_limbs[i];
+            carry += m_limbs[i] < sum;
+        }
+        return *this;
+    }
+
+    inline UInt256& operator-=(const UInt256& other)
+    {
+        uint64_t borrow = 0;
+        for(int i = 0; i < 4; i++)
+        {
+            uint64_t value = m_limbs[i];
+            uint64_t difference = value - other.m_limbs[i] - borrow;
+            borrow = (value < other.m_limbs[i]) || (value - other.m_limbs[i] < borrow);
+            m_limbs[i] = difference;
+        }
+        return *this;
+    }
+
+    inline UInt256& operator*=(const UInt256& other)
+    {
+        uint64_t result[4] = {0, 0, 0, 0};
+        for(int i = 0; i < 4; i++)
+        {
+            uint64_t carry = 0;
+            for(int j = 0; i + j < 4; j++)
+            {
+                uint64_t high = 0;
+                uint64_t low = multiply(m_limbs[i], other.m_limbs[j], high);
+                low += carry;
+                high += low < carry;
+                result[i + j] += low;
+                high += result[i + j] < low;
+                carry = high;
+            }
+        }
+        memcpy(m_limbs, result, sizeof(m_limbs));
+        return *this;
+    }
+
+    inline UInt256& operator/=(const UInt256& other)
+    {
+        UInt256 remainder;
+        divide(*this, other, *this, remainder);
+        return *this;
+    }
+
+    inline UInt256& operator%=(const UInt256& other)
+    {
+        UInt256 quotient;
+        divide(*this, other, quotient, *this);
+        return *this;
+    }
+
+    inline UInt256& operator<<=(int shift)
+    {
+        if(shift >= 256)
+            return *this = UInt256();
+        int limbShift = shift / 64;
+        int bitShift = shift % 64;
+        for(int i = 3; i >= 0; i--)
+        {
+            uint64_t value = 0;
+            if(i - limbShift >= 0)
+            {
+                value = m_limbs[i - limbShift] << bitShift;
+                if(bitShift && i - limbShift - 1 >= 0)
+                    value |= m_limbs[i - limbShift - 1] >> (64 - bitShift);
+            }
+            m_limbs[i] = value;
+        }
+        return *this;
+    }
+
+    inline UInt256& operator>>=(int shift)
+    {
+        if(shift >= 256)
+            return *this = UInt256();
+        int limbShift = shift / 64;
+        int bitShift = shift % 64;
+        for(int i = 0; i < 4; i++)
+        {
+            uint64_t value = 0;
+            if(i + limbShift < 4)
+            {
+                value = m_limbs[i + limbShift] >> bitShift;
+                if(bitShift && i + limbShift + 1 < 4)
+                    value |= m_limbs[i + limbShift + 1] << (64 - bitShift);
+            }
+            m_limbs[i] = value;
+        }
+        return *this;
+    }
+
+    inline UInt256 operator+(const UInt256& other) const { UInt256 r = *this; return r += other; }
+    inline UInt256 operator-(const UInt256& other) const { UInt256 r = *this; return r -= other; }
+    inline UInt256 operator*(const UInt256& other) const { UInt256 r = *this; return r *= other; }
+    inline UInt256 operator/(const UInt256& other) const { UInt256 r = *this; return r /= other; }
+    inline UInt256 operator%(const UInt256& other) const { UInt256 r = *this; return r %= other; }
+    inline UInt256 operator<<(int shift) const { UInt256 r = *this; return r <<= shift; }
+    inline UInt256 operator>>(int shift) const { UInt256 r = *this; return r >>= shift; }
+
+    //Quotient and remainder, the division by zero give zero
+    static inline void divide(const UInt256& dividend, const UInt256& divisor, UInt256& quotient, UInt256& remainder)
+    {
+        UInt256 q;
+        UInt256 r;
+        if(divisor.isZero())
+        {
+            quotient = q;
+            remainder = r;
+            return;
+        }
+        if(divisor > dividend)
+        {
+            remainder = dividend;
+            quotient = q;
+            return;
+        }
+
+        for(int i = dividend.bits() - 1; i >= 0; i--)
+        {
+            r <<= 1;
+            r.m_limbs[0] |= (dividend.m_limbs[i / 64] >> (i % 64)) & 1;
+            if(r >= divisor)
+            {
+                r -= divisor;
+                q.m_limbs[i / 64] |= uint64_t(1) << (i % 64);
+            }
+        }
+        quotient = q;
+        remainder = r;
+    }
+
+private:
+    //Full 64 x 64 bits product, return the low part
+    static inline uint64_t multiply(uint64_t a, uint64_t b, uint64_t& high)
+    {
+#if defined(__SIZEOF_INT128__)
+        unsigned __int128 product = (unsigned __int128)a * b;
+        high = uint64_t(product >> 64);
+        return uint64_t(product);
+#else
+        uint64_t aLow = a & 0xFFFFFFFF, aHigh = a >> 32;
+        uint64_t bLow = b & 0xFFFFFFFF, bHigh = b >> 32;
+        uint64_t lowLow = aLow * bLow;
+        uint64_t highLow = aHigh * bLow;
+        uint64_t lowHigh = aLow * bHigh;
+        uint64_t highHigh = aHigh * bHigh;
+        uint64_t middle = (lowLow >> 32) + (highLow & 0xFFFFFFFF) + lowHigh;
+        high = highHigh + (highLow >> 32) + (middle >> 32);
+        return (middle << 32) | (lowLow & 0xFFFFFFFF);
+#endif
+    }
+
+    uint64_t m_limbs[4];
+};
+
+#endif // UINT256_H